@@ -0,0 +1,62 @@
+<?php
+
+/**
+ * Example: Drawing a chart with CairoContext
+ *
+ * The draw signal delivers a CairoContext. Besides the usual cairo path calls,
+ * it accepts batched command lists, so a whole series costs one PHP call:
+ *
+ *   $cr->draw_polyline(array $points [, bool $close = false])
+ *   $cr->fill_rects(array $rects)
+ *   $cr->stroke_rects(array $rects)
+ *
+ * Points are [[x, y], ...] or a flat [x0, y0, x1, y1, ...] list,
+ * rectangles are [[x, y, width, height], ...] or a flat list.
+ */
+Gtk::init();
+
+$window = new GtkWindow();
+$window->set_title('Cairo Chart Example');
+$window->set_default_size(800, 400);
+$window->connect('destroy', function () {
+    Gtk::main_quit();
+});
+
+$drawing_area = new GtkDrawingArea();
+$window->add($drawing_area);
+
+// 100k samples of a noisy sine
+$samples = [];
+for ($i = 0; $i < 100000; $i++) {
+    $samples[] = sin($i / 2000) + (mt_rand() / mt_getrandmax() - 0.5) * 0.1;
+}
+
+$drawing_area->connect('draw', function ($widget, $cr) use ($samples) {
+    $width = $widget->get_allocated_width();
+    $height = $widget->get_allocated_height();
+
+    // Background bars
+    $cr->set_source_rgb(0.93, 0.93, 0.96);
+    $bars = [];
+    for ($x = 0; $x < $width; $x += 40) {
+        $bars[] = [$x, 0, 20, $height];
+    }
+    $cr->fill_rects($bars);
+
+    // Series, as a flat list
+    $points = [];
+    $step = $width / count($samples);
+    foreach ($samples as $i => $value) {
+        $points[] = $i * $step;
+        $points[] = $height / 2 - $value * $height / 3;
+    }
+
+    $cr->set_source_rgb(0.2, 0.4, 0.8);
+    $cr->set_line_width(1);
+    $cr->draw_polyline($points);
+
+    return false;
+});
+
+$window->show_all();
+Gtk::main();
@@ -10,10 +10,10 @@
  * paint images onto widgets that support Cairo drawing.
  *
  * Function signature:
- * Gdk::cairo_set_source_pixbuf(GdkEvent $cairo_context, GdkPixbuf $pixbuf, int|float $x, int|float $y)
+ * Gdk::cairo_set_source_pixbuf(CairoContext $cairo_context, GdkPixbuf $pixbuf, int|float $x, int|float $y)
  *
  * Parameters:
- *   $cairo_context - The Cairo context (passed as GdkEvent from draw signal due to G_TYPE_BOXED handling)
+ *   $cairo_context - The Cairo context (passed as CairoContext from the draw signal)
  *   $pixbuf        - The GdkPixbuf to use as source
  *   $x             - X coordinate to place the pixbuf
  *   $y             - Y coordinate to place the pixbuf
@@ -49,8 +49,7 @@ $pixbuf = GdkPixbuf::new_from_file($icon_file);
 
 // Connect to draw signal
 $drawing_area->connect('draw', function ($widget, $cairo_context) use ($pixbuf) {
-    // The cairo context is passed as a GdkEvent object from the draw signal
-    // (This is due to how G_TYPE_BOXED types are handled in the callback system)
+    // The cairo context is passed as a CairoContext object from the draw signal
 
     // Set the pixbuf as the source for the cairo context at position (50, 50)
     Gdk::cairo_set_source_pixbuf($cairo_context, $pixbuf, 50, 50);
@@ -0,0 +1,46 @@
+<?php
+
+/**
+ * Accessor benchmark
+ *
+ * Times trivial getters and setters, run it before and after replacing a class by the output of
+ * run.php to compare the ns/call
+ *
+ * Usage: php -d extension=php-gtk3.so bench.php [iterations]
+ */
+
+Gtk::init();
+
+$iterations = isset($argv[1]) ? (int)$argv[1] : 1000000;
+
+$app = new GtkApplication("org.phpgtk.bench", 0);
+$window = new GtkWindow();
+$label = new GtkLabel("bench");
+
+$cases = [
+	"GtkApplication::prefers_app_menu" => function() use ($app) { $app->prefers_app_menu(); },
+	"GtkApplication::get_active_window" => function() use ($app) { $app->get_active_window(); },
+	"GtkApplication::is_inhibited" => function() use ($app) { $app->is_inhibited(1); },
+	"GtkWindow::set_title" => function() use ($window) { $window->set_title("bench"); },
+	"GtkWindow::get_title" => function() use ($window) { $window->get_title(); },
+	"GtkLabel::set_text" => function() use ($label) { $label->set_text("bench"); },
+	"GtkLabel::get_text" => function() use ($label) { $label->get_text(); },
+];
+
+// Cost of the loop and the closure call, subtracted from every case
+$empty = function() {};
+$start = hrtime(TRUE);
+for($i = 0; $i < $iterations; $i++) {
+	$empty();
+}
+$overhead = (hrtime(TRUE) - $start) / $iterations;
+
+foreach($cases as $name => $case) {
+	$start = hrtime(TRUE);
+	for($i = 0; $i < $iterations; $i++) {
+		$case();
+	}
+	$elapsed = (hrtime(TRUE) - $start) / $iterations;
+
+	printf("%-36s %8.1f ns/call\n", $name, max(0, $elapsed - $overhead));
+}
@@ -1,5 +1,25 @@
 <?php
 
+/**
+ * Binding generator
+ *
+ * Reads the C prototypes of defs.txt and writes, for each class, a header, a source file and the
+ * main.cpp registration into out/. The generated methods are the typed fast path:
+ *
+ *  - every argument is declared with Php::ByVal for reflection, and still checked by the stub:
+ *    release builds of PHP do not enforce the arginfo of internal functions
+ *  - arguments are read with the inline readers of src/G/PhpParam.h, picked per C type here, so
+ *    the check and the conversion are fixed at compile time instead of switching on the expected
+ *    type at runtime like phpgtk_check_parameter
+ *  - strings are views into the zend_string instead of a std::string copy, so simple getters and
+ *    setters do not touch the heap
+ *  - method and argument names are literals, interned once by the engine at registration
+ *
+ * Prototypes using a type the generator does not know get a "not implemented" stub to finish
+ * by hand, like the rest of the bindings
+ *
+ * Usage: php run.php [defs file] [output directory]
+ */
 
 /**
  * Helper for strings
@@ -13,11 +33,11 @@ class Strings
 
 	/**
 	 * sprintf by name
-	 * 
+	 *
 	 * %(name)s - string no marcador name
 	 * %(age)02d - integer 02 no marcador age
 	 */
-	static public function vsprintf_named($format, $args) 
+	static public function vsprintf_named($format, $args)
 	{
 		$names = preg_match_all('/%\((.*?)\)/', $format, $matches, PREG_SET_ORDER);
 
@@ -61,68 +81,210 @@ class PhpConvert
 	 */
 	static public function getCleanType($type, $removePointer=TRUE)
 	{
-		$type = str_replace("const", "", $type);
+		$type = preg_replace('/\bconst\b/', "", $type);
 		if($removePointer) {
 			$type = str_replace("*", "", $type);
 		}
-		$type = rtrim(ltrim($type));
+		$type = str_replace(" ", "", $type);
 
 		return $type;
 	}
 
 	/**
-	 * Converte the param of function, to work with php extensio
+	 * Split "const gchar* name" in type and name
+	 */
+	static public function splitParam($param)
+	{
+		$param = rtrim(ltrim($param));
+		preg_match('/^(.*?)([a-zA-Z_][a-zA-Z0-9_]*)$/', $param, $matches);
+
+		return [
+			'type' => \PhpConvert::getCleanType($matches[1], FALSE),
+			'name' => $matches[2],
+			'const' => (bool)preg_match('/\bconst\b/', $param),
+		];
+	}
+
+	/**
+	 * Converte the param of function, to work with php extension
+	 *
+	 * Returns the unpack code, the PHP-CPP argument declaration and the C expression, or NULL
+	 * when the type has no fast path
 	 */
 	static public function parseParam($count, $param)
 	{
-		global $existing_constants;
+		global $existing_classes, $existing_constants;
 
-		// Remove constant key
-		$clean_param = \PhpConvert::getCleanType($param, FALSE);
-		$tmp = explode(" ", $clean_param);
-		$type = $tmp[0];
-		$name = $tmp[1];
-		
-		$template_code = "";
+		$type = $param['type'];
+		$name = $param['name'];
 
 		// Verifica o tipo
 		switch($type) {
 
-			// String
+			// String, a view on the zend_string, no copy
 			case "gchar*":
-				$template_code .= "std::string c_%(param_name)s = parameters[%(param_count)s];\n";
-				$template_code .= "gchar *%(param_name)s = (gchar *)c_%(param_name)s.c_str();";
+			case "char*":
+				$template_code = "const gchar *%(param_name)s = phpgtk_param_string(parameters, %(param_position)s);";
+				$argument = "Php::ByVal(\"%(param_name)s\", Php::Type::String)";
 				break;
 
-			// Float
+			// Float, integers are accepted too
 			case "gfloat":
-				$template_code .= "double c_%(param_name)s = parameters[%(param_count)s];\n";
-				$template_code .= "gfloat %(param_name)s = (float)d_%(param_name)s;";
+			case "gdouble":
+				$template_code = "%(type)s %(param_name)s = phpgtk_param_float<%(type)s>(parameters, %(param_position)s);";
+				$argument = "Php::ByVal(\"%(param_name)s\", Php::Type::Float)";
 				break;
 
-			// Some simple casts
+			// Integers
 			case "guint":
 			case "gint":
+			case "gint64":
+			case "guint64":
+			case "gsize":
+			case "gssize":
+				$template_code = "%(type)s %(param_name)s = phpgtk_param_integer<%(type)s>(parameters, %(param_position)s);";
+				$argument = "Php::ByVal(\"%(param_name)s\", Php::Type::Numeric)";
+				break;
+
 			case "gboolean":
-				$template_code .= "%(type)s %(param_name)s = (%(type)s)parameters[%(param_count)s];";
+				$template_code = "gboolean %(param_name)s = phpgtk_param_boolean(parameters, %(param_position)s);";
+				$argument = "Php::ByVal(\"%(param_name)s\", Php::Type::Bool)";
 				break;
 
 			// Others
 			default:
+				$clean_type = \PhpConvert::getCleanType($type);
+
+				// Enums and flags
 				if(isset($existing_constants[$type])) {
-					$template_code .= "int c_%(param_name)s = (int)parameters[%(param_count)s];\n";
-					$template_code .= "%(type)s %(param_name)s = (%(type)s)c_%(param_name)s;";
+					$template_code = "%(type)s %(param_name)s = phpgtk_param_integer<%(type)s>(parameters, %(param_position)s);";
+					$argument = "Php::ByVal(\"%(param_name)s\", Php::Type::Numeric)";
 				}
 
+				// Wrapped objects, checked against the class before the cast
+				else if(isset($existing_classes[$clean_type]) && $type == $clean_type . "*") {
+					$template_code = "%(clean_type)s_ *phpgtk_%(param_name)s = phpgtk_param_object<%(clean_type)s_>(parameters, %(param_position)s, \"%(clean_type)s\");\n";
+					$template_code .= "%(declaration)s = %(cast)s(phpgtk_%(param_name)s->get_instance());";
+					$argument = "Php::ByVal(\"%(param_name)s\", \"%(clean_type)s\")";
+				}
+
+				else {
+					return NULL;
+				}
 		}
 
-		$result_code = \Strings::vsprintf_named($template_code, [
-			'param_count' => $count,
+		$args = [
+			'param_position' => $count + 1,
 			'param_name' => $name,
 			'type' => $type,
-		]);
+			'clean_type' => \PhpConvert::getCleanType($type),
+			'cast' => \PhpConvert::getCastMacro(\PhpConvert::getCleanType($type)),
+			'declaration' => \PhpConvert::getDeclaration($type, $name),
+		];
+
+		return [
+			'code' => \Strings::vsprintf_named($template_code, $args),
+			'argument' => \Strings::vsprintf_named($argument, $args),
+			'name' => $name,
+		];
+	}
+
+	/**
+	 * Converte the return of function, NULL when the type has no fast path
+	 */
+	static public function parseReturn($type, $is_const)
+	{
+		global $existing_classes, $existing_constants;
+
+		switch($type) {
+			case "void":
+				return ['decl' => "void", 'code' => ""];
+
+			case "gboolean":
+				return ['decl' => "Php::Value", 'code' => "return (bool)ret;"];
+
+			case "gint":
+			case "guint":
+			case "gint64":
+			case "guint64":
+			case "gsize":
+			case "gssize":
+				return ['decl' => "Php::Value", 'code' => "return (int64_t)ret;"];
+
+			case "gfloat":
+			case "gdouble":
+				return ['decl' => "Php::Value", 'code' => "return (double)ret;"];
+
+			// Borrowed strings go straight into the zval, owned ones are freed after the copy
+			case "gchar*":
+			case "char*":
+				$code = "if (ret == nullptr) {\n  return nullptr;\n}\n\n";
+				if($is_const) {
+					$code .= "return ret;";
+				}
+				else {
+					$code .= "Php::Value php_ret = ret;\ng_free(ret);\n\nreturn php_ret;";
+				}
+				return ['decl' => "Php::Value", 'code' => $code];
+
+			case "gchar**":
+				$code = "Php::Array ret_arr;\n";
+				$code .= "for (int i = 0; ret != nullptr && ret[i] != nullptr; i++) {\n  ret_arr[i] = ret[i];\n}\n";
+				if(!$is_const) {
+					$code .= "g_strfreev(ret);\n";
+				}
+				$code .= "\nreturn ret_arr;";
+				return ['decl' => "Php::Value", 'code' => $code];
+		}
+
+		if(isset($existing_constants[$type])) {
+			return ['decl' => "Php::Value", 'code' => "return (int)ret;"];
+		}
+
+		$clean_type = \PhpConvert::getCleanType($type);
+		if(isset($existing_classes[$clean_type]) && $type == $clean_type . "*") {
+			$code = "if (ret == nullptr) {\n  return nullptr;\n}\n\n";
+			$code .= "return cobject_to_phpobject((gpointer *)ret);";
+			return ['decl' => "Php::Value", 'code' => $code];
+		}
 
-		return $result_code;
+		return NULL;
+	}
+
+	/**
+	 * C declaration in the style of the bindings, "GtkWindow *window"
+	 */
+	static public function getDeclaration($type, $name)
+	{
+		preg_match('/^(.*?)(\**)$/', $type, $matches);
+		if($matches[2] == "") {
+			return $type . " " . $name;
+		}
+
+		return $matches[1] . " " . $matches[2] . $name;
+	}
+
+	/**
+	 * GTK_WINDOW for GtkWindow
+	 */
+	static public function getCastMacro($class_name)
+	{
+		return strtoupper(rtrim(\PhpConvert::convertClassToFunctionStyle($class_name), "_"));
+	}
+
+	/**
+	 * Indent every line of a block
+	 */
+	static public function indent($code, $spaces)
+	{
+		$lines = explode("\n", $code);
+		foreach($lines as &$line) {
+			if($line != "") {
+				$line = str_repeat(" ", $spaces) . $line;
+			}
+		}
+
+		return implode("\n", $lines);
 	}
 
 }
@@ -134,240 +296,255 @@ $existing_classes = [
 	"GtkApplicationWindow" => "GtkWindow",
 	"GtkApplication" => "GApplication",
 	"GtkWindow" => "GtkWidget",
+	"GtkWidget" => "GObject",
+	"GApplication" => "GObject",
+	"GMenuModel" => "GObject",
+	"GMenu" => "GMenuModel",
 ];
 
 $existing_constants = [
 	"GtkJustification" => TRUE,
+	"GApplicationFlags" => TRUE,
+	"GtkApplicationInhibitFlags" => TRUE,
 ];
 
-$def_functions = [];
 $def_classes = [];
 
 
 /**
  * Run application
  */
+$defs_file = isset($argv[1]) ? $argv[1] : __DIR__ . "/defs.txt";
+$out_dir = isset($argv[2]) ? $argv[2] : __DIR__ . "/out";
 
 // Read def file
-$defs = file_get_contents("defs.txt");
+$defs = file_get_contents($defs_file);
 
 // Parse functions from defs
-preg_match_all('/^([a-zA-Z\*]*)\ (.*)\ \((.*)\,{0,}\)/im', $defs, $parsed_defs);
+preg_match_all('/^([a-zA-Z\*\ ]*?)\s*([a-z_0-9]+)\s*\((.*)\)\s*;?\s*$/im', $defs, $parsed_defs);
 
 // Loop adjusting definitions
 foreach($parsed_defs[0] as $index => $def) {
-	
 
 	// Store defs
-	$function_return = $parsed_defs[1][$index];
+	$return_raw = $parsed_defs[1][$index];
 	$function_name = $parsed_defs[2][$index];
-	$params = $parsed_defs[3][$index];
-	
+
 	// Parse params
-	$params = explode(",", $params);
 	$function_params = [];
-	foreach($params as $param) {
-		$function_params[] = rtrim(ltrim($param));
+	foreach(explode(",", $parsed_defs[3][$index]) as $param) {
+		if(trim($param) != "" && trim($param) != "void") {
+			$function_params[] = \PhpConvert::splitParam($param);
+		}
 	}
 
-	// Get class name
-	$tmp = explode("_", $function_name);
-	$tmp = array_map("ucfirst", $tmp);
-
-	echo "-> " . $function_name . "\n";
+	// Get class name, the longest known prefix of the function
+	$tmp = array_map("ucfirst", explode("_", $function_name));
+	$class_name = NULL;
 	while(count($tmp)) {
-		$class_name = implode("", $tmp);
-		echo $class_name . "\n";
-		if(!isset($existing_classes[$class_name])) {
-			array_pop($tmp);
-		}
-		else {
+		if(isset($existing_classes[implode("", $tmp)])) {
+			$class_name = implode("", $tmp);
 			break;
 		}
+		array_pop($tmp);
 	}
-	echo "Found [" . $class_name . "]\n";
 
-	echo "----\n";
-
-	// Store all parsed
-	if(!isset($def_classes[$class_name])) {
-		$def_classes[$class_name] = [];
+	if($class_name === NULL) {
+		fwrite(STDERR, "skip " . $function_name . ": unknown class\n");
+		continue;
 	}
 
 	$def_classes[$class_name][] = [
 		'name' => $function_name,
-		'return' => $function_return,
+		'return' => \PhpConvert::getCleanType($return_raw, FALSE),
+		'return_const' => (bool)preg_match('/\bconst\b/', $return_raw),
 		'params' => $function_params,
 		'class' => $class_name
 	];
-
 }
 
-// Create the header file
+// Create the files
 foreach($def_classes as $class_name => $def_class) {
 
-	/**
-	 * Create header file
-	 */
-	$extra_includes = [];
-	$methods = [];
-
 	$tmp = \Strings::explodeCamelCase($class_name);
 	$namespace = $tmp[0];
+	$extends = $existing_classes[$class_name];
+	$cast = \PhpConvert::getCastMacro($class_name);
+	$var_name = strtolower($class_name);
 
-
-	$template_file = "
-#ifndef _PHPGTK_%(u_class_name)s_H_
-#define _PHPGTK_%(u_class_name)s_H_
-
-	#include <phpcpp.h>
-	#include <gtk/gtk.h>
-
-	%(extra_includes)s
-
-	class %(class_name)s_ : public %(extends)s_
-	{
-		/**
-		 * Publics
-		 */
-		public:
-
-			/**
-			 *  C++ constructor and destructor
-			 */
-			%(class_name)s_();
-			~%(class_name)s_();
-
-			%(methods)s
-
+	// Include the extends class
+	$tmp = \Strings::explodeCamelCase($extends);
+	if($tmp[0] == $namespace) {
+		$extra_include = "#include \"" . $extends . ".h\"";
+	}
+	else {
+		$extra_include = "#include \"../" . $tmp[0] . "/" . $extends . ".h\"";
 	}
 
-#endif
-";
-
+	$declarations = [];
+	$definitions = [];
+	$registrations = [];
 
+	// Get class holder. the start name of functions in C
+	$class_functions_holder = \PhpConvert::convertClassToFunctionStyle($class_name);
 
 	// Loop into functions
-	foreach($def_class as $function_name => $function) {
-
-		// Store php final infos
-		$def_classes[$class_name]['php'][$function_name] = [
-			'method_name' => "",
-			'return_type' => "void",
-			'params' => [],
-			'extra_includes' => [],
-		];
-
-		// Include the extends class as include
-		if(isset($existing_classes[$class_name])) {
-			$tmp = \Strings::explodeCamelCase($existing_classes[$class_name]);
-			if($tmp[0] == $namespace) {
-				$extra_include = "#include \"" . $existing_classes[$param_type] . ".h\"";
-			}
-			else {
-				$extra_include = "#include \"../" . $tmp[0] . "/" . $existing_classes[$class_name] . ".h\"";
-			}
-			$def_classes[$class_name]['php'][$function_name]['extra_includes'][$class_name] = $extra_include;
-		}
-
-		// Get class holder. the start name of functions in C
-		$class_functions_holder = \PhpConvert::convertClassToFunctionStyle($class_name);
+	foreach($def_class as $function) {
 
 		// Remove holder from c function, like gtk_application_add_window to add_window
-		$method_name = str_replace($class_functions_holder, "", $function['name']);
-
-		// Verify if it's construct
-		if($method_name == "new") {
-			$def_classes[$class_name]['php'][$function_name]['method_name'] = "__construct";
-			// if yes, return void
+		$method_name = substr($function['name'], strlen($class_functions_holder));
+		$is_construct = ($method_name == "new");
+		if($is_construct) {
+			$method_name = "__construct";
 		}
-		else {
-			// Parse return type
-			if($function['return'] != "void") {
-				$method_return = "Php::Value";
-			}
+
+		// Methods take the instance as first param
+		$params = $function['params'];
+		if(!$is_construct && count($params) && \PhpConvert::getCleanType($params[0]['type']) == $class_name) {
+			array_shift($params);
 		}
 
 		// Loop params
-		$count = 0;
-		foreach($function['params'] as $index => $param) {
-			$tmp = explode(" ", $param);
-			$param_type = \PhpConvert::getCleanType($tmp[0]);
-			$param_name = $tmp[1];
-
-			// Verify if the first param are the class
-			if($index == 0) {
-				if($param_type == $class_name) {
-					continue;
-				}
+		$unpacks = [];
+		$arguments = [];
+		$call_args = $is_construct ? [] : [$cast . "(instance)"];
+		$supported = TRUE;
+		foreach($params as $count => $param) {
+			$parsed = \PhpConvert::parseParam($count, $param);
+			if($parsed === NULL) {
+				$supported = FALSE;
+				break;
 			}
 
-			// Convert the function param to php
-			$def_classes[$class_name]['php'][$function_name]['params'][] = \PhpConvert::parseParam($count, $param);
-			
-			// Next param
-			$count++;
+			$unpacks[] = $parsed['code'];
+			$arguments[] = $parsed['argument'];
+			$call_args[] = $parsed['name'];
+		}
+
+		$return = $is_construct ? ['decl' => "void", 'code' => ""]
+		                        : \PhpConvert::parseReturn($function['return'], $function['return_const']);
+		if($return === NULL) {
+			$supported = FALSE;
+			$return = ['decl' => "Php::Value", 'code' => ""];
 		}
 
-		var_dump("\n\n" . implode("\n\n", $def_classes[$class_name]['php'][$function_name]['params']) . "\n\n");
-		die();
+		$method_param = count($params) ? "Php::Parameters &parameters" : "";
+		$declarations[] = $return['decl'] . " " . $method_name . "(" . $method_param . ");";
 
-		// Verify if there is param
-		if($count > 0) {
-			$method_param = "Php::Parameters &parameters";
+		// Method body
+		if(!$supported) {
+			$body = "throw Php::Exception(\"" . $class_name . "_::" . $method_name . " not implemented\");";
 		}
 		else {
-			$method_param = "";
+			$call = $function['name'] . "(" . implode(", ", $call_args) . ")";
+			$body = count($unpacks) ? implode("\n", $unpacks) . "\n\n" : "";
+
+			if($is_construct) {
+				$body .= "instance = (gpointer *)" . $call . ";";
+			}
+			else if($return['decl'] == "void") {
+				$body .= $call . ";";
+			}
+			else {
+				$ret_type = ($function['return_const'] ? "const " : "") . $function['return'];
+				$body .= \PhpConvert::getDeclaration($ret_type, "ret") . " = " . $call . ";\n\n" . $return['code'];
+			}
 		}
 
+		$definitions[] = $return['decl'] . " " . $class_name . "_::" . $method_name . "(" . $method_param . ") {\n"
+			. \PhpConvert::indent($body, 2) . "\n}";
 
+		// Registration with the argument info, for reflection and debug builds
+		$registration = "  " . $var_name . ".method<&" . $class_name . "_::" . $method_name . ">(\"" . $method_name . "\"";
+		if($supported && count($arguments)) {
+			$registration .= ", {\n      " . implode(",\n      ", $arguments) . "}";
+		}
+		$registrations[] = $registration . ");";
+	}
 
-		// 
-		$methods[] = $method_return . " " . $method_name . "(" . $method_param . ");";
+	$template_header = "
+#ifndef _PHPGTK_%(u_class_name)s_H_
+#define _PHPGTK_%(u_class_name)s_H_
 
-	}
+#include <phpcpp.h>
+#include <gtk/gtk.h>
 
-	// Include the extends class
-	$tmp = \Strings::explodeCamelCase($existing_classes[$class_name]);
-	if($tmp[0] == $namespace) {
-		$extra_includes[$existing_classes[$param_type]] = "#include \"" . $existing_classes[$class_name] . ".h\"";
-	}
-	else {
-		$extra_includes[$existing_classes[$param_type]] = "#include \"../" . $tmp[0] . "/" . $existing_classes[$class_name] . ".h\"";
-	}
-	
-	// Do the replacements
-	$header_file_content = \Strings::vsprintf_named($template_file, [
-		'class_name' => $class_name,
-		'u_class_name' => strtoupper($class_name),
-		'extends' => $existing_classes[$class_name],
-		'extra_includes' => implode("\n\t", $extra_includes),
-		'methods' => implode("\n\t\t\t", $methods),
-	]);
+%(extra_include)s
 
-	var_dump($header_file_content);
+/**
+ * %(class_name)s_
+ */
+class %(class_name)s_ : public %(extends)s_ {
+  /**
+   * Publics
+   */
+ public:
+  /**
+   *  C++ constructor and destructor
+   */
+  %(class_name)s_();
+  ~%(class_name)s_();
+
+%(methods)s
+};
 
+#endif
+";
 
-	/**
-	 * Create cpp file
-	 */
-	$methods = [];
-	$template_file = "
+	$template_cpp = "
 #include \"%(class_name)s.h\"
-#include \"../../main.h\"
+#include \"../../php-gtk.h\"
 
+/**
+ * Constructor
+ */
 %(class_name)s_::%(class_name)s_() = default;
+
+/**
+ * Destructor
+ */
 %(class_name)s_::~%(class_name)s_() = default;
 
+%(methods)s
 ";
 
-	
+	$template_registration = "
+  // %(class_name)s
+  Php::Class<%(class_name)s_> %(var_name)s(\"%(class_name)s\");
+  %(var_name)s.extends(%(extends_var)s);
+%(methods)s
+";
 
 	// Do the replacements
-	$cpp_file_content = \Strings::vsprintf_named($template_file, [
+	$header_file_content = \Strings::vsprintf_named($template_header, [
+		'class_name' => $class_name,
+		'u_class_name' => strtoupper($class_name),
+		'extends' => $extends,
+		'extra_include' => $extra_include,
+		'methods' => \PhpConvert::indent(implode("\n\n", $declarations), 2),
+	]);
+
+	$cpp_file_content = \Strings::vsprintf_named($template_cpp, [
+		'class_name' => $class_name,
+		'methods' => implode("\n\n", $definitions),
+	]);
+
+	$registration_content = \Strings::vsprintf_named($template_registration, [
 		'class_name' => $class_name,
-		'methods' => implode("\n\t\t\t", $methods),
+		'var_name' => $var_name,
+		'extends_var' => strtolower($extends),
+		'methods' => implode("\n", $registrations),
 	]);
 
-	var_dump($cpp_file_content);
-}
\ No newline at end of file
+	// Write the files
+	$class_dir = $out_dir . "/src/" . $namespace;
+	if(!is_dir($class_dir)) {
+		mkdir($class_dir, 0755, TRUE);
+	}
+
+	file_put_contents($class_dir . "/" . $class_name . ".h", $header_file_content);
+	file_put_contents($class_dir . "/" . $class_name . ".cpp", $cpp_file_content);
+	file_put_contents($out_dir . "/main.cpp.txt", $registration_content, FILE_APPEND);
+
+	echo $class_name . ": " . count($definitions) . " methods\n";
+}
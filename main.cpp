@@ -39,10 +39,13 @@ PHPCPP_EXPORT void *get_module() {
   gobject.method<&GObject_::is_connected>("is_connected");
   gobject.method<&GObject_::get_property>("get_property");
   gobject.method<&GObject_::set_property>("set_property");
+  gobject.method<&GObject_::get_properties>("get_properties");
+  gobject.method<&GObject_::set_properties>("set_properties");
   gobject.method<&GObject_::get_data>("get_data");
   gobject.method<&GObject_::set_data>("set_data");
   gobject.method<&GObject_::signal_handler_block>("signal_handler_block");
   gobject.method<&GObject_::signal_handler_unblock>("signal_handler_unblock");
+  gobject.method<&GObject_::debug_live_closures>("debug_live_closures");
   gobject.constant("TYPE_INVALID", (int)G_TYPE_INVALID);
   gobject.constant("TYPE_NONE", (int)G_TYPE_NONE);
   gobject.constant("TYPE_INTERFACE", (int)G_TYPE_INTERFACE);
@@ -248,15 +251,24 @@ PHPCPP_EXPORT void *get_module() {
   // GtkApplication
   Php::Class<GtkApplication_> gtkapplication("GtkApplication");
   gtkapplication.extends(gobject);
-  gtkapplication.method<&GtkApplication_::__construct>("__construct");
-  gtkapplication.method<&GtkApplication_::add_window>("add_window");
-  gtkapplication.method<&GtkApplication_::remove_window>("remove_window");
+  gtkapplication.method<&GtkApplication_::__construct>(
+      "__construct", {Php::ByVal("application_id", Php::Type::String),
+                      Php::ByVal("flags", Php::Type::Numeric)});
+  gtkapplication.method<&GtkApplication_::add_window>("add_window",
+                                                      {Php::ByVal("window", "GtkWindow")});
+  gtkapplication.method<&GtkApplication_::remove_window>("remove_window",
+                                                         {Php::ByVal("window", "GtkWindow")});
   gtkapplication.method<&GtkApplication_::get_windows>("get_windows");
-  gtkapplication.method<&GtkApplication_::get_window_by_id>("get_window_by_id");
+  gtkapplication.method<&GtkApplication_::get_window_by_id>(
+      "get_window_by_id", {Php::ByVal("id", Php::Type::Numeric)});
   gtkapplication.method<&GtkApplication_::get_active_window>("get_active_window");
-  gtkapplication.method<&GtkApplication_::inhibit>("inhibit");
-  gtkapplication.method<&GtkApplication_::uninhibit>("uninhibit");
-  gtkapplication.method<&GtkApplication_::is_inhibited>("is_inhibited");
+  gtkapplication.method<&GtkApplication_::inhibit>(
+      "inhibit", {Php::ByVal("window", "GtkWindow"), Php::ByVal("flags", Php::Type::Numeric),
+                  Php::ByVal("reason", Php::Type::String)});
+  gtkapplication.method<&GtkApplication_::uninhibit>("uninhibit",
+                                                     {Php::ByVal("cookie", Php::Type::Numeric)});
+  gtkapplication.method<&GtkApplication_::is_inhibited>("is_inhibited",
+                                                        {Php::ByVal("flags", Php::Type::Numeric)});
   gtkapplication.method<&GtkApplication_::prefers_app_menu>("prefers_app_menu");
   gtkapplication.method<&GtkApplication_::get_app_menu>("get_app_menu");
   gtkapplication.method<&GtkApplication_::set_app_menu>("set_app_menu");
@@ -266,9 +278,11 @@ PHPCPP_EXPORT void *get_module() {
   gtkapplication.method<&GtkApplication_::add_accelerator>("add_accelerator");
   gtkapplication.method<&GtkApplication_::remove_accelerator>("remove_accelerator");
   gtkapplication.method<&GtkApplication_::list_action_descriptions>("list_action_descriptions");
-  gtkapplication.method<&GtkApplication_::get_accels_for_action>("get_accels_for_action");
+  gtkapplication.method<&GtkApplication_::get_accels_for_action>(
+      "get_accels_for_action", {Php::ByVal("detailed_action_name", Php::Type::String)});
   gtkapplication.method<&GtkApplication_::set_accels_for_action>("set_accels_for_action");
-  gtkapplication.method<&GtkApplication_::get_actions_for_accel>("get_actions_for_accel");
+  gtkapplication.method<&GtkApplication_::get_actions_for_accel>(
+      "get_actions_for_accel", {Php::ByVal("accel", Php::Type::String)});
   gtkapplication.method<&GtkApplication_::window_new>("window_new");
 
   // GtkIconTheme
@@ -332,6 +346,68 @@ PHPCPP_EXPORT void *get_module() {
   gapplication.constant("FLAGS_NONE", G_APPLICATION_FLAGS_NONE);
 #endif
 
+  // GSubprocess
+  Php::Class<GSubprocess_> gsubprocess("GSubprocess");
+  gsubprocess.method<&GSubprocess_::__construct>("__construct");
+  gsubprocess.method<&GSubprocess_::set_stdout_callback>("set_stdout_callback");
+  gsubprocess.method<&GSubprocess_::set_stderr_callback>("set_stderr_callback");
+  gsubprocess.method<&GSubprocess_::set_exit_callback>("set_exit_callback");
+  gsubprocess.method<&GSubprocess_::set_max_pending_lines>("set_max_pending_lines");
+  gsubprocess.method<&GSubprocess_::start>("start");
+  gsubprocess.method<&GSubprocess_::cancel>("cancel");
+  gsubprocess.method<&GSubprocess_::send_signal>("send_signal");
+  gsubprocess.method<&GSubprocess_::get_identifier>("get_identifier");
+  gsubprocess.method<&GSubprocess_::is_running>("is_running");
+
+  // GtkWorkerPool
+  Php::Class<GtkWorkerPool_> gtkworkerpool("GtkWorkerPool");
+  gtkworkerpool.method<&GtkWorkerPool_::__construct>("__construct");
+  gtkworkerpool.method<&GtkWorkerPool_::submit>("submit");
+  gtkworkerpool.method<&GtkWorkerPool_::cancel>("cancel");
+  gtkworkerpool.method<&GtkWorkerPool_::cancel_all>("cancel_all");
+  gtkworkerpool.method<&GtkWorkerPool_::set_drain_callback>("set_drain_callback");
+  gtkworkerpool.method<&GtkWorkerPool_::get_pending>("get_pending");
+  gtkworkerpool.method<&GtkWorkerPool_::get_stats>("get_stats");
+  gtkworkerpool.method<&GtkWorkerPool_::shutdown>("shutdown");
+
+  // GFileEnumerator
+  Php::Class<GFileEnumerator_> gfileenumerator("GFileEnumerator");
+  gfileenumerator.method<&GFileEnumerator_::__construct>("__construct");
+  gfileenumerator.method<&GFileEnumerator_::set_batch_size>("set_batch_size");
+  gfileenumerator.method<&GFileEnumerator_::load_into>("load_into");
+  gfileenumerator.method<&GFileEnumerator_::cancel>("cancel");
+  gfileenumerator.method<&GFileEnumerator_::is_loading>("is_loading");
+  gfileenumerator.constant("TYPE_UNKNOWN", G_FILE_TYPE_UNKNOWN);
+  gfileenumerator.constant("TYPE_REGULAR", G_FILE_TYPE_REGULAR);
+  gfileenumerator.constant("TYPE_DIRECTORY", G_FILE_TYPE_DIRECTORY);
+  gfileenumerator.constant("TYPE_SYMBOLIC_LINK", G_FILE_TYPE_SYMBOLIC_LINK);
+  gfileenumerator.constant("TYPE_SPECIAL", G_FILE_TYPE_SPECIAL);
+  gfileenumerator.constant("TYPE_SHORTCUT", G_FILE_TYPE_SHORTCUT);
+  gfileenumerator.constant("TYPE_MOUNTABLE", G_FILE_TYPE_MOUNTABLE);
+
+  // GFileMonitor
+  Php::Class<GFileMonitor_> gfilemonitor("GFileMonitor");
+  gfilemonitor.extends(gobject);
+  gfilemonitor.method<&GFileMonitor_::__construct>("__construct");
+  gfilemonitor.method<&GFileMonitor_::set_callback>("set_callback");
+  gfilemonitor.method<&GFileMonitor_::set_coalesce_interval>("set_coalesce_interval");
+  gfilemonitor.method<&GFileMonitor_::cancel>("cancel");
+  gfilemonitor.method<&GFileMonitor_::is_cancelled>("is_cancelled");
+  gfilemonitor.constant("NONE", G_FILE_MONITOR_NONE);
+  gfilemonitor.constant("WATCH_MOUNTS", G_FILE_MONITOR_WATCH_MOUNTS);
+  gfilemonitor.constant("WATCH_HARD_LINKS", G_FILE_MONITOR_WATCH_HARD_LINKS);
+  gfilemonitor.constant("WATCH_MOVES", G_FILE_MONITOR_WATCH_MOVES);
+  gfilemonitor.constant("EVENT_CHANGED", G_FILE_MONITOR_EVENT_CHANGED);
+  gfilemonitor.constant("EVENT_CHANGES_DONE_HINT", G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT);
+  gfilemonitor.constant("EVENT_DELETED", G_FILE_MONITOR_EVENT_DELETED);
+  gfilemonitor.constant("EVENT_CREATED", G_FILE_MONITOR_EVENT_CREATED);
+  gfilemonitor.constant("EVENT_ATTRIBUTE_CHANGED", G_FILE_MONITOR_EVENT_ATTRIBUTE_CHANGED);
+  gfilemonitor.constant("EVENT_PRE_UNMOUNT", G_FILE_MONITOR_EVENT_PRE_UNMOUNT);
+  gfilemonitor.constant("EVENT_UNMOUNTED", G_FILE_MONITOR_EVENT_UNMOUNTED);
+  gfilemonitor.constant("EVENT_RENAMED", G_FILE_MONITOR_EVENT_RENAMED);
+  gfilemonitor.constant("EVENT_MOVED_IN", G_FILE_MONITOR_EVENT_MOVED_IN);
+  gfilemonitor.constant("EVENT_MOVED_OUT", G_FILE_MONITOR_EVENT_MOVED_OUT);
+
   gapplication.constant("IS_SERVICE", G_APPLICATION_IS_SERVICE);
   gapplication.constant("IS_LAUNCHER", G_APPLICATION_IS_LAUNCHER);
   gapplication.constant("HANDLES_OPEN", G_APPLICATION_HANDLES_OPEN);
@@ -1115,6 +1191,65 @@ PHPCPP_EXPORT void *get_module() {
   // GdkPixbufFormat
   Php::Class<GdkPixbufFormat_> gdkpixbufformat("GdkPixbufFormat");
 
+  // CairoContext
+  Php::Class<CairoContext_> cairocontext("CairoContext");
+  cairocontext.method<&CairoContext_::save>("save");
+  cairocontext.method<&CairoContext_::restore>("restore");
+  cairocontext.method<&CairoContext_::set_source_rgb>("set_source_rgb");
+  cairocontext.method<&CairoContext_::set_source_rgba>("set_source_rgba");
+  cairocontext.method<&CairoContext_::set_line_width>("set_line_width");
+  cairocontext.method<&CairoContext_::get_line_width>("get_line_width");
+  cairocontext.method<&CairoContext_::set_line_cap>("set_line_cap");
+  cairocontext.method<&CairoContext_::set_line_join>("set_line_join");
+  cairocontext.method<&CairoContext_::set_dash>("set_dash");
+  cairocontext.method<&CairoContext_::set_antialias>("set_antialias");
+  cairocontext.method<&CairoContext_::new_path>("new_path");
+  cairocontext.method<&CairoContext_::new_sub_path>("new_sub_path");
+  cairocontext.method<&CairoContext_::close_path>("close_path");
+  cairocontext.method<&CairoContext_::move_to>("move_to");
+  cairocontext.method<&CairoContext_::line_to>("line_to");
+  cairocontext.method<&CairoContext_::rel_move_to>("rel_move_to");
+  cairocontext.method<&CairoContext_::rel_line_to>("rel_line_to");
+  cairocontext.method<&CairoContext_::curve_to>("curve_to");
+  cairocontext.method<&CairoContext_::arc>("arc");
+  cairocontext.method<&CairoContext_::rectangle>("rectangle");
+  cairocontext.method<&CairoContext_::stroke>("stroke");
+  cairocontext.method<&CairoContext_::stroke_preserve>("stroke_preserve");
+  cairocontext.method<&CairoContext_::fill>("fill");
+  cairocontext.method<&CairoContext_::fill_preserve>("fill_preserve");
+  cairocontext.method<&CairoContext_::paint>("paint");
+  cairocontext.method<&CairoContext_::paint_with_alpha>("paint_with_alpha");
+  cairocontext.method<&CairoContext_::clip>("clip");
+  cairocontext.method<&CairoContext_::reset_clip>("reset_clip");
+  cairocontext.method<&CairoContext_::clip_extents>("clip_extents");
+  cairocontext.method<&CairoContext_::translate>("translate");
+  cairocontext.method<&CairoContext_::scale>("scale");
+  cairocontext.method<&CairoContext_::rotate>("rotate");
+  cairocontext.method<&CairoContext_::identity_matrix>("identity_matrix");
+  cairocontext.method<&CairoContext_::select_font_face>("select_font_face");
+  cairocontext.method<&CairoContext_::set_font_size>("set_font_size");
+  cairocontext.method<&CairoContext_::show_text>("show_text");
+  cairocontext.method<&CairoContext_::draw_polyline>("draw_polyline");
+  cairocontext.method<&CairoContext_::fill_rects>("fill_rects");
+  cairocontext.method<&CairoContext_::stroke_rects>("stroke_rects");
+  cairocontext.constant("LINE_CAP_BUTT", (int)CAIRO_LINE_CAP_BUTT);
+  cairocontext.constant("LINE_CAP_ROUND", (int)CAIRO_LINE_CAP_ROUND);
+  cairocontext.constant("LINE_CAP_SQUARE", (int)CAIRO_LINE_CAP_SQUARE);
+  cairocontext.constant("LINE_JOIN_MITER", (int)CAIRO_LINE_JOIN_MITER);
+  cairocontext.constant("LINE_JOIN_ROUND", (int)CAIRO_LINE_JOIN_ROUND);
+  cairocontext.constant("LINE_JOIN_BEVEL", (int)CAIRO_LINE_JOIN_BEVEL);
+  cairocontext.constant("ANTIALIAS_DEFAULT", (int)CAIRO_ANTIALIAS_DEFAULT);
+  cairocontext.constant("ANTIALIAS_NONE", (int)CAIRO_ANTIALIAS_NONE);
+  cairocontext.constant("ANTIALIAS_GRAY", (int)CAIRO_ANTIALIAS_GRAY);
+  cairocontext.constant("ANTIALIAS_FAST", (int)CAIRO_ANTIALIAS_FAST);
+  cairocontext.constant("ANTIALIAS_GOOD", (int)CAIRO_ANTIALIAS_GOOD);
+  cairocontext.constant("ANTIALIAS_BEST", (int)CAIRO_ANTIALIAS_BEST);
+  cairocontext.constant("FONT_SLANT_NORMAL", (int)CAIRO_FONT_SLANT_NORMAL);
+  cairocontext.constant("FONT_SLANT_ITALIC", (int)CAIRO_FONT_SLANT_ITALIC);
+  cairocontext.constant("FONT_SLANT_OBLIQUE", (int)CAIRO_FONT_SLANT_OBLIQUE);
+  cairocontext.constant("FONT_WEIGHT_NORMAL", (int)CAIRO_FONT_WEIGHT_NORMAL);
+  cairocontext.constant("FONT_WEIGHT_BOLD", (int)CAIRO_FONT_WEIGHT_BOLD);
+
   // GdkPixbufAlphaMode
   Php::Class<Php::Base> gdkpixbufalphamode("GdkPixbufAlphaMode");
   gdkpixbufalphamode.constant("BILEVEL", (int)GDK_PIXBUF_ALPHA_BILEVEL);
@@ -1166,6 +1301,17 @@ PHPCPP_EXPORT void *get_module() {
   gtk.method<&Gtk_::main_quit>("main_quit");
   gtk.method<&Gtk_::timeout_add>("timeout_add");
   gtk.method<&Gtk_::source_remove>("source_remove");
+  gtk.method<&Gtk_::io_add_watch>("io_add_watch");
+  gtk.method<&Gtk_::profiler_enable>("profiler_enable");
+  gtk.method<&Gtk_::profiler_disable>("profiler_disable");
+  gtk.method<&Gtk_::profiler_reset>("profiler_reset");
+  gtk.method<&Gtk_::profiler_report>("profiler_report");
+  gtk.method<&Gtk_::profiler_export_trace>("profiler_export_trace");
+  gtk.method<&Gtk_::watchdog_enable>("watchdog_enable");
+  gtk.method<&Gtk_::watchdog_disable>("watchdog_disable");
+  gtk.method<&Gtk_::watchdog_reports>("watchdog_reports");
+  gtk.method<&Gtk_::watchdog_clear>("watchdog_clear");
+  gtk.method<&Gtk_::watchdog_dump>("watchdog_dump");
   gtk.method<&Gtk_::is_destroyed>("is_destroyed");
   gtk.method<&Gtk_::show_uri_on_window>("show_uri_on_window");
   gtk.method<&Gtk_::events_pending>("events_pending");
@@ -1174,6 +1320,7 @@ PHPCPP_EXPORT void *get_module() {
   gtk.method<&Gtk_::get_major_version>("get_major_version");
   gtk.method<&Gtk_::get_micro_version>("get_micro_version");
   gtk.method<&Gtk_::get_minor_version>("get_minor_version");
+  gtk.method<&Gtk_::resources_register>("resources_register");
 
   gtk.constant("MAJOR_VERSION", GTK_MAJOR_VERSION);
   gtk.constant("MICRO_VERSION", GTK_MICRO_VERSION);
@@ -1181,6 +1328,13 @@ PHPCPP_EXPORT void *get_module() {
   gtk.constant("INTERFACE_AGE", GTK_INTERFACE_AGE);
   gtk.constant("BINARY_AGE", GTK_BINARY_AGE);
 
+  gtk.constant("IO_IN", G_IO_IN);
+  gtk.constant("IO_OUT", G_IO_OUT);
+  gtk.constant("IO_PRI", G_IO_PRI);
+  gtk.constant("IO_ERR", G_IO_ERR);
+  gtk.constant("IO_HUP", G_IO_HUP);
+  gtk.constant("IO_NVAL", G_IO_NVAL);
+
   gtk.constant("ORIENTATION_HORIZONTAL", GTK_ORIENTATION_HORIZONTAL);
   gtk.constant("ORIENTATION_VERTICAL", GTK_ORIENTATION_VERTICAL);
 
@@ -1416,6 +1570,7 @@ PHPCPP_EXPORT void *get_module() {
   gtkwidget.method<&GtkWidget_::get_allocated_width>("get_allocated_width");
   gtkwidget.method<&GtkWidget_::get_allocated_height>("get_allocated_height");
   gtkwidget.method<&GtkWidget_::get_allocation>("get_allocation");
+  gtkwidget.method<&GtkWidget_::snapshot_tree>("snapshot_tree");
   gtkwidget.method<&GtkWidget_::set_allocation>("set_allocation");
   gtkwidget.method<&GtkWidget_::get_allocated_baseline>("get_allocated_baseline");
   gtkwidget.method<&GtkWidget_::get_allocated_size>("get_allocated_size");
@@ -1774,6 +1929,14 @@ PHPCPP_EXPORT void *get_module() {
   gtkwindow.method<&GtkWindow_::begin_resize_drag>("begin_resize_drag");
   gtkwindow.method<&GtkWindow_::add_accel_group>("add_accel_group");
 
+  // GtkOffscreenWindow
+  Php::Class<GtkOffscreenWindow_> gtkoffscreenwindow("GtkOffscreenWindow");
+  gtkoffscreenwindow.extends(gtkwindow);
+  gtkoffscreenwindow.method<&GtkOffscreenWindow_::__construct>("__construct");
+  gtkoffscreenwindow.method<&GtkOffscreenWindow_::get_pixbuf>("get_pixbuf");
+  gtkoffscreenwindow.method<&GtkOffscreenWindow_::render>("render");
+  gtkoffscreenwindow.method<&GtkOffscreenWindow_::render_many>("render_many");
+
   // GtkWindowType
   Php::Class<Php::Base> gtkwindowtype("GtkWindowType");
   gtkwindowtype.constant("TOPLEVEL", GTK_WINDOW_TOPLEVEL);
@@ -2733,6 +2896,23 @@ PHPCPP_EXPORT void *get_module() {
   gtktextbuffer.method<&GtkTextBuffer_::unregister_deserialize_format>(
       "unregister_deserialize_format");
   gtktextbuffer.method<&GtkTextBuffer_::unregister_serialize_format>("unregister_serialize_format");
+  gtktextbuffer.method<&GtkTextBuffer_::search_all>("search_all");
+  gtktextbuffer.method<&GtkTextBuffer_::search_all_async>("search_all_async");
+  gtktextbuffer.method<&GtkTextBuffer_::cancel_searches>("cancel_searches");
+  gtktextbuffer.method<&GtkTextBuffer_::replace_all>("replace_all");
+  gtktextbuffer.method<&GtkTextBuffer_::export_runs>("export_runs");
+  gtktextbuffer.method<&GtkTextBuffer_::import_runs>("import_runs");
+  gtktextbuffer.method<&GtkTextBuffer_::enable_undo>("enable_undo");
+  gtktextbuffer.method<&GtkTextBuffer_::disable_undo>("disable_undo");
+  gtktextbuffer.method<&GtkTextBuffer_::clear_undo>("clear_undo");
+  gtktextbuffer.method<&GtkTextBuffer_::undo>("undo");
+  gtktextbuffer.method<&GtkTextBuffer_::redo>("redo");
+  gtktextbuffer.method<&GtkTextBuffer_::can_undo>("can_undo");
+  gtktextbuffer.method<&GtkTextBuffer_::can_redo>("can_redo");
+  gtktextbuffer.method<&GtkTextBuffer_::get_undo_stats>("get_undo_stats");
+  gtktextbuffer.constant("SEARCH_REGEX", (int)GtkTextBuffer_::SEARCH_REGEX);
+  gtktextbuffer.constant("SEARCH_CASE_INSENSITIVE", (int)GtkTextBuffer_::SEARCH_CASE_INSENSITIVE);
+  gtktextbuffer.constant("SEARCH_WHOLE_WORD", (int)GtkTextBuffer_::SEARCH_WHOLE_WORD);
 
   // GtkTextTag
   Php::Class<GtkTextTag_> gtktexttag("GtkTextTag");
@@ -3335,6 +3515,9 @@ PHPCPP_EXPORT void *get_module() {
   gtktreeselection.method<&GtkTreeSelection_::unselect_all>("unselect_all");
   gtktreeselection.method<&GtkTreeSelection_::unselect_range>("unselect_range");
   gtktreeselection.method<&GtkTreeSelection_::select_range>("select_range");
+  gtktreeselection.method<&GtkTreeSelection_::get_selected_indices>("get_selected_indices");
+  gtktreeselection.method<&GtkTreeSelection_::get_selected_data>("get_selected_data");
+  gtktreeselection.method<&GtkTreeSelection_::select_indices>("select_indices");
 
   // GtkTreeSortable
   Php::Class<GtkTreeSortable_> gtktreesortable("GtkTreeSortable");
@@ -3593,15 +3776,20 @@ PHPCPP_EXPORT void *get_module() {
   gtkbuilder.method<&GtkBuilder_::add_from_file>("add_from_file");
   gtkbuilder.method<&GtkBuilder_::add_from_resource>("add_from_resource");
   gtkbuilder.method<&GtkBuilder_::add_from_string>("add_from_string");
+  gtkbuilder.method<&GtkBuilder_::new_from_file_cached>("new_from_file_cached");
+  gtkbuilder.method<&GtkBuilder_::add_from_file_cached>("add_from_file_cached");
+  gtkbuilder.method<&GtkBuilder_::clear_cache>("clear_cache");
   gtkbuilder.method<&GtkBuilder_::add_objects_from_file>("add_objects_from_file");
   gtkbuilder.method<&GtkBuilder_::add_objects_from_string>("add_objects_from_string");
   gtkbuilder.method<&GtkBuilder_::add_objects_from_resource>("add_objects_from_resource");
   gtkbuilder.method<&GtkBuilder_::extend_with_template>("extend_with_template");
   gtkbuilder.method<&GtkBuilder_::get_object>("get_object");
   gtkbuilder.method<&GtkBuilder_::get_objects>("get_objects");
+  gtkbuilder.method<&GtkBuilder_::bind_objects>("bind_objects");
   gtkbuilder.method<&GtkBuilder_::expose_object>("expose_object");
   gtkbuilder.method<&GtkBuilder_::connect_signals>("connect_signals");
   gtkbuilder.method<&GtkBuilder_::connect_signals_full>("connect_signals_full");
+  gtkbuilder.method<&GtkBuilder_::connect_signals_to>("connect_signals_to");
   gtkbuilder.method<&GtkBuilder_::set_translation_domain>("set_translation_domain");
   gtkbuilder.method<&GtkBuilder_::get_translation_domain>("get_translation_domain");
   gtkbuilder.method<&GtkBuilder_::get_application>("get_application");
@@ -4193,6 +4381,9 @@ PHPCPP_EXPORT void *get_module() {
   gtkcssprovider.method<&GtkCssProvider_::load_from_file>("load_from_file");
   gtkcssprovider.method<&GtkCssProvider_::load_from_path>("load_from_path");
   gtkcssprovider.method<&GtkCssProvider_::load_from_resource>("load_from_resource");
+  gtkcssprovider.method<&GtkCssProvider_::load_from_file_cached>("load_from_file_cached");
+  gtkcssprovider.method<&GtkCssProvider_::register_cache_bundle>("register_cache_bundle");
+  gtkcssprovider.method<&GtkCssProvider_::clear_cache>("clear_cache");
   gtkcssprovider.method<&GtkCssProvider_::__construct>("__construct");
   gtkcssprovider.method<&GtkCssProvider_::to_string>("to_string");
   gtkcssprovider.method<&GtkCssProvider_::gtk_css_section_get_end_line>(
@@ -4250,6 +4441,8 @@ PHPCPP_EXPORT void *get_module() {
   gtkstylecontext.method<&GtkStyleContext_::remove_provider_for_screen>(
       "remove_provider_for_screen");
   gtkstylecontext.method<&GtkStyleContext_::reset_widgets>("reset_widgets");
+  gtkstylecontext.method<&GtkStyleContext_::replace_providers_for_screen>(
+      "replace_providers_for_screen");
   gtkstylecontext.method<&GtkStyleContext_::set_background>("set_background");
   gtkstylecontext.method<&GtkStyleContext_::restore>("restore");
   gtkstylecontext.method<&GtkStyleContext_::save>("save");
@@ -4359,6 +4552,11 @@ PHPCPP_EXPORT void *get_module() {
   Php::Class<GtkDrawingArea_> gtkdrawingarea("GtkDrawingArea");
   gtkdrawingarea.extends(gtkwidget);
   gtkdrawingarea.method<&GtkDrawingArea_::__construct>("__construct");
+  gtkdrawingarea.method<&GtkDrawingArea_::add_layer>("add_layer");
+  gtkdrawingarea.method<&GtkDrawingArea_::remove_layer>("remove_layer");
+  gtkdrawingarea.method<&GtkDrawingArea_::has_layer>("has_layer");
+  gtkdrawingarea.method<&GtkDrawingArea_::is_layer_dirty>("is_layer_dirty");
+  gtkdrawingarea.method<&GtkDrawingArea_::invalidate_layer>("invalidate_layer");
 
   // Pango
   Php::Class<Php::Base> pango("Pango");
@@ -4466,6 +4664,16 @@ PHPCPP_EXPORT void *get_module() {
   pangolayout.method<&PangoLayout_::set_line_spacing>("set_line_spacing");
   pangolayout.method<&PangoLayout_::get_line_spacing>("get_line_spacing");
 
+  // PangoLayoutCache
+  Php::Class<PangoLayoutCache_> pangolayoutcache("PangoLayoutCache");
+  pangolayoutcache.method<&PangoLayoutCache_::__construct>("__construct");
+  pangolayoutcache.method<&PangoLayoutCache_::measure>("measure");
+  pangolayoutcache.method<&PangoLayoutCache_::measure_many>("measure_many");
+  pangolayoutcache.method<&PangoLayoutCache_::get_layout>("get_layout");
+  pangolayoutcache.method<&PangoLayoutCache_::render>("render");
+  pangolayoutcache.method<&PangoLayoutCache_::clear>("clear");
+  pangolayoutcache.method<&PangoLayoutCache_::get_stats>("get_stats");
+
   // PangoLayoutLine
   Php::Class<PangoLayoutLine_> pangolayoutline("PangoLayoutLine");
   pangolayoutline.extends(gobject);
@@ -4538,6 +4746,9 @@ PHPCPP_EXPORT void *get_module() {
   gtksourceview.method<&GtkSourceView_::get_gutter>("get_gutter");
   gtksourceview.method<&GtkSourceView_::set_background_pattern>("set_background_pattern");
   gtksourceview.method<&GtkSourceView_::get_background_pattern>("get_background_pattern");
+  gtksourceview.method<&GtkSourceView_::set_large_file_threshold>("set_large_file_threshold");
+  gtksourceview.method<&GtkSourceView_::get_large_file_threshold>("get_large_file_threshold");
+  gtksourceview.method<&GtkSourceView_::is_large_file>("is_large_file");
 
   // GtkSourceLanguage
   Php::Class<GtkSourceLanguage_> gtksourcelanguage("GtkSourceLanguage");
@@ -4550,6 +4761,22 @@ PHPCPP_EXPORT void *get_module() {
   gtksourcebuffer.method<&GtkSourceBuffer_::set_language>("set_language");
   gtksourcebuffer.method<&GtkSourceBuffer_::change_case>("change_case");
   gtksourcebuffer.method<&GtkSourceBuffer_::new_with_language>("new_with_language");
+  gtksourcebuffer.method<&GtkSourceBuffer_::set_highlight_syntax>("set_highlight_syntax");
+  gtksourcebuffer.method<&GtkSourceBuffer_::get_highlight_syntax>("get_highlight_syntax");
+  gtksourcebuffer.method<&GtkSourceBuffer_::set_highlight_matching_brackets>(
+      "set_highlight_matching_brackets");
+  gtksourcebuffer.method<&GtkSourceBuffer_::get_highlight_matching_brackets>(
+      "get_highlight_matching_brackets");
+  gtksourcebuffer.method<&GtkSourceBuffer_::is_highlight_suppressed>("is_highlight_suppressed");
+  gtksourcebuffer.method<&GtkSourceBuffer_::ensure_highlight>("ensure_highlight");
+  gtksourcebuffer.method<&GtkSourceBuffer_::set_highlight_budget>("set_highlight_budget");
+  gtksourcebuffer.method<&GtkSourceBuffer_::get_highlight_budget>("get_highlight_budget");
+  gtksourcebuffer.method<&GtkSourceBuffer_::highlight_in_background>("highlight_in_background");
+  gtksourcebuffer.method<&GtkSourceBuffer_::stop_background_highlight>(
+      "stop_background_highlight");
+  gtksourcebuffer.method<&GtkSourceBuffer_::load_file>("load_file");
+  gtksourcebuffer.method<&GtkSourceBuffer_::cancel_load>("cancel_load");
+  gtksourcebuffer.method<&GtkSourceBuffer_::is_loading>("is_loading");
 
   // GtkSourceChangeCaseType
   Php::Class<Php::Base> gtksourcechangecasetype("GtkSourceChangeCaseType");
@@ -4569,6 +4796,32 @@ PHPCPP_EXPORT void *get_module() {
   gtksourcelanguagemanager.method<&GtkSourceLanguageManager_::get_search_path>("get_search_path");
   gtksourcelanguagemanager.method<&GtkSourceLanguageManager_::guess_language>("guess_language");
 
+  // GtkSourceSearchContext
+  Php::Class<GtkSourceSearchContext_> gtksourcesearchcontext("GtkSourceSearchContext");
+  gtksourcesearchcontext.extends(gobject);
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::__construct>("__construct");
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::set_search_text>("set_search_text");
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::get_search_text>("get_search_text");
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::set_case_sensitive>("set_case_sensitive");
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::get_case_sensitive>("get_case_sensitive");
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::set_at_word_boundaries>(
+      "set_at_word_boundaries");
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::get_at_word_boundaries>(
+      "get_at_word_boundaries");
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::set_regex_enabled>("set_regex_enabled");
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::get_regex_enabled>("get_regex_enabled");
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::set_wrap_around>("set_wrap_around");
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::get_wrap_around>("get_wrap_around");
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::set_highlight>("set_highlight");
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::get_highlight>("get_highlight");
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::get_regex_error>("get_regex_error");
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::get_occurrences_count>(
+      "get_occurrences_count");
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::forward>("forward");
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::backward>("backward");
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::replace>("replace");
+  gtksourcesearchcontext.method<&GtkSourceSearchContext_::replace_all>("replace_all");
+
 #ifdef WITH_WEBKIT
   // WebKitWebView
   Php::Class<WebKitWebView_> webkitwebview("WebKitWebView");
@@ -4699,6 +4952,7 @@ PHPCPP_EXPORT void *get_module() {
   extension.add(std::move(gdkrgba));
 
   extension.add(std::move(gdkpixbufformat));
+  extension.add(std::move(cairocontext));
   extension.add(std::move(gdkpixbufalphamode));
   extension.add(std::move(gdkmodifiertype));
   extension.add(std::move(gdkcolorspace));
@@ -4726,6 +4980,10 @@ PHPCPP_EXPORT void *get_module() {
   extension.add(std::move(gdkwindowtypehint));
 
   extension.add(std::move(gapplication));
+  extension.add(std::move(gsubprocess));
+  extension.add(std::move(gtkworkerpool));
+  extension.add(std::move(gfileenumerator));
+  extension.add(std::move(gfilemonitor));
 
   extension.add(std::move(gtk));
   extension.add(std::move(gtkapplication));
@@ -4747,6 +5005,7 @@ PHPCPP_EXPORT void *get_module() {
   extension.add(std::move(gtkeventbox));
   extension.add(std::move(gtkpaned));
   extension.add(std::move(gtkwindow));
+  extension.add(std::move(gtkoffscreenwindow));
   extension.add(std::move(gtkwindowtype));
   extension.add(std::move(gtkwindowposition));
   extension.add(std::move(gtkapplicationwindow));
@@ -4945,6 +5204,7 @@ PHPCPP_EXPORT void *get_module() {
   extension.add(std::move(pangoalignment));
   extension.add(std::move(pangocontext));
   extension.add(std::move(pangolayout));
+  extension.add(std::move(pangolayoutcache));
   extension.add(std::move(pangolayoutline));
 
 #ifdef WITH_WEBKIT
@@ -4969,9 +5229,13 @@ PHPCPP_EXPORT void *get_module() {
   extension.add(std::move(gtksourcebuffer));
   extension.add(std::move(gtksourcelanguage));
   extension.add(std::move(gtksourcelanguagemanager));
+  extension.add(std::move(gtksourcesearchcontext));
   extension.add(std::move(gtksourcechangecasetype));
   extension.add(std::move(gtksourceview));
 
+  // Stop the watchdog thread before the executor it interrupts goes away
+  extension.onIdle([]() { phpgtk_watchdog::disable(); });
+
   // return the extension
   return extension;
 }
@@ -5083,8 +5347,8 @@ GValue phpgtk_get_gvalue(const Php::Value &phpgtk_value, GType type_column) {
       break;
     }
     case G_TYPE_STRING: {
-      // Cast
-      std::string b = phpgtk_value;
+      // View, the GValue takes its own copy
+      phpgtk_string b(phpgtk_value);
 
       g_value_init(&gtk_value, G_TYPE_STRING);
       g_value_set_string(&gtk_value, b.c_str());
@@ -13,6 +13,9 @@
 	#include "src/G/GApplication.h"
 	#include "src/G/GObject.h"
 	#include "src/G/GIcon.h"
+	#include "src/G/GSubprocess.h"
+	#include "src/G/GFileEnumerator.h"
+	#include "src/G/GFileMonitor.h"
 
 	// GDK
 	#include "src/Gdk/Gdk.h"
@@ -36,6 +39,9 @@
 	#include "src/Gdk/GdkDisplay.h"
 	#include "src/Gdk/GdkMonitor.h"
 
+	// Cairo
+	#include "src/Cairo/CairoContext.h"
+
 	// GTK
 	#include "src/Gtk/Gtk.h"
 	#include "src/Gtk/GtkApplication.h"
@@ -56,6 +62,8 @@
 	#include "src/Gtk/GtkViewport.h"
 	#include "src/Gtk/GtkEventBox.h"
 	#include "src/Gtk/GtkWindow.h"
+	#include "src/Gtk/GtkOffscreenWindow.h"
+	#include "src/Gtk/GtkWorkerPool.h"
 	#include "src/Gtk/GtkApplicationWindow.h"
 	#include "src/Gtk/GtkButton.h"
 	#include "src/Gtk/GtkColorButton.h"
@@ -155,6 +163,7 @@
 	#include "src/GtkSourceView/GtkSourceBuffer.h"
 	#include "src/GtkSourceView/GtkSourceLanguage.h"
 	#include "src/GtkSourceView/GtkSourceLanguageManager.h"
+	#include "src/GtkSourceView/GtkSourceSearchContext.h"
 
 #ifdef WITH_GLADEUI
 	// Glade
@@ -170,6 +179,7 @@
 	#include "src/Pango/PangoAttrList.h"
 	#include "src/Pango/PangoContext.h"
 	#include "src/Pango/PangoLayout.h"
+	#include "src/Pango/PangoLayoutCache.h"
 	#include "src/Pango/PangoLayoutLine.h"
 	#include "src/Pango/PangoWrapMode.h"
 
@@ -18,6 +18,12 @@ bool phpgtk_check_parameter(Php::Parameters &parameters, int param, Php::Type ex
       return true;
     }
 
+    // Integers are accepted for floats
+    if ((expected_type == Php::Type::Float) &&
+        (parameters[param - 1].type() == Php::Type::Numeric)) {
+      return true;
+    }
+
     // Text Object type
     if ((expected_type == Php::Type::Object) && (!Php::is_a(parameters[param - 1], object_type))) {
       throw Php::Exception(
@@ -43,6 +49,12 @@ bool phpgtk_check_parameter(Php::Parameters &parameters, int param, Php::Type ex
       return true;
     }
 
+    // Integers are accepted for floats
+    if ((expected_type == Php::Type::Float) &&
+        (parameters[param - 1].type() == Php::Type::Numeric)) {
+      return true;
+    }
+
     // Test Object type before general type check
     if ((expected_type == Php::Type::Object) && (!Php::is_a(parameters[param - 1], object_type))) {
       Php::warning << "Invalid type for optional parameter " << param << std::flush;
@@ -5,6 +5,7 @@
     #include <iostream>
     #include <gtk/gtk.h>
     
+	#include "src/G/PhpClosure.h"
 	#include "src/Gtk/GtkWidget.h"
 
 
@@ -16,14 +17,12 @@
 	/**
 	 * Struct for generic callback
 	 */
-	struct generic_st_callback {
-		Php::Value callback_name;
-		Php::Object self_widget;
-		Php::Parameters parameters;
-
-		GType return_type;
-		int n_params;
-		GType *param_types;
+	struct generic_st_callback : public phpgtk_closure {
+		std::vector<Php::Value> parameters;
+
+		GType return_type{};
+		int n_params{};
+		GType *param_types{};
 	};
 
 	void generic_callback(gpointer *self, ...);
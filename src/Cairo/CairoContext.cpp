@@ -0,0 +1,414 @@
+
+#include "CairoContext.h"
+#include "../Gdk/GdkEvent.h"
+
+/**
+ * Constructor
+ */
+CairoContext_::CairoContext_() = default;
+
+/**
+ * Destructor
+ */
+CairoContext_::~CairoContext_() {
+  if (instance != nullptr) {
+    cairo_destroy(instance);
+  }
+}
+
+cairo_t *CairoContext_::get_instance() {
+  return instance;
+}
+
+void CairoContext_::set_instance(cairo_t *cr) {
+  if (instance != nullptr) {
+    cairo_destroy(instance);
+  }
+
+  instance = (cr != nullptr) ? cairo_reference(cr) : nullptr;
+}
+
+bool phpgtk_is_cairo_context(const Php::Value &value) {
+  return value.instanceOf("CairoContext") || value.instanceOf("GdkEvent");
+}
+
+cairo_t *phpgtk_get_cairo_context(const Php::Value &value) {
+  if (value.instanceOf("CairoContext")) {
+    CairoContext_ *phpgtk_cairo = (CairoContext_ *)value.implementation();
+    return phpgtk_cairo->get_instance();
+  }
+
+  // Before CairoContext existed, the draw signal delivered cairo_t as GdkEvent::instance
+  if (value.instanceOf("GdkEvent")) {
+    GdkEvent_ *phpgtk_event = (GdkEvent_ *)value.implementation();
+    return (cairo_t *)phpgtk_event->instance;
+  }
+
+  return nullptr;
+}
+
+/**
+ * Check the context is alive, before any cairo call
+ */
+static cairo_t *phpgtk_cairo_checked(cairo_t *cr) {
+  if (cr == nullptr) {
+    throw Php::Exception("CairoContext: invalid cairo context (null pointer)");
+  }
+
+  return cr;
+}
+
+/**
+ * Append a list of points to the current path, [[x, y], ...] or [x0, y0, x1, y1, ...]
+ */
+static int phpgtk_cairo_append_points(cairo_t *cr, const Php::Value &points) {
+  int n_points = 0;
+  bool has_x = false;
+  double pending_x = 0;
+
+  for (auto &iter : points) {
+    const Php::Value &item = iter.second;
+    double x;
+    double y;
+
+    if (item.isArray()) {
+      x = item.get(0).floatValue();
+      y = item.get(1).floatValue();
+    } else if (!has_x) {
+      pending_x = item.floatValue();
+      has_x = true;
+      continue;
+    } else {
+      x = pending_x;
+      y = item.floatValue();
+      has_x = false;
+    }
+
+    if (n_points == 0) {
+      cairo_move_to(cr, x, y);
+    } else {
+      cairo_line_to(cr, x, y);
+    }
+    n_points++;
+  }
+
+  return n_points;
+}
+
+/**
+ * Append a list of rectangles to the current path, [[x, y, w, h], ...] or a flat list
+ */
+static void phpgtk_cairo_append_rects(cairo_t *cr, const Php::Value &rects) {
+  double values[4];
+  int n_values = 0;
+
+  for (auto &iter : rects) {
+    const Php::Value &item = iter.second;
+
+    if (item.isArray()) {
+      cairo_rectangle(cr, item.get(0).floatValue(), item.get(1).floatValue(),
+                      item.get(2).floatValue(), item.get(3).floatValue());
+      continue;
+    }
+
+    values[n_values++] = item.floatValue();
+    if (n_values == 4) {
+      cairo_rectangle(cr, values[0], values[1], values[2], values[3]);
+      n_values = 0;
+    }
+  }
+}
+
+void CairoContext_::save() {
+  cairo_save(phpgtk_cairo_checked(instance));
+}
+
+void CairoContext_::restore() {
+  cairo_restore(phpgtk_cairo_checked(instance));
+}
+
+void CairoContext_::set_source_rgb(Php::Parameters &parameters) {
+  double red = parameters[0];
+  double green = parameters[1];
+  double blue = parameters[2];
+
+  cairo_set_source_rgb(phpgtk_cairo_checked(instance), red, green, blue);
+}
+
+void CairoContext_::set_source_rgba(Php::Parameters &parameters) {
+  double red = parameters[0];
+  double green = parameters[1];
+  double blue = parameters[2];
+  double alpha = parameters[3];
+
+  cairo_set_source_rgba(phpgtk_cairo_checked(instance), red, green, blue, alpha);
+}
+
+void CairoContext_::set_line_width(Php::Parameters &parameters) {
+  double width = parameters[0];
+
+  cairo_set_line_width(phpgtk_cairo_checked(instance), width);
+}
+
+Php::Value CairoContext_::get_line_width() {
+  return cairo_get_line_width(phpgtk_cairo_checked(instance));
+}
+
+void CairoContext_::set_line_cap(Php::Parameters &parameters) {
+  int line_cap = parameters[0];
+
+  cairo_set_line_cap(phpgtk_cairo_checked(instance), (cairo_line_cap_t)line_cap);
+}
+
+void CairoContext_::set_line_join(Php::Parameters &parameters) {
+  int line_join = parameters[0];
+
+  cairo_set_line_join(phpgtk_cairo_checked(instance), (cairo_line_join_t)line_join);
+}
+
+void CairoContext_::set_dash(Php::Parameters &parameters) {
+  Php::Value arr = parameters[0];
+
+  double offset = 0;
+  if (parameters.size() > 1) {
+    offset = parameters[1];
+  }
+
+  int n_dashes = arr.size();
+  double *dashes = (double *)g_malloc0(sizeof(double) * (n_dashes + 1));
+  for (int index = 0; index < n_dashes; index++) {
+    dashes[index] = arr.get(index).floatValue();
+  }
+
+  cairo_set_dash(phpgtk_cairo_checked(instance), dashes, n_dashes, offset);
+
+  g_free(dashes);
+}
+
+void CairoContext_::set_antialias(Php::Parameters &parameters) {
+  int antialias = parameters[0];
+
+  cairo_set_antialias(phpgtk_cairo_checked(instance), (cairo_antialias_t)antialias);
+}
+
+void CairoContext_::new_path() {
+  cairo_new_path(phpgtk_cairo_checked(instance));
+}
+
+void CairoContext_::new_sub_path() {
+  cairo_new_sub_path(phpgtk_cairo_checked(instance));
+}
+
+void CairoContext_::close_path() {
+  cairo_close_path(phpgtk_cairo_checked(instance));
+}
+
+void CairoContext_::move_to(Php::Parameters &parameters) {
+  double x = parameters[0];
+  double y = parameters[1];
+
+  cairo_move_to(phpgtk_cairo_checked(instance), x, y);
+}
+
+void CairoContext_::line_to(Php::Parameters &parameters) {
+  double x = parameters[0];
+  double y = parameters[1];
+
+  cairo_line_to(phpgtk_cairo_checked(instance), x, y);
+}
+
+void CairoContext_::rel_move_to(Php::Parameters &parameters) {
+  double dx = parameters[0];
+  double dy = parameters[1];
+
+  cairo_rel_move_to(phpgtk_cairo_checked(instance), dx, dy);
+}
+
+void CairoContext_::rel_line_to(Php::Parameters &parameters) {
+  double dx = parameters[0];
+  double dy = parameters[1];
+
+  cairo_rel_line_to(phpgtk_cairo_checked(instance), dx, dy);
+}
+
+void CairoContext_::curve_to(Php::Parameters &parameters) {
+  double x1 = parameters[0];
+  double y1 = parameters[1];
+  double x2 = parameters[2];
+  double y2 = parameters[3];
+  double x3 = parameters[4];
+  double y3 = parameters[5];
+
+  cairo_curve_to(phpgtk_cairo_checked(instance), x1, y1, x2, y2, x3, y3);
+}
+
+void CairoContext_::arc(Php::Parameters &parameters) {
+  double xc = parameters[0];
+  double yc = parameters[1];
+  double radius = parameters[2];
+  double angle1 = parameters[3];
+  double angle2 = parameters[4];
+
+  cairo_arc(phpgtk_cairo_checked(instance), xc, yc, radius, angle1, angle2);
+}
+
+void CairoContext_::rectangle(Php::Parameters &parameters) {
+  double x = parameters[0];
+  double y = parameters[1];
+  double width = parameters[2];
+  double height = parameters[3];
+
+  cairo_rectangle(phpgtk_cairo_checked(instance), x, y, width, height);
+}
+
+void CairoContext_::stroke() {
+  cairo_stroke(phpgtk_cairo_checked(instance));
+}
+
+void CairoContext_::stroke_preserve() {
+  cairo_stroke_preserve(phpgtk_cairo_checked(instance));
+}
+
+void CairoContext_::fill() {
+  cairo_fill(phpgtk_cairo_checked(instance));
+}
+
+void CairoContext_::fill_preserve() {
+  cairo_fill_preserve(phpgtk_cairo_checked(instance));
+}
+
+void CairoContext_::paint() {
+  cairo_paint(phpgtk_cairo_checked(instance));
+}
+
+void CairoContext_::paint_with_alpha(Php::Parameters &parameters) {
+  double alpha = parameters[0];
+
+  cairo_paint_with_alpha(phpgtk_cairo_checked(instance), alpha);
+}
+
+void CairoContext_::clip() {
+  cairo_clip(phpgtk_cairo_checked(instance));
+}
+
+void CairoContext_::reset_clip() {
+  cairo_reset_clip(phpgtk_cairo_checked(instance));
+}
+
+Php::Value CairoContext_::clip_extents() {
+  double x1, y1, x2, y2;
+
+  cairo_clip_extents(phpgtk_cairo_checked(instance), &x1, &y1, &x2, &y2);
+
+  Php::Value ret;
+  ret["x1"] = x1;
+  ret["y1"] = y1;
+  ret["x2"] = x2;
+  ret["y2"] = y2;
+
+  return ret;
+}
+
+void CairoContext_::translate(Php::Parameters &parameters) {
+  double tx = parameters[0];
+  double ty = parameters[1];
+
+  cairo_translate(phpgtk_cairo_checked(instance), tx, ty);
+}
+
+void CairoContext_::scale(Php::Parameters &parameters) {
+  double sx = parameters[0];
+  double sy = parameters[1];
+
+  cairo_scale(phpgtk_cairo_checked(instance), sx, sy);
+}
+
+void CairoContext_::rotate(Php::Parameters &parameters) {
+  double angle = parameters[0];
+
+  cairo_rotate(phpgtk_cairo_checked(instance), angle);
+}
+
+void CairoContext_::identity_matrix() {
+  cairo_identity_matrix(phpgtk_cairo_checked(instance));
+}
+
+void CairoContext_::select_font_face(Php::Parameters &parameters) {
+  std::string s_family = parameters[0];
+
+  int slant = CAIRO_FONT_SLANT_NORMAL;
+  if (parameters.size() > 1) {
+    slant = parameters[1];
+  }
+
+  int weight = CAIRO_FONT_WEIGHT_NORMAL;
+  if (parameters.size() > 2) {
+    weight = parameters[2];
+  }
+
+  cairo_select_font_face(phpgtk_cairo_checked(instance), s_family.c_str(),
+                         (cairo_font_slant_t)slant, (cairo_font_weight_t)weight);
+}
+
+void CairoContext_::set_font_size(Php::Parameters &parameters) {
+  double size = parameters[0];
+
+  cairo_set_font_size(phpgtk_cairo_checked(instance), size);
+}
+
+void CairoContext_::show_text(Php::Parameters &parameters) {
+  std::string s_text = parameters[0];
+
+  cairo_show_text(phpgtk_cairo_checked(instance), s_text.c_str());
+}
+
+void CairoContext_::draw_polyline(Php::Parameters &parameters) {
+  cairo_t *cr = phpgtk_cairo_checked(instance);
+
+  if (parameters.empty() || !parameters[0].isArray()) {
+    throw Php::Exception("CairoContext::draw_polyline expects an array of points");
+  }
+
+  bool close = false;
+  if (parameters.size() > 1) {
+    close = parameters[1].boolValue();
+  }
+
+  cairo_new_path(cr);
+  int n_points = phpgtk_cairo_append_points(cr, parameters[0]);
+
+  if (n_points < 2) {
+    cairo_new_path(cr);
+    return;
+  }
+
+  if (close) {
+    cairo_close_path(cr);
+  }
+
+  cairo_stroke(cr);
+}
+
+void CairoContext_::fill_rects(Php::Parameters &parameters) {
+  cairo_t *cr = phpgtk_cairo_checked(instance);
+
+  if (parameters.empty() || !parameters[0].isArray()) {
+    throw Php::Exception("CairoContext::fill_rects expects an array of rectangles");
+  }
+
+  cairo_new_path(cr);
+  phpgtk_cairo_append_rects(cr, parameters[0]);
+  cairo_fill(cr);
+}
+
+void CairoContext_::stroke_rects(Php::Parameters &parameters) {
+  cairo_t *cr = phpgtk_cairo_checked(instance);
+
+  if (parameters.empty() || !parameters[0].isArray()) {
+    throw Php::Exception("CairoContext::stroke_rects expects an array of rectangles");
+  }
+
+  cairo_new_path(cr);
+  phpgtk_cairo_append_rects(cr, parameters[0]);
+  cairo_stroke(cr);
+}
@@ -0,0 +1,92 @@
+#ifndef _PHPGTK_CAIROCONTEXT_H_
+#define _PHPGTK_CAIROCONTEXT_H_
+
+#include <phpcpp.h>
+#include <gtk/gtk.h>
+#include <cairo-gobject.h>
+
+/**
+ * CairoContext_
+ *
+ * Wrapper of cairo_t, received by the "draw" signal handlers
+ *
+ * https://www.cairographics.org/manual/cairo-cairo-t.html
+ */
+class CairoContext_ : public Php::Base {
+  /**
+   * Publics
+   */
+ public:
+  cairo_t *instance{};
+
+  /**
+   *  C++ constructor and destructor
+   */
+  CairoContext_();
+  virtual ~CairoContext_();
+
+  /**
+   * Set/Get original cairo_t, the context is referenced while wrapped
+   */
+  cairo_t *get_instance();
+  void set_instance(cairo_t *cr);
+
+  void save();
+  void restore();
+
+  void set_source_rgb(Php::Parameters &parameters);
+  void set_source_rgba(Php::Parameters &parameters);
+  void set_line_width(Php::Parameters &parameters);
+  Php::Value get_line_width();
+  void set_line_cap(Php::Parameters &parameters);
+  void set_line_join(Php::Parameters &parameters);
+  void set_dash(Php::Parameters &parameters);
+  void set_antialias(Php::Parameters &parameters);
+
+  void new_path();
+  void new_sub_path();
+  void close_path();
+  void move_to(Php::Parameters &parameters);
+  void line_to(Php::Parameters &parameters);
+  void rel_move_to(Php::Parameters &parameters);
+  void rel_line_to(Php::Parameters &parameters);
+  void curve_to(Php::Parameters &parameters);
+  void arc(Php::Parameters &parameters);
+  void rectangle(Php::Parameters &parameters);
+
+  void stroke();
+  void stroke_preserve();
+  void fill();
+  void fill_preserve();
+  void paint();
+  void paint_with_alpha(Php::Parameters &parameters);
+  void clip();
+  void reset_clip();
+  Php::Value clip_extents();
+
+  void translate(Php::Parameters &parameters);
+  void scale(Php::Parameters &parameters);
+  void rotate(Php::Parameters &parameters);
+  void identity_matrix();
+
+  void select_font_face(Php::Parameters &parameters);
+  void set_font_size(Php::Parameters &parameters);
+  void show_text(Php::Parameters &parameters);
+
+  /**
+   * Batched path commands, one PHP call for the whole list
+   *
+   * Points are given as [[x, y], ...] or as a flat [x0, y0, x1, y1, ...] list
+   */
+  void draw_polyline(Php::Parameters &parameters);
+  void fill_rects(Php::Parameters &parameters);
+  void stroke_rects(Php::Parameters &parameters);
+};
+
+/**
+ * Read the cairo_t from a CairoContext, or from the legacy GdkEvent carrier
+ */
+bool phpgtk_is_cairo_context(const Php::Value &value);
+cairo_t *phpgtk_get_cairo_context(const Php::Value &value);
+
+#endif
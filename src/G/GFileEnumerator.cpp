@@ -0,0 +1,378 @@
+#include "GFileEnumerator.h"
+#include "../Gtk/GtkListStore.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * Fields that can be mapped to store columns
+ */
+enum phpgtk_enumerate_field {
+  PHPGTK_FIELD_NAME,
+  PHPGTK_FIELD_DISPLAY_NAME,
+  PHPGTK_FIELD_TYPE,
+  PHPGTK_FIELD_SIZE,
+  PHPGTK_FIELD_MTIME,
+  PHPGTK_FIELD_CONTENT_TYPE,
+  PHPGTK_FIELD_IS_HIDDEN,
+};
+
+static const struct {
+  const char *name;
+  const char *attribute;
+} phpgtk_enumerate_fields[] = {
+    {"name", G_FILE_ATTRIBUTE_STANDARD_NAME},
+    {"display_name", G_FILE_ATTRIBUTE_STANDARD_DISPLAY_NAME},
+    {"type", G_FILE_ATTRIBUTE_STANDARD_TYPE},
+    {"size", G_FILE_ATTRIBUTE_STANDARD_SIZE},
+    {"mtime", G_FILE_ATTRIBUTE_TIME_MODIFIED},
+    {"content_type", G_FILE_ATTRIBUTE_STANDARD_FAST_CONTENT_TYPE},
+    {"is_hidden", G_FILE_ATTRIBUTE_STANDARD_IS_HIDDEN},
+};
+
+/**
+ * State shared by the PHP object and the pending async operation, each of them holds a ref
+ */
+struct GFileEnumerator_::st_enumerate {
+  int refs{1};
+
+  GFile *file{};
+  GCancellable *cancellable{};
+  GFileEnumerator *enumerator{};
+  GtkListStore *store{};
+
+  std::vector<phpgtk_enumerate_field> fields;
+  std::vector<gint> columns;
+  std::string attributes;
+
+  Php::Value self;
+  Php::Value progress_callback;
+  Php::Value done_callback;
+
+  int batch_size{500};
+  int loaded{};
+  bool loading{};
+};
+
+typedef GFileEnumerator_::st_enumerate st_enumerate_state;
+
+static void phpgtk_enumerate_unref(st_enumerate_state *state) {
+  if (--state->refs > 0) {
+    return;
+  }
+
+  if (state->enumerator != nullptr) {
+    g_object_unref(state->enumerator);
+  }
+
+  if (state->store != nullptr) {
+    g_object_unref(state->store);
+  }
+
+  if (state->cancellable != nullptr) {
+    g_object_unref(state->cancellable);
+  }
+
+  if (state->file != nullptr) {
+    g_object_unref(state->file);
+  }
+
+  delete state;
+}
+
+/**
+ * End of the listing, release the store and the self reference, then report
+ */
+static void phpgtk_enumerate_finish(st_enumerate_state *state, GError *error) {
+  state->loading = false;
+
+  if (state->enumerator != nullptr) {
+    g_file_enumerator_close_async(state->enumerator, G_PRIORITY_DEFAULT, nullptr, nullptr, nullptr);
+    g_object_unref(state->enumerator);
+    state->enumerator = nullptr;
+  }
+
+  if (state->store != nullptr) {
+    g_object_unref(state->store);
+    state->store = nullptr;
+  }
+
+  Php::Value self = state->self;
+  state->self = nullptr;
+
+  if (state->done_callback.isCallable()) {
+    Php::Value internal_parameters;
+    internal_parameters[0] = self;
+    internal_parameters[1] = state->loaded;
+    internal_parameters[2] = (error != nullptr) ? Php::Value(error->message) : Php::Value(nullptr);
+
+    try {
+      Php::call("call_user_func_array", state->done_callback, internal_parameters);
+    } catch (Php::Exception &exception) {
+      // Re-throw to let PHP-CPP handle the exception properly
+      throw;
+    }
+  }
+}
+
+/**
+ * Read one field of a GFileInfo into its natural GValue
+ */
+static void phpgtk_enumerate_field_value(GFileInfo *info, phpgtk_enumerate_field field,
+                                         GValue *value) {
+  switch (field) {
+    case PHPGTK_FIELD_NAME:
+      g_value_init(value, G_TYPE_STRING);
+      g_value_set_string(value, g_file_info_get_name(info));
+      break;
+
+    case PHPGTK_FIELD_DISPLAY_NAME:
+      g_value_init(value, G_TYPE_STRING);
+      g_value_set_string(value, g_file_info_get_display_name(info));
+      break;
+
+    case PHPGTK_FIELD_TYPE:
+      g_value_init(value, G_TYPE_INT);
+      g_value_set_int(value, g_file_info_get_file_type(info));
+      break;
+
+    case PHPGTK_FIELD_SIZE:
+      g_value_init(value, G_TYPE_INT64);
+      g_value_set_int64(value, g_file_info_get_size(info));
+      break;
+
+    case PHPGTK_FIELD_MTIME:
+      g_value_init(value, G_TYPE_INT64);
+      g_value_set_int64(
+          value, (gint64)g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_MODIFIED));
+      break;
+
+    case PHPGTK_FIELD_CONTENT_TYPE:
+      g_value_init(value, G_TYPE_STRING);
+      g_value_set_string(value, g_file_info_get_attribute_string(
+                                    info, G_FILE_ATTRIBUTE_STANDARD_FAST_CONTENT_TYPE));
+      break;
+
+    case PHPGTK_FIELD_IS_HIDDEN:
+      g_value_init(value, G_TYPE_BOOLEAN);
+      g_value_set_boolean(value, g_file_info_get_is_hidden(info));
+      break;
+  }
+}
+
+/**
+ * Append one batch to the store, converting each field to its column type
+ */
+static void phpgtk_enumerate_append(st_enumerate_state *state, GList *infos) {
+  size_t n_columns = state->columns.size();
+  std::vector<GValue> values(n_columns);
+  GtkTreeModel *model = GTK_TREE_MODEL(state->store);
+
+  for (GList *item = infos; item != nullptr; item = item->next) {
+    GFileInfo *info = G_FILE_INFO(item->data);
+
+    for (size_t i = 0; i < n_columns; i++) {
+      GValue natural = G_VALUE_INIT;
+      phpgtk_enumerate_field_value(info, state->fields[i], &natural);
+
+      GType column_type = gtk_tree_model_get_column_type(model, state->columns[i]);
+      memset(&values[i], 0, sizeof(GValue));
+      g_value_init(&values[i], column_type);
+      if (!g_value_transform(&natural, &values[i])) {
+        g_value_unset(&values[i]);
+        g_value_init(&values[i], column_type);
+      }
+
+      g_value_unset(&natural);
+    }
+
+    gtk_list_store_insert_with_valuesv(state->store, nullptr, -1, state->columns.data(),
+                                       values.data(), (gint)n_columns);
+
+    for (size_t i = 0; i < n_columns; i++) {
+      g_value_unset(&values[i]);
+    }
+
+    state->loaded++;
+  }
+}
+
+static void phpgtk_enumerate_next_ready(GObject *source, GAsyncResult *result, gpointer data);
+
+static void phpgtk_enumerate_next(st_enumerate_state *state) {
+  state->refs++;
+  g_file_enumerator_next_files_async(state->enumerator, state->batch_size, G_PRIORITY_DEFAULT,
+                                     state->cancellable, phpgtk_enumerate_next_ready, state);
+}
+
+static void phpgtk_enumerate_next_ready(GObject *source, GAsyncResult *result, gpointer data) {
+  st_enumerate_state *state = (st_enumerate_state *)data;
+
+  GError *error = nullptr;
+  GList *infos = g_file_enumerator_next_files_finish(G_FILE_ENUMERATOR(source), result, &error);
+
+  if (error != nullptr || infos == nullptr) {
+    phpgtk_enumerate_finish(state, error);
+    if (error != nullptr) {
+      g_error_free(error);
+    }
+    phpgtk_enumerate_unref(state);
+    return;
+  }
+
+  phpgtk_enumerate_append(state, infos);
+  g_list_free_full(infos, g_object_unref);
+
+  // Ask for the next batch first, so GIO works while PHP handles the progress
+  phpgtk_enumerate_next(state);
+
+  if (state->progress_callback.isCallable()) {
+    Php::Value internal_parameters;
+    internal_parameters[0] = state->self;
+    internal_parameters[1] = state->loaded;
+
+    try {
+      Php::call("call_user_func_array", state->progress_callback, internal_parameters);
+    } catch (Php::Exception &exception) {
+      // Re-throw to let PHP-CPP handle the exception properly
+      throw;
+    }
+  }
+
+  phpgtk_enumerate_unref(state);
+}
+
+static void phpgtk_enumerate_children_ready(GObject *source, GAsyncResult *result,
+                                            gpointer data) {
+  st_enumerate_state *state = (st_enumerate_state *)data;
+
+  GError *error = nullptr;
+  state->enumerator = g_file_enumerate_children_finish(G_FILE(source), result, &error);
+
+  if (state->enumerator == nullptr) {
+    phpgtk_enumerate_finish(state, error);
+    if (error != nullptr) {
+      g_error_free(error);
+    }
+  } else {
+    phpgtk_enumerate_next(state);
+  }
+
+  phpgtk_enumerate_unref(state);
+}
+
+/**
+ * Constructor
+ */
+GFileEnumerator_::GFileEnumerator_() = default;
+
+/**
+ * Destructor
+ */
+GFileEnumerator_::~GFileEnumerator_() {
+  if (state != nullptr) {
+    phpgtk_enumerate_unref(state);
+  }
+}
+
+void GFileEnumerator_::__construct(Php::Parameters &parameters) {
+  std::string s_path = parameters[0];
+
+  state = new st_enumerate();
+  state->file = g_file_new_for_path(s_path.c_str());
+}
+
+void GFileEnumerator_::set_batch_size(Php::Parameters &parameters) {
+  int batch_size = parameters[0];
+  if (batch_size < 1) {
+    throw Php::Exception("GFileEnumerator::set_batch_size expects a positive number");
+  }
+
+  state->batch_size = batch_size;
+}
+
+void GFileEnumerator_::load_into(Php::Parameters &parameters) {
+  if (state->loading) {
+    throw Php::Exception("GFileEnumerator::load_into: a listing is already running");
+  }
+
+  if (parameters.size() < 2 || !parameters[0].instanceOf("GtkListStore") ||
+      !parameters[1].isArray()) {
+    throw Php::Exception("GFileEnumerator::load_into expects a GtkListStore and a columns array");
+  }
+
+  GtkListStore_ *phpgtk_store = (GtkListStore_ *)parameters[0].implementation();
+  GtkTreeModel *model = phpgtk_store->get_model();
+  gint n_columns = gtk_tree_model_get_n_columns(model);
+
+  // Resolve the columns mapping once, entries are then appended without touching PHP
+  state->fields.clear();
+  state->columns.clear();
+  state->attributes.clear();
+
+  Php::Value columns = parameters[1];
+  for (auto &iter : columns) {
+    std::string s_field = iter.first.stringValue();
+    gint column = (gint)iter.second.numericValue();
+
+    size_t field = 0;
+    size_t n_fields = sizeof(phpgtk_enumerate_fields) / sizeof(phpgtk_enumerate_fields[0]);
+    while (field < n_fields && s_field != phpgtk_enumerate_fields[field].name) {
+      field++;
+    }
+
+    if (field == n_fields) {
+      throw Php::Exception("GFileEnumerator::load_into: unknown field " + s_field);
+    }
+
+    if (column < 0 || column >= n_columns) {
+      throw Php::Exception("GFileEnumerator::load_into: invalid column for field " + s_field);
+    }
+
+    state->fields.push_back((phpgtk_enumerate_field)field);
+    state->columns.push_back(column);
+
+    if (!state->attributes.empty()) {
+      state->attributes += ",";
+    }
+    state->attributes += phpgtk_enumerate_fields[field].attribute;
+  }
+
+  if (state->columns.empty()) {
+    throw Php::Exception("GFileEnumerator::load_into: no columns given");
+  }
+
+  if (parameters.size() > 2) {
+    state->progress_callback = parameters[2];
+  }
+
+  if (parameters.size() > 3) {
+    state->done_callback = parameters[3];
+  }
+
+  if (state->cancellable != nullptr) {
+    g_object_unref(state->cancellable);
+  }
+  state->cancellable = g_cancellable_new();
+
+  state->store = GTK_LIST_STORE(g_object_ref(model));
+  state->self = Php::Object("GFileEnumerator", this);
+  state->loaded = 0;
+  state->loading = true;
+
+  state->refs++;
+  g_file_enumerate_children_async(state->file, state->attributes.c_str(),
+                                  G_FILE_QUERY_INFO_NONE, G_PRIORITY_DEFAULT, state->cancellable,
+                                  phpgtk_enumerate_children_ready, state);
+}
+
+void GFileEnumerator_::cancel() {
+  if (state->loading) {
+    g_cancellable_cancel(state->cancellable);
+  }
+}
+
+Php::Value GFileEnumerator_::is_loading() {
+  return state->loading;
+}
@@ -0,0 +1,65 @@
+#ifndef _PHPGTK_GFILEENUMERATOR_H_
+#define _PHPGTK_GFILEENUMERATOR_H_
+
+#include <phpcpp.h>
+#include <gtk/gtk.h>
+#include <gio/gio.h>
+
+/**
+ * GFileEnumerator_
+ *
+ * Asynchronous listing of a directory, appended in batches to a GtkListStore without any PHP call
+ * per entry. Not a GObject wrapper: a native enumerator only exists while a listing runs
+ *
+ * https://docs.gtk.org/gio/class.FileEnumerator.html
+ */
+class GFileEnumerator_ : public Php::Base {
+  /**
+   * Publics
+   */
+ public:
+  /**
+   * Shared with the async callbacks, defined in GFileEnumerator.cpp
+   */
+  struct st_enumerate;
+
+  /**
+   * Privates
+   */
+ private:
+  st_enumerate *state{};
+
+  /**
+   * Publics
+   */
+ public:
+  /**
+   *  C++ constructor and destructor
+   */
+  GFileEnumerator_();
+  ~GFileEnumerator_();
+
+  /**
+   * new GFileEnumerator(string $path)
+   */
+  void __construct(Php::Parameters &parameters);
+
+  /**
+   * Number of entries requested from GIO per batch, default 500
+   */
+  void set_batch_size(Php::Parameters &parameters);
+
+  /**
+   * load_into(GtkListStore $store, array $columns [, callable $progress [, callable $done]])
+   *
+   * $columns maps a field to a store column: name, display_name, type, size, mtime, content_type,
+   * is_hidden. Values are converted to the column type. $progress($enumerator, $loaded) runs after
+   * each batch and $done($enumerator, $loaded, $error) at the end, $error being null on success
+   */
+  void load_into(Php::Parameters &parameters);
+
+  void cancel();
+  Php::Value is_loading();
+};
+
+#endif
@@ -0,0 +1,189 @@
+#include "GFileMonitor.h"
+
+/**
+ * Marks an event merged away, like a file created then deleted inside the same window
+ */
+#define PHPGTK_MONITOR_EVENT_DROPPED -1
+
+/**
+ * Constructor
+ */
+GFileMonitor_::GFileMonitor_() = default;
+
+/**
+ * Destructor
+ */
+GFileMonitor_::~GFileMonitor_() {
+  release();
+
+  if (instance != nullptr) {
+    g_object_unref(instance);
+  }
+}
+
+/**
+ * Stop the delivery, the native monitor stays referenced until the destructor so the inherited
+ * GObject methods keep a valid instance
+ */
+void GFileMonitor_::release() {
+  if (flush_source != 0) {
+    g_source_remove(flush_source);
+    flush_source = 0;
+  }
+
+  if (instance == nullptr) {
+    return;
+  }
+
+  if (changed_handler != 0) {
+    g_signal_handler_disconnect(instance, changed_handler);
+    changed_handler = 0;
+  }
+
+  g_file_monitor_cancel(G_FILE_MONITOR(instance));
+}
+
+void GFileMonitor_::__construct(Php::Parameters &parameters) {
+  std::string s_path = parameters[0];
+
+  int flags = G_FILE_MONITOR_WATCH_MOVES;
+  if (parameters.size() > 1) {
+    flags = parameters[1];
+  }
+
+  GFile *file = g_file_new_for_path(s_path.c_str());
+
+  GError *error = nullptr;
+  GFileMonitor *monitor = g_file_monitor(file, (GFileMonitorFlags)flags, nullptr, &error);
+  g_object_unref(file);
+
+  if (monitor == nullptr) {
+    std::string message = (error != nullptr) ? error->message : "unknown error";
+    if (error != nullptr) {
+      g_error_free(error);
+    }
+    throw Php::Exception("GFileMonitor::__construct: " + message);
+  }
+
+  instance = (gpointer *)monitor;
+  changed_handler = g_signal_connect(monitor, "changed", G_CALLBACK(changed_callback), this);
+}
+
+void GFileMonitor_::set_callback(Php::Parameters &parameters) {
+  callback = parameters[0];
+}
+
+void GFileMonitor_::set_coalesce_interval(Php::Parameters &parameters) {
+  int interval = parameters[0];
+  if (interval < 0) {
+    throw Php::Exception("GFileMonitor::set_coalesce_interval expects a positive number");
+  }
+
+  coalesce_ms = interval;
+}
+
+void GFileMonitor_::cancel() {
+  release();
+  pending.clear();
+  pending_index.clear();
+}
+
+Php::Value GFileMonitor_::is_cancelled() {
+  return instance == nullptr || g_file_monitor_is_cancelled(G_FILE_MONITOR(instance));
+}
+
+/**
+ * Queue the event, merging it with the one already pending for the same path
+ */
+void GFileMonitor_::changed_callback(GFileMonitor *monitor, GFile *file, GFile *other_file,
+                                     GFileMonitorEvent event_type, gpointer user_data) {
+  GFileMonitor_ *self = (GFileMonitor_ *)user_data;
+
+  gchar *path = g_file_get_path(file);
+  gchar *other_path = (other_file != nullptr) ? g_file_get_path(other_file) : nullptr;
+  std::string s_path = (path != nullptr) ? path : "";
+  std::string s_other_path = (other_path != nullptr) ? other_path : "";
+  g_free(path);
+  g_free(other_path);
+
+  int event = event_type;
+  auto found = self->pending_index.find(s_path);
+
+  if (found == self->pending_index.end()) {
+    self->pending_index[s_path] = self->pending.size();
+    self->pending.push_back({s_path, s_other_path, event});
+  } else {
+    st_event &previous = self->pending[found->second];
+
+    if (previous.event == G_FILE_MONITOR_EVENT_CREATED && event == G_FILE_MONITOR_EVENT_DELETED) {
+      // Never seen by PHP, nothing to report
+      previous.event = PHPGTK_MONITOR_EVENT_DROPPED;
+      self->pending_index.erase(found);
+    } else if (previous.event == G_FILE_MONITOR_EVENT_CREATED &&
+               (event == G_FILE_MONITOR_EVENT_CHANGED ||
+                event == G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT ||
+                event == G_FILE_MONITOR_EVENT_ATTRIBUTE_CHANGED)) {
+      // Still a creation for PHP
+    } else if (previous.event == G_FILE_MONITOR_EVENT_DELETED &&
+               event == G_FILE_MONITOR_EVENT_CREATED) {
+      previous.event = G_FILE_MONITOR_EVENT_CHANGED;
+    } else if (event == G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT) {
+      // Adds nothing to the pending event
+    } else {
+      previous.event = event;
+      previous.other_path = s_other_path;
+    }
+  }
+
+  if (self->flush_source == 0) {
+    self->flush_source = g_timeout_add(self->coalesce_ms, flush_callback, self);
+  }
+}
+
+/**
+ * Deliver the coalesced events in one call
+ */
+gboolean GFileMonitor_::flush_callback(gpointer user_data) {
+  GFileMonitor_ *self = (GFileMonitor_ *)user_data;
+  self->flush_source = 0;
+
+  std::vector<st_event> events;
+  events.swap(self->pending);
+  self->pending_index.clear();
+
+  if (!self->callback.isCallable()) {
+    return G_SOURCE_REMOVE;
+  }
+
+  Php::Value php_events;
+  int n_events = 0;
+  for (auto &event : events) {
+    if (event.event == PHPGTK_MONITOR_EVENT_DROPPED) {
+      continue;
+    }
+
+    Php::Value php_event;
+    php_event["path"] = event.path;
+    php_event["other_path"] = event.other_path.empty() ? Php::Value(nullptr)
+                                                       : Php::Value(event.other_path);
+    php_event["event"] = event.event;
+    php_events[n_events++] = php_event;
+  }
+
+  if (n_events == 0) {
+    return G_SOURCE_REMOVE;
+  }
+
+  Php::Value internal_parameters;
+  internal_parameters[0] = Php::Object("GFileMonitor", self);
+  internal_parameters[1] = php_events;
+
+  try {
+    Php::call("call_user_func_array", self->callback, internal_parameters);
+  } catch (Php::Exception &exception) {
+    // Re-throw to let PHP-CPP handle the exception properly
+    throw;
+  }
+
+  return G_SOURCE_REMOVE;
+}
@@ -0,0 +1,76 @@
+#ifndef _PHPGTK_GFILEMONITOR_H_
+#define _PHPGTK_GFILEMONITOR_H_
+
+#include <phpcpp.h>
+#include <gtk/gtk.h>
+#include <gio/gio.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "GObject.h"
+
+/**
+ * GFileMonitor_
+ *
+ * Watches a file or directory. Events are coalesced per path during a short window and
+ * delivered as one array, so bursts (a copy of thousands of files) cost one PHP call
+ *
+ * https://docs.gtk.org/gio/class.FileMonitor.html
+ */
+class GFileMonitor_ : public GObject_ {
+  /**
+   * Privates
+   */
+ private:
+  struct st_event {
+    std::string path;
+    std::string other_path;
+    int event;
+  };
+
+  gulong changed_handler{};
+  guint flush_source{};
+  guint coalesce_ms{200};
+  Php::Value callback;
+
+  std::vector<st_event> pending;
+  std::map<std::string, size_t> pending_index;
+
+  static void changed_callback(GFileMonitor *monitor, GFile *file, GFile *other_file,
+                               GFileMonitorEvent event_type, gpointer user_data);
+  static gboolean flush_callback(gpointer user_data);
+
+  void release();
+
+  /**
+   * Publics
+   */
+ public:
+  /**
+   *  C++ constructor and destructor
+   */
+  GFileMonitor_();
+  ~GFileMonitor_();
+
+  /**
+   * new GFileMonitor(string $path [, int $flags = GFileMonitor::WATCH_MOVES])
+   */
+  void __construct(Php::Parameters &parameters);
+
+  /**
+   * callback($monitor, array $events), each event being ['path', 'other_path', 'event']
+   */
+  void set_callback(Php::Parameters &parameters);
+
+  /**
+   * Window, in milliseconds, during which events are merged before delivery
+   */
+  void set_coalesce_interval(Php::Parameters &parameters);
+
+  void cancel();
+  Php::Value is_cancelled();
+};
+
+#endif
@@ -1,6 +1,10 @@
 
 #include <glib.h>
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "GObject.h"
 #include "../Gtk/GtkWidget.h"
 
@@ -9,19 +13,17 @@
 /**
  * Struct for callback gpointer
  */
-struct GObject_::st_callback {
-  Php::Value callback_name;
+struct GObject_::st_callback : public phpgtk_closure {
   Php::Array callback_params;
-  Php::Object self_widget;
-  Php::Parameters parameters;
-
-  guint signal_id;
-  const gchar *signal_name;
-  GType itype;
-  GSignalFlags signal_flags;
-  GType return_type;
-  guint n_params;
-  const GType *param_types;
+  std::vector<Php::Value> parameters;
+
+  guint signal_id{};
+  const gchar *signal_name{};
+  GType itype{};
+  GSignalFlags signal_flags{};
+  GType return_type{};
+  guint n_params{};
+  const GType *param_types{};
 };
 
 /**
@@ -87,34 +89,91 @@ Php::Value GObject_::connect(Php::Parameters &parameters) {
  * @todo Some events like the delete-event, dont pass gpointer param correctly
  */
 Php::Value GObject_::connect_internal(Php::Parameters &parameters, bool after) {
-  Php::Array callback_params = parameters;
-  Php::Value callback_event = callback_params[0];
-  Php::Value callback_name = callback_params[1];
+  phpgtk_string callback_event(parameters[0]);
+  Php::Value callback_name = parameters[1];
 
-  // Create gpoint param
-  struct st_callback *callback_object = (struct st_callback *)malloc(sizeof(struct st_callback));
-  memset(callback_object, 0, sizeof(struct st_callback));
-
-  // Add my internal parameters
-  callback_object->callback_name = callback_name;
-  callback_object->callback_params = callback_params;
   // Use the actual GObject type name instead of hardcoding "GtkWidget"
   // This prevents critical errors when calling widget-specific methods on non-widget GObjects
   const gchar *type_name =
       (instance && G_IS_OBJECT(instance)) ? g_type_name(G_TYPE_FROM_INSTANCE(instance)) : nullptr;
   std::string object_type = (type_name != nullptr) ? type_name : "GObject";
-  callback_object->self_widget = Php::Object(object_type.c_str(), this);
+  Php::Value self_widget = Php::Object(object_type.c_str(), this);
+
+  // Return handler id
+  return (int)connect_php_callback(instance, callback_event.c_str(), callback_name, self_widget,
+                                   parameters, after);
+}
+
+/**
+ * Signals already parsed, per type and interned detailed name like "notify::label"
+ */
+struct phpgtk_signal_entry {
+  guint signal_id;
+  GQuark detail;
+  GSignalQuery query;
+};
+
+static std::unordered_map<GType, std::unordered_map<const gchar *, phpgtk_signal_entry>>
+    phpgtk_signal_entries;
+
+/**
+ * Signal id, detail and query through the cache, nullptr when the type has no such signal
+ */
+static const phpgtk_signal_entry *phpgtk_lookup_signal(GType itype, const gchar *signal_name) {
+  std::unordered_map<const gchar *, phpgtk_signal_entry> &type_signals =
+      phpgtk_signal_entries[itype];
+
+  // A name never interned cannot be cached yet, look it up without interning it
+  GQuark quark = g_quark_try_string(signal_name);
+  if (quark != 0) {
+    auto found = type_signals.find(g_quark_to_string(quark));
+    if (found != type_signals.end()) {
+      return &found->second;
+    }
+  }
+
+  // Misses are not cached, g_signal_connect reports them each time
+  phpgtk_signal_entry entry;
+  memset(&entry, 0, sizeof(phpgtk_signal_entry));
+  if (!g_signal_parse_name(signal_name, itype, &entry.signal_id, &entry.detail, TRUE)) {
+    return nullptr;
+  }
+
+  // Detailed names are left without query, as g_signal_lookup always gave them
+  if (entry.detail == 0) {
+    g_signal_query(entry.signal_id, &entry.query);
+  }
+
+  // Only names of existing signals are interned, so the table stays bounded
+  return &(type_signals[g_intern_string(signal_name)] = entry);
+}
+
+gulong GObject_::connect_php_callback(gpointer instance, const gchar *signal_name,
+                                      const Php::Value &callback_name,
+                                      const Php::Value &self_widget,
+                                      const std::vector<Php::Value> &parameters, bool after) {
+  // Create gpoint param, released by destroy_notify
+  struct st_callback *callback_object = new st_callback();
+
+  // Add my internal parameters
+  callback_object->callback_name = callback_name;
+  callback_object->callback_params = Php::Array(parameters);
+  callback_object->self_widget = self_widget;
   callback_object->parameters = parameters;
 
   // Retriave and store signal query parameters , to be used on callback
   GSignalQuery signal_info;
+  memset(&signal_info, 0, sizeof(GSignalQuery));
 
+  const phpgtk_signal_entry *signal = nullptr;
   if (G_IS_OBJECT(instance)) {
-    g_signal_query(g_signal_lookup(callback_event, G_OBJECT_TYPE(instance)), &signal_info);
+    signal = phpgtk_lookup_signal(G_OBJECT_TYPE(instance), signal_name);
+  } else if (G_IS_OBJECT_CLASS(instance)) {
+    signal = phpgtk_lookup_signal(G_OBJECT_CLASS_TYPE(instance), signal_name);
   }
 
-  if (G_IS_OBJECT_CLASS(instance)) {
-    g_signal_query(g_signal_lookup(callback_event, G_OBJECT_CLASS_TYPE(instance)), &signal_info);
+  if (signal != nullptr) {
+    signal_info = signal->query;
   }
 
   callback_object->signal_id = signal_info.signal_id;
@@ -125,31 +184,29 @@ Php::Value GObject_::connect_internal(Php::Parameters &parameters, bool after) {
   callback_object->n_params = signal_info.n_params;
   callback_object->param_types = signal_info.param_types;
 
-  // Create the CPP callback
-  GClosure *closure;
-
-  // this method are removed, since leak memory does not happen anymore
-  // https://github.com/scorninpc/php-gtk3/issues/81
-  // closure = g_cclosure_new_swap (G_CALLBACK (connect_callback), callback_object,
-  // (GClosureNotify)destroy_notify);
+  // Create the CPP callback, the state is now allocated with new, so it can be deleted when the
+  // closure is finalized (https://github.com/scorninpc/php-gtk3/issues/81)
+  GClosure *closure = g_cclosure_new_swap(G_CALLBACK(connect_callback), callback_object,
+                                          (GClosureNotify)destroy_notify);
 
-  closure = g_cclosure_new_swap(G_CALLBACK(connect_callback), callback_object, nullptr);
-  int ret = g_signal_connect_closure(instance, callback_event, closure, after);
+  // Known signals connect by id, no parsing of the name again
+  if (signal != nullptr) {
+    return g_signal_connect_closure_by_id(instance, signal->signal_id, signal->detail, closure,
+                                          after);
+  }
 
-  // Return handler id
-  return ret;
+  return g_signal_connect_closure(instance, signal_name, closure, after);
 }
 
 /**
- * this method are removed, since leak memory does not happen anymore
- * https://github.com/scorninpc/php-gtk3/issues/81
+ * Release the callback state when the closure is finalized
  */
 void GObject_::destroy_notify(gpointer user_data, GClosure *closure) {
-  // return to st_callback
-  struct st_callback *callback_object = (struct st_callback *)user_data;
+  phpgtk_closure::closure_notify(user_data, closure);
+}
 
-  // delete references;
-  delete callback_object;
+Php::Value GObject_::debug_live_closures() {
+  return (int)phpgtk_closure::live_count();
 }
 
 /**
@@ -239,6 +296,18 @@ bool GObject_::connect_callback(gpointer user_data, ...) {
       case G_TYPE_BOXED: {
         // Php::call("var_dump", "boxed");
 
+        // cairo_t of the "draw" signal
+        if ((callback_object->param_types[i] & ~G_SIGNAL_TYPE_STATIC_SCOPE) ==
+            CAIRO_GOBJECT_TYPE_CONTEXT) {
+          cairo_t *cr = va_arg(ap, cairo_t *);
+
+          CairoContext_ *cairo_ = new CairoContext_();
+          cairo_->set_instance(cr);
+          internal_parameters[i + 1] = Php::Object("CairoContext", cairo_);
+
+          break;
+        }
+
         GdkEvent *e = va_arg(ap, GdkEvent *);
 
         // Create event from callback
@@ -269,6 +338,7 @@ bool GObject_::connect_callback(gpointer user_data, ...) {
   // Wrap in try-catch to properly handle exceptions from PHP callbacks
   // This ensures exceptions work correctly even with Xdebug exception breakpoints enabled
   try {
+    phpgtk_profile_scope profile_scope(callback_object, callback_object->signal_name);
     Php::Value ret =
         Php::call("call_user_func_array", callback_object->callback_name, internal_parameters);
     return ret;
@@ -351,8 +421,8 @@ Php::Value GObject_::is_connected(Php::Parameters &parameters) {
 }
 
 Php::Value GObject_::get_property(Php::Parameters &parameters) {
-  std::string s_property_name = parameters[0];
-  gchar *property_name = (gchar *)s_property_name.c_str();
+  phpgtk_string s_property_name(parameters[0]);
+  const gchar *property_name = s_property_name.c_str();
 
   GValue gvalue = {0};
   g_value_init(&gvalue, G_TYPE_OBJECT);
@@ -363,8 +433,8 @@ Php::Value GObject_::get_property(Php::Parameters &parameters) {
 }
 
 void GObject_::set_property(Php::Parameters &parameters) {
-  std::string s_property_name = parameters[0];
-  const gchar *property_name = (const gchar *)s_property_name.c_str();
+  phpgtk_string s_property_name(parameters[0]);
+  const gchar *property_name = s_property_name.c_str();
 
   // get interface of instance
   gpointer iface = g_type_default_interface_peek(G_OBJECT_TYPE(instance));
@@ -377,7 +447,7 @@ void GObject_::set_property(Php::Parameters &parameters) {
     g_object_set(G_OBJECT(instance), "model", o_object->get_model(), (char *)nullptr);
   } else {
     // get the property spec
-    GParamSpec *prop = g_object_class_find_property(G_OBJECT_GET_CLASS(instance), property_name);
+    GParamSpec *prop = phpgtk_lookup_property(G_OBJECT(instance), property_name);
     if (!prop) {
       std::string error;
       throw Php::Exception(error + "there is no property " + property_name + " on object " +
@@ -390,6 +460,348 @@ void GObject_::set_property(Php::Parameters &parameters) {
   }
 }
 
+/**
+ * Property specs already resolved, per class and interned property name. Specs are owned by their
+ * class and live as long as the type, so they are never released. Only found properties are
+ * cached and interned, names coming from PHP would otherwise grow both without bound
+ */
+static std::unordered_map<GType, std::unordered_map<const gchar *, GParamSpec *>>
+    phpgtk_property_specs;
+
+GParamSpec *phpgtk_lookup_property(GObject *object, const gchar *property_name) {
+  std::unordered_map<const gchar *, GParamSpec *> &class_specs =
+      phpgtk_property_specs[G_OBJECT_TYPE(object)];
+
+  GQuark quark = g_quark_try_string(property_name);
+  if (quark != 0) {
+    auto found = class_specs.find(g_quark_to_string(quark));
+    if (found != class_specs.end()) {
+      return found->second;
+    }
+  }
+
+  GParamSpec *spec = g_object_class_find_property(G_OBJECT_GET_CLASS(object), property_name);
+  if (spec != nullptr) {
+    class_specs[g_intern_string(property_name)] = spec;
+  }
+
+  return spec;
+}
+
+static GParamSpec *phpgtk_find_property(GObject *object, const gchar *property_name) {
+  GParamSpec *spec = phpgtk_lookup_property(object, property_name);
+  if (spec == nullptr) {
+    std::string error;
+    throw Php::Exception(error + "there is no property " + property_name + " on object " +
+                         g_type_name(G_OBJECT_TYPE(object)));
+  }
+
+  return spec;
+}
+
+/**
+ * Whether set_properties() and get_properties() convert values of this type. Boxed types are
+ * limited to GdkRGBA and string arrays, both directions fail alike for the others
+ */
+static bool phpgtk_property_type_supported(GType value_type) {
+  switch (G_TYPE_FUNDAMENTAL(value_type)) {
+    case G_TYPE_BOOLEAN:
+    case G_TYPE_CHAR:
+    case G_TYPE_UCHAR:
+    case G_TYPE_INT:
+    case G_TYPE_UINT:
+    case G_TYPE_LONG:
+    case G_TYPE_ULONG:
+    case G_TYPE_INT64:
+    case G_TYPE_UINT64:
+    case G_TYPE_FLOAT:
+    case G_TYPE_DOUBLE:
+    case G_TYPE_ENUM:
+    case G_TYPE_FLAGS:
+    case G_TYPE_STRING:
+    case G_TYPE_OBJECT:
+    case G_TYPE_INTERFACE:
+      return true;
+    case G_TYPE_BOXED:
+      return value_type == GDK_TYPE_RGBA || value_type == G_TYPE_STRV;
+  }
+
+  return false;
+}
+
+static void phpgtk_property_check_type(GParamSpec *spec) {
+  if (!phpgtk_property_type_supported(spec->value_type)) {
+    throw Php::Exception(std::string("property ") + spec->name + " of type " +
+                         g_type_name(spec->value_type) + " is not supported");
+  }
+}
+
+/**
+ * Convert a PHP value to the exact type of the property
+ */
+static void phpgtk_property_to_gvalue(const Php::Value &php_value, GParamSpec *spec,
+                                      GValue *value) {
+  GType value_type = spec->value_type;
+  phpgtk_property_check_type(spec);
+  g_value_init(value, value_type);
+
+  switch (G_TYPE_FUNDAMENTAL(value_type)) {
+    case G_TYPE_BOOLEAN:
+      g_value_set_boolean(value, php_value.boolValue());
+      break;
+    case G_TYPE_CHAR:
+      g_value_set_schar(value, (gint8)php_value.numericValue());
+      break;
+    case G_TYPE_UCHAR:
+      g_value_set_uchar(value, (guchar)php_value.numericValue());
+      break;
+    case G_TYPE_INT:
+      g_value_set_int(value, (gint)php_value.numericValue());
+      break;
+    case G_TYPE_UINT:
+      g_value_set_uint(value, (guint)php_value.numericValue());
+      break;
+    case G_TYPE_LONG:
+      g_value_set_long(value, (glong)php_value.numericValue());
+      break;
+    case G_TYPE_ULONG:
+      g_value_set_ulong(value, (gulong)php_value.numericValue());
+      break;
+    case G_TYPE_INT64:
+      g_value_set_int64(value, (gint64)php_value.numericValue());
+      break;
+    case G_TYPE_UINT64:
+      g_value_set_uint64(value, (guint64)php_value.numericValue());
+      break;
+    case G_TYPE_FLOAT:
+      g_value_set_float(value, (gfloat)php_value.floatValue());
+      break;
+    case G_TYPE_DOUBLE:
+      g_value_set_double(value, php_value.floatValue());
+      break;
+    case G_TYPE_ENUM:
+      g_value_set_enum(value, (gint)php_value.numericValue());
+      break;
+    case G_TYPE_FLAGS:
+      g_value_set_flags(value, (guint)php_value.numericValue());
+      break;
+    case G_TYPE_STRING:
+      if (php_value.isNull()) {
+        g_value_set_string(value, nullptr);
+      } else {
+        g_value_set_string(value, phpgtk_string(php_value).c_str());
+      }
+      break;
+    case G_TYPE_OBJECT:
+    case G_TYPE_INTERFACE: {
+      if (php_value.isNull()) {
+        break;
+      }
+
+      if (!php_value.instanceOf("GObject")) {
+        g_value_unset(value);
+        throw Php::Exception(std::string("property ") + spec->name + " expects an object");
+      }
+
+      // Tree models keep their pointer apart from instance
+      gpointer object;
+      if (php_value.instanceOf("GtkTreeModel")) {
+        object = ((GtkTreeModel_ *)php_value.implementation())->get_model();
+      } else {
+        object = ((GObject_ *)php_value.implementation())->get_instance();
+      }
+
+      if (object != nullptr && !g_type_is_a(G_OBJECT_TYPE(object), value_type)) {
+        g_value_unset(value);
+        throw Php::Exception(std::string("property ") + spec->name + " expects a " +
+                             g_type_name(value_type));
+      }
+
+      g_value_set_object(value, object);
+      break;
+    }
+    case G_TYPE_BOXED: {
+      if (php_value.isNull()) {
+        break;
+      }
+
+      if (value_type == GDK_TYPE_RGBA) {
+        if (!php_value.instanceOf("GdkRGBA")) {
+          g_value_unset(value);
+          throw Php::Exception(std::string("property ") + spec->name + " expects a GdkRGBA");
+        }
+
+        GdkRGBA rgba = ((GdkRGBA_ *)php_value.implementation())->get_instance();
+        g_value_set_boxed(value, &rgba);
+        break;
+      }
+
+      // G_TYPE_STRV
+      if (!php_value.isArray()) {
+        g_value_unset(value);
+        throw Php::Exception(std::string("property ") + spec->name + " expects an array");
+      }
+
+      std::vector<std::string> strings;
+      for (auto &iter : php_value) {
+        strings.push_back(iter.second.stringValue());
+      }
+
+      std::vector<const gchar *> strv;
+      for (auto &str : strings) {
+        strv.push_back(str.c_str());
+      }
+      strv.push_back(nullptr);
+
+      g_value_set_boxed(value, strv.data());
+      break;
+    }
+  }
+}
+
+Php::Value phpgtk_property_to_phpvalue(GValue *value) {
+  switch (G_TYPE_FUNDAMENTAL(G_VALUE_TYPE(value))) {
+    case G_TYPE_BOOLEAN:
+      return (bool)g_value_get_boolean(value);
+    case G_TYPE_CHAR:
+      return (int)g_value_get_schar(value);
+    case G_TYPE_UCHAR:
+      return (int)g_value_get_uchar(value);
+    case G_TYPE_INT:
+      return g_value_get_int(value);
+    case G_TYPE_UINT:
+      return (int64_t)g_value_get_uint(value);
+    case G_TYPE_LONG:
+      return (int64_t)g_value_get_long(value);
+    case G_TYPE_ULONG:
+      return (int64_t)g_value_get_ulong(value);
+    case G_TYPE_INT64:
+      return (int64_t)g_value_get_int64(value);
+    case G_TYPE_UINT64:
+      return (int64_t)g_value_get_uint64(value);
+    case G_TYPE_FLOAT:
+      return g_value_get_float(value);
+    case G_TYPE_DOUBLE:
+      return g_value_get_double(value);
+    case G_TYPE_ENUM:
+      return g_value_get_enum(value);
+    case G_TYPE_FLAGS:
+      return (int64_t)g_value_get_flags(value);
+    case G_TYPE_STRING: {
+      const gchar *str = g_value_get_string(value);
+      if (str == nullptr) {
+        return nullptr;
+      }
+      return str;
+    }
+    case G_TYPE_OBJECT:
+    case G_TYPE_INTERFACE: {
+      gpointer object = g_value_get_object(value);
+      if (object == nullptr) {
+        return nullptr;
+      }
+      return cobject_to_phpobject((gpointer *)object);
+    }
+    case G_TYPE_BOXED: {
+      gpointer boxed = g_value_get_boxed(value);
+      if (boxed == nullptr) {
+        return nullptr;
+      }
+
+      if (G_VALUE_TYPE(value) == GDK_TYPE_RGBA) {
+        GdkRGBA_ *return_parsed = new GdkRGBA_();
+        return_parsed->set_instance(*(GdkRGBA *)boxed);
+        return Php::Object("GdkRGBA", return_parsed);
+      }
+
+      if (G_VALUE_TYPE(value) == G_TYPE_STRV) {
+        Php::Array ret_arr;
+        gchar **strv = (gchar **)boxed;
+        for (int i = 0; strv[i] != nullptr; i++) {
+          ret_arr[i] = strv[i];
+        }
+        return ret_arr;
+      }
+      break;
+    }
+  }
+
+  return nullptr;
+}
+
+void GObject_::set_properties(Php::Parameters &parameters) {
+  if (parameters.empty() || !parameters[0].isArray()) {
+    throw Php::Exception("GObject::set_properties expects an array of name => value");
+  }
+
+  GObject *object = G_OBJECT(instance);
+  Php::Value properties = parameters[0];
+
+  // Resolve and convert every value first, a bad entry then leaves the object untouched
+  std::vector<GParamSpec *> specs;
+  std::vector<GValue> values;
+  specs.reserve(properties.size());
+  values.reserve(properties.size());
+
+  try {
+    for (auto &iter : properties) {
+      phpgtk_string property_name(iter.first);
+      GParamSpec *spec = phpgtk_find_property(object, property_name.c_str());
+
+      if (!(spec->flags & G_PARAM_WRITABLE) || (spec->flags & G_PARAM_CONSTRUCT_ONLY)) {
+        throw Php::Exception(std::string("property ") + spec->name + " is not writable");
+      }
+
+      GValue value = G_VALUE_INIT;
+      phpgtk_property_to_gvalue(iter.second, spec, &value);
+      specs.push_back(spec);
+      values.push_back(value);
+    }
+  } catch (Php::Exception &exception) {
+    for (auto &value : values) {
+      g_value_unset(&value);
+    }
+    throw;
+  }
+
+  // One notify per changed property, emitted after all values are set
+  g_object_freeze_notify(object);
+
+  for (size_t i = 0; i < specs.size(); i++) {
+    g_object_set_property(object, specs[i]->name, &values[i]);
+    g_value_unset(&values[i]);
+  }
+
+  g_object_thaw_notify(object);
+}
+
+Php::Value GObject_::get_properties(Php::Parameters &parameters) {
+  if (parameters.empty() || !parameters[0].isArray()) {
+    throw Php::Exception("GObject::get_properties expects an array of property names");
+  }
+
+  GObject *object = G_OBJECT(instance);
+  Php::Value names = parameters[0];
+  Php::Array ret_arr;
+
+  for (auto &iter : names) {
+    GParamSpec *spec = phpgtk_find_property(object, phpgtk_string(iter.second).c_str());
+
+    if (!(spec->flags & G_PARAM_READABLE)) {
+      throw Php::Exception(std::string("property ") + spec->name + " is not readable");
+    }
+    phpgtk_property_check_type(spec);
+
+    GValue value = G_VALUE_INIT;
+    g_value_init(&value, spec->value_type);
+    g_object_get_property(object, spec->name, &value);
+    ret_arr[iter.second] = phpgtk_property_to_phpvalue(&value);
+    g_value_unset(&value);
+  }
+
+  return ret_arr;
+}
+
 void GObject_::signal_handler_block(Php::Parameters &parameters) {
   double p_handler_id = parameters[0];
   gulong handler_id = (gulong)p_handler_id;
@@ -413,10 +825,9 @@ void GObject_::signal_handler_unblock(Php::Parameters &parameters) {
 }
 
 Php::Value GObject_::get_data(Php::Parameters &parameters) {
-  std::string s_key = parameters[0];
-  gchar *key = (gchar *)s_key.c_str();
+  phpgtk_string key(parameters[0]);
 
-  gpointer value = g_object_get_data(G_OBJECT(instance), key);
+  gpointer value = g_object_get_data(G_OBJECT(instance), key.c_str());
 
   // this will return the pointer, so if not a natural type, it's will crash
   return cobject_to_phpobject((gpointer *)value);
@@ -4,8 +4,15 @@
 
 #include <phpcpp.h>
 #include <iostream>
+#include <string>
+#include <vector>
 #include <gtk/gtk.h>
 
+#include "PhpClosure.h"
+#include "PhpProfiler.h"
+#include "PhpParam.h"
+#include "PhpString.h"
+
 /**
  *
  */
@@ -41,6 +48,18 @@ class GObject_ : public Php::Base {
   Php::Value connect(Php::Parameters &parameters);
   Php::Value connect_after(Php::Parameters &parameters);
 
+  /**
+   * Connect a PHP callable to a signal of a native instance
+   *
+   * Shared by connect() and the GtkBuilder autoconnect. The callback state is released by
+   * destroy_notify when the handler is disconnected or the instance finalized. Extra user
+   * parameters are taken from parameters[2..]
+   */
+  static gulong connect_php_callback(gpointer instance, const gchar *signal_name,
+                                     const Php::Value &callback_name,
+                                     const Php::Value &self_widget,
+                                     const std::vector<Php::Value> &parameters, bool after);
+
   /**
    * Class to abstract php callback for connect method, to call PHP function
    */
@@ -58,6 +77,18 @@ class GObject_ : public Php::Base {
 
   Php::Value get_property(Php::Parameters &parameters);
   void set_property(Php::Parameters &parameters);
+
+  /**
+   * Set or read several properties in one call
+   *
+   * set_properties(['label' => 'Ok', 'visible' => true]) converts every value first, so an
+   * invalid entry throws before any property is changed, then emits the notify signals once,
+   * after all values are applied. get_properties(['label', 'visible']) returns a name => value
+   * array. Boxed properties are supported for GdkRGBA and string arrays, both methods throw for
+   * other types. Property specs are looked up once per class and name
+   */
+  void set_properties(Php::Parameters &parameters);
+  Php::Value get_properties(Php::Parameters &parameters);
   void signal_handler_block(Php::Parameters &parameters);
   void signal_handler_unblock(Php::Parameters &parameters);
 
@@ -65,6 +96,21 @@ class GObject_ : public Php::Base {
   void set_data(Php::Parameters &parameters);
 
   void __clone();
+
+  /**
+   * Number of native callback states still alive, to spot leaked handlers
+   */
+  static Php::Value debug_live_closures();
 };
 
+/**
+ * Property spec by name through the per-class cache, nullptr when the class has no such property
+ */
+GParamSpec *phpgtk_lookup_property(GObject *object, const gchar *property_name);
+
+/**
+ * Convert a property value read with g_object_get_property, null for unsupported types
+ */
+Php::Value phpgtk_property_to_phpvalue(GValue *value);
+
 #endif
\ No newline at end of file
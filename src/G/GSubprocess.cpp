@@ -0,0 +1,466 @@
+#include "GSubprocess.h"
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+/**
+ * Size of each asynchronous read on the child pipes
+ */
+#define PHPGTK_SUBPROCESS_READ_SIZE 65536
+
+/**
+ * Longest line kept, output without a newline is delivered in chunks of this size
+ */
+#define PHPGTK_SUBPROCESS_MAX_LINE_LENGTH (1024 * 1024)
+
+/**
+ * One output pipe of the child
+ */
+struct st_subprocess_stream {
+  GInputStream *stream{};
+  std::string partial;
+  std::vector<std::string> lines;
+  bool reading{};
+  bool eof{true};
+};
+
+/**
+ * State shared by the PHP object and the pending async operations, each of them holds a ref
+ */
+struct GSubprocess_::st_subprocess {
+  int refs{1};
+
+  std::vector<std::string> argv;
+  std::string cwd;
+
+  GSubprocess *process{};
+  GCancellable *cancellable{};
+
+  Php::Value self;
+  Php::Value stdout_callback;
+  Php::Value stderr_callback;
+  Php::Value exit_callback;
+
+  st_subprocess_stream streams[2];
+  size_t max_pending_lines{10000};
+  guint flush_source{};
+
+  bool started{};
+  bool exited{};
+  bool exit_delivered{};
+  int exit_status{};
+  bool success{};
+};
+
+typedef GSubprocess_::st_subprocess st_subprocess_state;
+
+static void phpgtk_subprocess_unref(gpointer data) {
+  st_subprocess_state *state = (st_subprocess_state *)data;
+
+  if (--state->refs > 0) {
+    return;
+  }
+
+  for (auto &stream : state->streams) {
+    if (stream.stream != nullptr) {
+      g_object_unref(stream.stream);
+    }
+  }
+
+  if (state->cancellable != nullptr) {
+    g_object_unref(state->cancellable);
+  }
+
+  if (state->process != nullptr) {
+    g_object_unref(state->process);
+  }
+
+  delete state;
+}
+
+static void phpgtk_subprocess_read(st_subprocess_state *state, int index);
+static void phpgtk_subprocess_schedule_flush(st_subprocess_state *state);
+
+/**
+ * Deliver the exit status once the child is gone and all of its output was handed to PHP
+ */
+static void phpgtk_subprocess_maybe_finish(st_subprocess_state *state) {
+  if (!state->exited || state->exit_delivered) {
+    return;
+  }
+
+  for (auto &stream : state->streams) {
+    if (!stream.eof || stream.reading || !stream.lines.empty()) {
+      return;
+    }
+  }
+
+  state->exit_delivered = true;
+
+  // Drop the self reference now, the running process was keeping the PHP object alive
+  Php::Value self = state->self;
+  state->self = nullptr;
+
+  if (state->exit_callback.isCallable()) {
+    Php::Value internal_parameters;
+    internal_parameters[0] = self;
+    internal_parameters[1] = state->exit_status;
+    internal_parameters[2] = state->success;
+
+    try {
+      Php::call("call_user_func_array", state->exit_callback, internal_parameters);
+    } catch (Php::Exception &exception) {
+      // Re-throw to let PHP-CPP handle the exception properly
+      throw;
+    }
+  }
+}
+
+/**
+ * Hand the queued lines to PHP, once per main loop iteration
+ */
+static gboolean phpgtk_subprocess_flush(gpointer data) {
+  st_subprocess_state *state = (st_subprocess_state *)data;
+  state->flush_source = 0;
+
+  for (int index = 0; index < 2; index++) {
+    st_subprocess_stream &stream = state->streams[index];
+    if (stream.lines.empty()) {
+      continue;
+    }
+
+    // Hand at most max_pending_lines, reading stays paused until the queue is under the limit
+    std::vector<std::string> lines;
+    if (stream.lines.size() > state->max_pending_lines) {
+      auto end = stream.lines.begin() + state->max_pending_lines;
+      lines.assign(std::make_move_iterator(stream.lines.begin()), std::make_move_iterator(end));
+      stream.lines.erase(stream.lines.begin(), end);
+    } else {
+      lines.swap(stream.lines);
+    }
+
+    Php::Value callback = (index == 0) ? state->stdout_callback : state->stderr_callback;
+    if (!callback.isCallable()) {
+      continue;
+    }
+
+    Php::Value php_lines;
+    for (size_t i = 0; i < lines.size(); i++) {
+      php_lines[(int)i] = lines[i];
+    }
+
+    Php::Value internal_parameters;
+    internal_parameters[0] = state->self;
+    internal_parameters[1] = php_lines;
+
+    try {
+      Php::call("call_user_func_array", callback, internal_parameters);
+    } catch (Php::Exception &exception) {
+      // Re-throw to let PHP-CPP handle the exception properly
+      throw;
+    }
+  }
+
+  // Resume the reads paused by backpressure once their queue is under the limit, and come back
+  // for the lines left over
+  for (int index = 0; index < 2; index++) {
+    phpgtk_subprocess_read(state, index);
+    if (!state->streams[index].lines.empty()) {
+      phpgtk_subprocess_schedule_flush(state);
+    }
+  }
+
+  phpgtk_subprocess_maybe_finish(state);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void phpgtk_subprocess_schedule_flush(st_subprocess_state *state) {
+  if (state->flush_source != 0) {
+    return;
+  }
+
+  state->refs++;
+  state->flush_source = g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, phpgtk_subprocess_flush, state,
+                                        phpgtk_subprocess_unref);
+}
+
+/**
+ * Split what was read in lines, keeping the unterminated tail for the next read
+ */
+static void phpgtk_subprocess_split(st_subprocess_stream &stream, const char *data, gsize size) {
+  stream.partial.append(data, size);
+
+  size_t start = 0;
+  size_t newline;
+  while ((newline = stream.partial.find('\n', start)) != std::string::npos) {
+    size_t end = newline;
+    if (end > start && stream.partial[end - 1] == '\r') {
+      end--;
+    }
+
+    stream.lines.emplace_back(stream.partial, start, end - start);
+    start = newline + 1;
+  }
+
+  // Do not grow without bound on output that never ends a line
+  while (stream.partial.size() - start >= PHPGTK_SUBPROCESS_MAX_LINE_LENGTH) {
+    stream.lines.emplace_back(stream.partial, start, PHPGTK_SUBPROCESS_MAX_LINE_LENGTH);
+    start += PHPGTK_SUBPROCESS_MAX_LINE_LENGTH;
+  }
+
+  stream.partial.erase(0, start);
+}
+
+static void phpgtk_subprocess_read_ready(GObject *source, GAsyncResult *result, gpointer data) {
+  st_subprocess_state *state = (st_subprocess_state *)data;
+
+  int index = (source == G_OBJECT(state->streams[0].stream)) ? 0 : 1;
+  st_subprocess_stream &stream = state->streams[index];
+  stream.reading = false;
+
+  GError *error = nullptr;
+  GBytes *bytes = g_input_stream_read_bytes_finish(G_INPUT_STREAM(source), result, &error);
+
+  gsize size = 0;
+  const char *chunk = (bytes != nullptr) ? (const char *)g_bytes_get_data(bytes, &size) : nullptr;
+
+  if (error != nullptr || size == 0) {
+    // End of stream, or cancelled: flush the unterminated last line
+    stream.eof = true;
+    if (!stream.partial.empty()) {
+      stream.lines.push_back(stream.partial);
+      stream.partial.clear();
+    }
+
+    if (error != nullptr) {
+      g_error_free(error);
+    }
+  } else {
+    phpgtk_subprocess_split(stream, chunk, size);
+  }
+
+  if (bytes != nullptr) {
+    g_bytes_unref(bytes);
+  }
+
+  phpgtk_subprocess_schedule_flush(state);
+  phpgtk_subprocess_read(state, index);
+
+  phpgtk_subprocess_unref(state);
+}
+
+/**
+ * Issue the next read, unless the callback fell behind and the queue is full
+ */
+static void phpgtk_subprocess_read(st_subprocess_state *state, int index) {
+  st_subprocess_stream &stream = state->streams[index];
+
+  if (stream.eof || stream.reading || stream.lines.size() >= state->max_pending_lines) {
+    return;
+  }
+
+  stream.reading = true;
+  state->refs++;
+  g_input_stream_read_bytes_async(stream.stream, PHPGTK_SUBPROCESS_READ_SIZE, G_PRIORITY_DEFAULT,
+                                  state->cancellable, phpgtk_subprocess_read_ready, state);
+}
+
+static void phpgtk_subprocess_wait_ready(GObject *source, GAsyncResult *result, gpointer data) {
+  st_subprocess_state *state = (st_subprocess_state *)data;
+  GSubprocess *process = G_SUBPROCESS(source);
+
+  GError *error = nullptr;
+  g_subprocess_wait_finish(process, result, &error);
+  if (error != nullptr) {
+    g_error_free(error);
+  }
+
+  state->exited = true;
+  if (g_subprocess_get_if_exited(process)) {
+    state->exit_status = g_subprocess_get_exit_status(process);
+    state->success = (state->exit_status == 0);
+  } else if (g_subprocess_get_if_signaled(process)) {
+    state->exit_status = -g_subprocess_get_term_sig(process);
+    state->success = false;
+  }
+
+  phpgtk_subprocess_schedule_flush(state);
+
+  phpgtk_subprocess_unref(state);
+}
+
+/**
+ * Throw when the PHP constructor did not run, e.g. a subclass skipping parent::__construct()
+ */
+static void phpgtk_subprocess_check(st_subprocess_state *state, const char *method) {
+  if (state == nullptr) {
+    throw Php::Exception(std::string("GSubprocess::") + method +
+                         ": the object was not constructed, call parent::__construct()");
+  }
+}
+
+/**
+ * Constructor
+ */
+GSubprocess_::GSubprocess_() = default;
+
+/**
+ * Destructor
+ */
+GSubprocess_::~GSubprocess_() {
+  if (state != nullptr) {
+    phpgtk_subprocess_unref(state);
+  }
+}
+
+void GSubprocess_::__construct(Php::Parameters &parameters) {
+  if (parameters.empty() || !parameters[0].isArray() || parameters[0].size() == 0) {
+    throw Php::Exception("GSubprocess::__construct expects a non empty argv array");
+  }
+
+  if (state != nullptr) {
+    throw Php::Exception("GSubprocess::__construct: the object was already constructed");
+  }
+
+  state = new st_subprocess();
+
+  Php::Value argv = parameters[0];
+  for (auto &iter : argv) {
+    state->argv.push_back(iter.second.stringValue());
+  }
+
+  if (parameters.size() > 1 && !parameters[1].isNull()) {
+    state->cwd = parameters[1].stringValue();
+  }
+}
+
+void GSubprocess_::set_stdout_callback(Php::Parameters &parameters) {
+  phpgtk_subprocess_check(state, "set_stdout_callback");
+
+  state->stdout_callback = parameters[0];
+}
+
+void GSubprocess_::set_stderr_callback(Php::Parameters &parameters) {
+  phpgtk_subprocess_check(state, "set_stderr_callback");
+
+  state->stderr_callback = parameters[0];
+}
+
+void GSubprocess_::set_exit_callback(Php::Parameters &parameters) {
+  phpgtk_subprocess_check(state, "set_exit_callback");
+
+  state->exit_callback = parameters[0];
+}
+
+void GSubprocess_::set_max_pending_lines(Php::Parameters &parameters) {
+  phpgtk_subprocess_check(state, "set_max_pending_lines");
+
+  int max_pending_lines = parameters[0];
+  if (max_pending_lines < 1) {
+    throw Php::Exception("GSubprocess::set_max_pending_lines expects a positive number");
+  }
+
+  state->max_pending_lines = max_pending_lines;
+}
+
+void GSubprocess_::start() {
+  phpgtk_subprocess_check(state, "start");
+
+  if (state->started) {
+    throw Php::Exception("GSubprocess::start: the process was already started");
+  }
+
+  std::vector<const gchar *> argv;
+  for (auto &arg : state->argv) {
+    argv.push_back(arg.c_str());
+  }
+  argv.push_back(nullptr);
+
+  GSubprocessLauncher *launcher = g_subprocess_launcher_new(
+      (GSubprocessFlags)(G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDERR_PIPE));
+  if (!state->cwd.empty()) {
+    g_subprocess_launcher_set_cwd(launcher, state->cwd.c_str());
+  }
+
+  GError *error = nullptr;
+  GSubprocess *process = g_subprocess_launcher_spawnv(launcher, argv.data(), &error);
+  g_object_unref(launcher);
+
+  if (process == nullptr) {
+    std::string message = (error != nullptr) ? error->message : "unknown error";
+    if (error != nullptr) {
+      g_error_free(error);
+    }
+    throw Php::Exception("GSubprocess::start: " + message);
+  }
+
+  state->process = process;
+  state->started = true;
+  state->cancellable = g_cancellable_new();
+  state->self = Php::Object("GSubprocess", this);
+
+  GInputStream *pipes[2] = {g_subprocess_get_stdout_pipe(process),
+                            g_subprocess_get_stderr_pipe(process)};
+  for (int index = 0; index < 2; index++) {
+    state->streams[index].stream = G_INPUT_STREAM(g_object_ref(pipes[index]));
+    state->streams[index].eof = false;
+    phpgtk_subprocess_read(state, index);
+  }
+
+  state->refs++;
+  g_subprocess_wait_async(process, nullptr, phpgtk_subprocess_wait_ready, state);
+}
+
+void GSubprocess_::cancel() {
+  phpgtk_subprocess_check(state, "cancel");
+
+  if (!state->started || state->exited) {
+    return;
+  }
+
+  // Output already read is still delivered, the unterminated tail as a last line. What the
+  // child wrote but was not read yet is discarded with the pipes
+  for (auto &stream : state->streams) {
+    if (!stream.partial.empty()) {
+      stream.lines.push_back(stream.partial);
+      stream.partial.clear();
+    }
+  }
+  phpgtk_subprocess_schedule_flush(state);
+
+  g_cancellable_cancel(state->cancellable);
+  g_subprocess_force_exit(state->process);
+}
+
+void GSubprocess_::send_signal(Php::Parameters &parameters) {
+  phpgtk_subprocess_check(state, "send_signal");
+
+  int signal_num = parameters[0];
+
+  if (state->started && !state->exited) {
+    g_subprocess_send_signal(state->process, signal_num);
+  }
+}
+
+Php::Value GSubprocess_::get_identifier() {
+  phpgtk_subprocess_check(state, "get_identifier");
+
+  if (!state->started) {
+    return nullptr;
+  }
+
+  const gchar *identifier = g_subprocess_get_identifier(state->process);
+  if (identifier == nullptr) {
+    return nullptr;
+  }
+
+  return identifier;
+}
+
+Php::Value GSubprocess_::is_running() {
+  phpgtk_subprocess_check(state, "is_running");
+
+  return state->started && !state->exited;
+}
@@ -0,0 +1,79 @@
+#ifndef _PHPGTK_GSUBPROCESS_H_
+#define _PHPGTK_GSUBPROCESS_H_
+
+#include <phpcpp.h>
+#include <gtk/gtk.h>
+#include <gio/gio.h>
+
+/**
+ * GSubprocess_
+ *
+ * Child process driven by the main loop. Output is read asynchronously and split in lines,
+ * the lines gathered during one main loop iteration are delivered in a single callback.
+ * Not a GObject wrapper: the native process only exists once started
+ *
+ * https://docs.gtk.org/gio/class.Subprocess.html
+ */
+class GSubprocess_ : public Php::Base {
+  /**
+   * Publics
+   */
+ public:
+  /**
+   * Shared with the async callbacks, defined in GSubprocess.cpp
+   */
+  struct st_subprocess;
+
+  /**
+   * Privates
+   */
+ private:
+  st_subprocess *state{};
+
+  /**
+   * Publics
+   */
+ public:
+  /**
+   *  C++ constructor and destructor
+   */
+  GSubprocess_();
+  ~GSubprocess_();
+
+  /**
+   * new GSubprocess(array $argv [, string $cwd])
+   */
+  void __construct(Php::Parameters &parameters);
+
+  /**
+   * callback($process, array $lines), called once per main loop iteration with the new lines.
+   * Output without a newline is cut into lines of 1 MiB
+   */
+  void set_stdout_callback(Php::Parameters &parameters);
+  void set_stderr_callback(Php::Parameters &parameters);
+
+  /**
+   * callback($process, int $exit_status, bool $success), after the last output line.
+   * $exit_status is the exit code, or minus the signal number when the child was killed
+   */
+  void set_exit_callback(Php::Parameters &parameters);
+
+  /**
+   * Lines queued per stream before reading pauses, the child then blocks on its pipe. Also the
+   * most lines handed to one callback, the rest wait for the next main loop iteration
+   */
+  void set_max_pending_lines(Php::Parameters &parameters);
+
+  void start();
+
+  /**
+   * Kill the child. Lines already read are still delivered before the exit callback, output
+   * left unread in the pipes is discarded
+   */
+  void cancel();
+  void send_signal(Php::Parameters &parameters);
+  Php::Value get_identifier();
+  Php::Value is_running();
+};
+
+#endif
@@ -0,0 +1,32 @@
+#include "PhpClosure.h"
+
+/**
+ * Number of callback states currently alive, exposed by GObject::debug_live_closures()
+ */
+static long phpgtk_live_closures = 0;
+
+/**
+ * Constructor
+ */
+phpgtk_closure::phpgtk_closure() {
+  phpgtk_live_closures++;
+}
+
+/**
+ * Destructor
+ */
+phpgtk_closure::~phpgtk_closure() {
+  phpgtk_live_closures--;
+}
+
+void phpgtk_closure::destroy(gpointer data) {
+  delete (phpgtk_closure *)data;
+}
+
+void phpgtk_closure::closure_notify(gpointer data, GClosure *closure) {
+  delete (phpgtk_closure *)data;
+}
+
+long phpgtk_closure::live_count() {
+  return phpgtk_live_closures;
+}
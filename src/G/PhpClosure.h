@@ -0,0 +1,48 @@
+#ifndef _PHPGTK_PHPCLOSURE_H_
+#define _PHPGTK_PHPCLOSURE_H_
+
+#include <phpcpp.h>
+#include <string>
+#include <vector>
+#include <gtk/gtk.h>
+
+/**
+ * State of a PHP callable handed to GLib as user data
+ *
+ * Every native callback (signals, timeouts, sort and cell data functions, clipboard requests)
+ * keeps its PHP callable, self object and user parameters in a struct deriving from this one.
+ * It is allocated with new and released by the destroy notify GLib calls when the callback is
+ * removed, so the refcounts of the PHP values are dropped with it
+ */
+struct phpgtk_closure {
+  Php::Value callback_name;
+  Php::Value self_widget;
+  std::vector<Php::Value> user_parameters;
+
+  // Labels of the profiler, filled before the first profiled call
+  std::string profile_type;
+  std::string profile_handler;
+
+  phpgtk_closure();
+  virtual ~phpgtk_closure();
+
+  phpgtk_closure(const phpgtk_closure &) = delete;
+  phpgtk_closure &operator=(const phpgtk_closure &) = delete;
+
+  /**
+   * GDestroyNotify, for g_timeout_add_full, set_sort_func, set_cell_data_func...
+   */
+  static void destroy(gpointer data);
+
+  /**
+   * GClosureNotify, for g_cclosure_new_swap
+   */
+  static void closure_notify(gpointer data, GClosure *closure);
+
+  /**
+   * Number of callback states currently alive
+   */
+  static long live_count();
+};
+
+#endif
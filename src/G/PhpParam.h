@@ -0,0 +1,107 @@
+#ifndef _PHPGTK_PHPPARAM_H_
+#define _PHPGTK_PHPPARAM_H_
+
+#include <phpcpp.h>
+#include <string>
+#include <gtk/gtk.h>
+
+std::string phpgtk_type_to_string(Php::Type type);
+
+/**
+ * Typed argument readers for the stubs generated by gen/run.php
+ *
+ * Each reader checks and converts one argument, at a 1-based position, for the C type the
+ * generator picked: the conversion is fixed at compile time and inlined into the stub, unlike
+ * phpgtk_check_parameter() which switches on the expected type at runtime. Strings are views
+ * into the zend_string, nothing is allocated unless a check fails
+ */
+
+/**
+ * Argument at the position, throwing when it is missing
+ */
+inline const Php::Value &phpgtk_param_at(Php::Parameters &parameters, int position) {
+  if ((int)parameters.size() < position) {
+    throw Php::Exception("Missing required parameter " + std::to_string(position));
+  }
+
+  return parameters[position - 1];
+}
+
+inline void phpgtk_param_wrong_type(int position, const Php::Value &value, const char *expected) {
+  throw Php::Exception("Expected parameter " + std::to_string(position) + " to be " + expected +
+                       ", " + phpgtk_type_to_string(value.type()) + " given");
+}
+
+inline const gchar *phpgtk_param_string(Php::Parameters &parameters, int position) {
+  const Php::Value &value = phpgtk_param_at(parameters, position);
+  if (!value.isString()) {
+    phpgtk_param_wrong_type(position, value, "a string");
+  }
+
+  return value.rawValue();
+}
+
+/**
+ * Same as phpgtk_param_string(), null reads as nullptr
+ */
+inline const gchar *phpgtk_param_string_or_null(Php::Parameters &parameters, int position) {
+  const Php::Value &value = phpgtk_param_at(parameters, position);
+  if (value.isNull()) {
+    return nullptr;
+  }
+  if (!value.isString()) {
+    phpgtk_param_wrong_type(position, value, "a string or null");
+  }
+
+  return value.rawValue();
+}
+
+/**
+ * Integers, enums and flags
+ */
+template <typename T>
+inline T phpgtk_param_integer(Php::Parameters &parameters, int position) {
+  const Php::Value &value = phpgtk_param_at(parameters, position);
+  if (!value.isNumeric()) {
+    phpgtk_param_wrong_type(position, value, "an integer");
+  }
+
+  return (T)value.numericValue();
+}
+
+/**
+ * Floating point, integers are accepted like PHP does for float arguments
+ */
+template <typename T>
+inline T phpgtk_param_float(Php::Parameters &parameters, int position) {
+  const Php::Value &value = phpgtk_param_at(parameters, position);
+  if (!value.isFloat() && !value.isNumeric()) {
+    phpgtk_param_wrong_type(position, value, "a float");
+  }
+
+  return (T)value.floatValue();
+}
+
+inline gboolean phpgtk_param_boolean(Php::Parameters &parameters, int position) {
+  const Php::Value &value = phpgtk_param_at(parameters, position);
+  if (!value.isBool()) {
+    phpgtk_param_wrong_type(position, value, "a boolean");
+  }
+
+  return value.boolValue();
+}
+
+/**
+ * Wrapper object of the class, W is its C++ wrapper type
+ */
+template <typename W>
+inline W *phpgtk_param_object(Php::Parameters &parameters, int position, const char *class_name) {
+  const Php::Value &value = phpgtk_param_at(parameters, position);
+  if (!value.instanceOf(class_name)) {
+    phpgtk_param_wrong_type(position, value, (std::string("an instance of ") + class_name).c_str());
+  }
+
+  return (W *)value.implementation();
+}
+
+#endif
@@ -0,0 +1,199 @@
+#include "PhpProfiler.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include <unistd.h>
+
+bool phpgtk_profiler::enabled = false;
+
+/**
+ * Totals of one (object type, signal, handler)
+ */
+struct st_profile_entry {
+  std::string type;
+  std::string signal;
+  std::string handler;
+
+  long count{};
+  gint64 total_us{};
+  gint64 max_us{};
+  gint64 stall_us{};
+  long stalls{};
+};
+
+/**
+ * One dispatch, kept for the trace export
+ */
+struct st_profile_event {
+  const st_profile_entry *entry;
+  gint64 start_us;
+  gint64 duration_us;
+};
+
+static std::map<std::string, st_profile_entry> phpgtk_profile_entries;
+static std::vector<st_profile_event> phpgtk_profile_events;
+static gint64 phpgtk_profile_stall_threshold_us = 16000;
+static size_t phpgtk_profile_max_events = 100000;
+
+void phpgtk_profiler::enable(gint64 stall_threshold_us, size_t max_trace_events) {
+  phpgtk_profile_stall_threshold_us = stall_threshold_us;
+  phpgtk_profile_max_events = max_trace_events;
+  enabled = true;
+}
+
+void phpgtk_profiler::disable() {
+  enabled = false;
+}
+
+void phpgtk_profiler::reset() {
+  phpgtk_profile_events.clear();
+  phpgtk_profile_entries.clear();
+}
+
+/**
+ * Readable name of a PHP callable, worked out once per closure
+ */
+static std::string phpgtk_profile_handler_name(const Php::Value &callable) {
+  if (callable.isString()) {
+    return callable.stringValue();
+  }
+
+  if (callable.isArray() && callable.size() == 2) {
+    Php::Value target = callable.get(0);
+    std::string class_name =
+        target.isObject() ? Php::call("get_class", target).stringValue() : target.stringValue();
+    return class_name + "::" + callable.get(1).stringValue();
+  }
+
+  if (callable.isObject()) {
+    // Closures are told apart by where they are defined
+    try {
+      Php::Object reflection("ReflectionFunction", callable);
+      Php::Value file = reflection.call("getFileName");
+      Php::Value line = reflection.call("getStartLine");
+      return "{closure}@" + file.stringValue() + ":" + line.stringValue();
+    } catch (Php::Exception &exception) {
+      return Php::call("get_class", callable).stringValue() + "::__invoke";
+    }
+  }
+
+  return "unknown";
+}
+
+static std::string phpgtk_profile_type_name(const Php::Value &self) {
+  if (self.isObject()) {
+    return Php::call("get_class", self).stringValue();
+  }
+
+  return "GSource";
+}
+
+void phpgtk_profiler::label(phpgtk_closure *closure) {
+  try {
+    closure->profile_type = phpgtk_profile_type_name(closure->self_widget);
+    closure->profile_handler = phpgtk_profile_handler_name(closure->callback_name);
+  } catch (Php::Exception &exception) {
+    // A throwing autoloader or __toString, keep profiling under a generic label
+    closure->profile_type = "unknown";
+    closure->profile_handler = "unknown";
+  }
+}
+
+void phpgtk_profiler::record(phpgtk_closure *closure, const char *signal_name, gint64 start,
+                             gint64 end) {
+  std::string signal = (signal_name != nullptr) ? signal_name : "";
+  std::string key = closure->profile_type;
+  key.append(1, '\0').append(signal).append(1, '\0').append(closure->profile_handler);
+
+  st_profile_entry &entry = phpgtk_profile_entries[key];
+  if (entry.count == 0) {
+    entry.type = closure->profile_type;
+    entry.signal = signal;
+    entry.handler = closure->profile_handler;
+  }
+
+  gint64 duration = end - start;
+  entry.count++;
+  entry.total_us += duration;
+  entry.max_us = std::max(entry.max_us, duration);
+  if (duration > phpgtk_profile_stall_threshold_us) {
+    entry.stall_us += duration - phpgtk_profile_stall_threshold_us;
+    entry.stalls++;
+  }
+
+  // Map nodes never move, the events can point at their entry
+  if (phpgtk_profile_events.size() < phpgtk_profile_max_events) {
+    phpgtk_profile_events.push_back({&entry, start, duration});
+  }
+}
+
+Php::Value phpgtk_profiler::report() {
+  std::vector<const st_profile_entry *> entries;
+  for (auto &iter : phpgtk_profile_entries) {
+    entries.push_back(&iter.second);
+  }
+
+  std::sort(entries.begin(), entries.end(),
+            [](const st_profile_entry *a, const st_profile_entry *b) {
+              return a->total_us > b->total_us;
+            });
+
+  Php::Array ret_arr;
+  for (size_t i = 0; i < entries.size(); i++) {
+    const st_profile_entry *entry = entries[i];
+
+    Php::Array row;
+    row["type"] = entry->type;
+    row["signal"] = entry->signal;
+    row["handler"] = entry->handler;
+    row["count"] = (int64_t)entry->count;
+    row["total_ms"] = entry->total_us / 1000.0;
+    row["max_ms"] = entry->max_us / 1000.0;
+    row["avg_ms"] = entry->total_us / 1000.0 / entry->count;
+    row["stall_ms"] = entry->stall_us / 1000.0;
+    row["stalls"] = (int64_t)entry->stalls;
+    ret_arr[(int)i] = row;
+  }
+
+  return ret_arr;
+}
+
+static void phpgtk_profile_json_string(std::string &out, const std::string &value) {
+  out.append(1, '"');
+  for (unsigned char c : value) {
+    if (c == '"' || c == '\\') {
+      out.append(1, '\\').append(1, (char)c);
+    } else if (c < 0x20) {
+      char escaped[8];
+      g_snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out.append(escaped);
+    } else {
+      out.append(1, (char)c);
+    }
+  }
+  out.append(1, '"');
+}
+
+std::string phpgtk_profiler::trace_json() {
+  std::string out = "{\"traceEvents\":[";
+  long pid = (long)getpid();
+
+  for (size_t i = 0; i < phpgtk_profile_events.size(); i++) {
+    const st_profile_event &event = phpgtk_profile_events[i];
+
+    out.append(i > 0 ? ",{" : "{");
+    out.append("\"name\":");
+    phpgtk_profile_json_string(out, event.entry->handler);
+    out.append(",\"cat\":");
+    phpgtk_profile_json_string(out, event.entry->type + "::" + event.entry->signal);
+    out.append(",\"ph\":\"X\",\"ts\":").append(std::to_string(event.start_us));
+    out.append(",\"dur\":").append(std::to_string(event.duration_us));
+    out.append(",\"pid\":").append(std::to_string(pid)).append(",\"tid\":1}");
+  }
+
+  out.append("],\"displayTimeUnit\":\"ms\"}");
+
+  return out;
+}
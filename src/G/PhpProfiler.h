@@ -0,0 +1,90 @@
+#ifndef _PHPGTK_PHPPROFILER_H_
+#define _PHPGTK_PHPPROFILER_H_
+
+#include <phpcpp.h>
+#include <string>
+#include <gtk/gtk.h>
+
+#include "PhpClosure.h"
+#include "PhpWatchdog.h"
+
+/**
+ * Opt-in profiler of the PHP handlers called from the main loop
+ *
+ * Each dispatch is keyed by (object type, signal, handler) and accumulates the call count, the
+ * total and max wall time, and the stall time, the part of a call beyond the frame budget.
+ * Disabled, a dispatch costs one branch
+ */
+class phpgtk_profiler {
+ public:
+  static bool enabled;
+
+  static void enable(gint64 stall_threshold_us, size_t max_trace_events);
+  static void disable();
+  static void reset();
+
+  /**
+   * Resolve the type and handler labels of a closure, once. Calls into PHP, so it runs before
+   * the dispatch and never throws
+   */
+  static void label(phpgtk_closure *closure);
+
+  static void record(phpgtk_closure *closure, const char *signal_name, gint64 start, gint64 end);
+
+  /**
+   * Rows sorted by total time, slowest first
+   */
+  static Php::Value report();
+
+  /**
+   * Chrome trace JSON (chrome://tracing, Perfetto) of the recorded dispatches
+   */
+  static std::string trace_json();
+};
+
+/**
+ * Times one dispatch of a PHP handler, from construction to destruction, and tells the
+ * watchdog which signal is being dispatched meanwhile
+ *
+ * The destructor may run while an exception of the handler unwinds, so it does not call into
+ * PHP and does not throw: the labels are resolved in the constructor
+ */
+class phpgtk_profile_scope {
+ public:
+  phpgtk_profile_scope(phpgtk_closure *closure, const char *signal_name)
+      : closure(phpgtk_profiler::enabled ? closure : nullptr),
+        signal_name(signal_name),
+        previous_signal(phpgtk_watchdog::current_signal.exchange(signal_name)),
+        start(0) {
+    if (this->closure != nullptr) {
+      if (this->closure->profile_handler.empty()) {
+        phpgtk_profiler::label(this->closure);
+      }
+
+      start = g_get_monotonic_time();
+    }
+  }
+
+  ~phpgtk_profile_scope() {
+    if (closure != nullptr) {
+      try {
+        phpgtk_profiler::record(closure, signal_name, start, g_get_monotonic_time());
+      } catch (...) {
+        // Out of memory for the entry, the sample is dropped
+      }
+    }
+
+    phpgtk_watchdog::current_signal.store(previous_signal);
+  }
+
+  phpgtk_profile_scope(const phpgtk_profile_scope &) = delete;
+  phpgtk_profile_scope &operator=(const phpgtk_profile_scope &) = delete;
+
+ private:
+  phpgtk_closure *closure;
+  const char *signal_name;
+  const char *previous_signal;
+  gint64 start;
+};
+
+#endif
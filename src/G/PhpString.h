@@ -0,0 +1,63 @@
+#ifndef _PHPGTK_PHPSTRING_H_
+#define _PHPGTK_PHPSTRING_H_
+
+#include <phpcpp.h>
+#include <string>
+#include <gtk/gtk.h>
+
+/**
+ * String argument read without copy
+ *
+ * When the value already is a PHP string, c_str() points into its zend_string, which PHP keeps
+ * NUL terminated and alive for as long as the parameters. Other values (numbers, objects with
+ * __toString) are converted once into a local copy, short ones without heap allocation. The view
+ * must not outlive the Php::Value it was made from
+ */
+class phpgtk_string {
+ public:
+  explicit phpgtk_string(const Php::Value &value) {
+    if (value.isString()) {
+      data = value.rawValue();
+      length = (size_t)value.size();
+    } else if (value.isNull()) {
+      is_null = true;
+    } else {
+      copy = value.stringValue();
+      data = copy.c_str();
+      length = copy.size();
+    }
+  }
+
+  phpgtk_string(const phpgtk_string &) = delete;
+  phpgtk_string &operator=(const phpgtk_string &) = delete;
+
+  /**
+   * Never null, a null PHP value reads as ""
+   */
+  const gchar *c_str() const {
+    return data;
+  }
+
+  /**
+   * Null for a null PHP value, for the C functions that take NULL to unset
+   */
+  const gchar *c_str_or_null() const {
+    return is_null ? nullptr : data;
+  }
+
+  size_t size() const {
+    return length;
+  }
+
+  bool empty() const {
+    return length == 0;
+  }
+
+ private:
+  const gchar *data{""};
+  size_t length{};
+  bool is_null{};
+  std::string copy;
+};
+
+#endif
@@ -0,0 +1,295 @@
+#include "PhpWatchdog.h"
+
+#include <cstdio>
+#include <vector>
+
+#include <php.h>
+
+std::atomic<const char *> phpgtk_watchdog::current_signal{nullptr};
+
+/**
+ * One iteration that ran past the threshold
+ */
+struct st_stall_report {
+  gint64 time_us{};
+  gint64 duration_us{};
+  std::string signal;
+  std::string function;
+  std::string file;
+  int line{};
+  bool complete{};
+  guint iteration{};
+};
+
+/**
+ * Watchdog state, the atomics are written by the main thread and read by the watchdog thread
+ */
+static std::atomic<gint64> phpgtk_watchdog_busy_since{0};
+static std::atomic<guint> phpgtk_watchdog_iteration{0};
+
+static GThread *phpgtk_watchdog_thread = nullptr;
+static GMutex phpgtk_watchdog_mutex;
+static GCond phpgtk_watchdog_cond;
+static bool phpgtk_watchdog_stop = false;
+
+static gint64 phpgtk_watchdog_threshold_us = 200000;
+static std::string phpgtk_watchdog_log_path;
+
+// Ring of reports, guarded by the mutex
+static std::vector<st_stall_report> phpgtk_watchdog_ring;
+static size_t phpgtk_watchdog_next = 0;
+static size_t phpgtk_watchdog_count = 0;
+
+// Report of the current iteration waiting for its PHP frame, guarded by the mutex
+static st_stall_report *phpgtk_watchdog_pending = nullptr;
+
+static GPollFunc phpgtk_watchdog_previous_poll = nullptr;
+static void (*phpgtk_watchdog_previous_interrupt)(zend_execute_data *execute_data) = nullptr;
+
+// The interrupt flag of the main thread, EG() would resolve to the watchdog thread under ZTS
+#if PHP_VERSION_ID >= 80200
+static zend_atomic_bool *phpgtk_watchdog_vm_interrupt = nullptr;
+#else
+static zend_bool *phpgtk_watchdog_vm_interrupt = nullptr;
+#endif
+
+static void phpgtk_watchdog_request_interrupt() {
+#if PHP_VERSION_ID >= 80200
+  zend_atomic_bool_store(phpgtk_watchdog_vm_interrupt, true);
+#else
+  *phpgtk_watchdog_vm_interrupt = 1;
+#endif
+}
+
+static std::string phpgtk_watchdog_format(const st_stall_report &report) {
+  GDateTime *date = g_date_time_new_from_unix_local(report.time_us / G_USEC_PER_SEC);
+  gchar *date_text = g_date_time_format(date, "%Y-%m-%d %H:%M:%S");
+  g_date_time_unref(date);
+
+  gchar *line = g_strdup_printf(
+      "%s stall %.1f ms signal=%s at %s (%s:%d)\n", date_text, report.duration_us / 1000.0,
+      report.signal.empty() ? "-" : report.signal.c_str(),
+      report.function.empty() ? "[native]" : report.function.c_str(),
+      report.file.empty() ? "-" : report.file.c_str(), report.line);
+  std::string s_line = line;
+
+  g_free(line);
+  g_free(date_text);
+
+  return s_line;
+}
+
+static bool phpgtk_watchdog_append(const std::string &path, const std::string &text) {
+  FILE *log = fopen(path.c_str(), "a");
+  if (log == nullptr) {
+    return false;
+  }
+
+  fwrite(text.data(), 1, text.size(), log);
+  fclose(log);
+
+  return true;
+}
+
+/**
+ * Close the report of the iteration that just ended, on the main thread
+ */
+static void phpgtk_watchdog_finish_iteration(gint64 now) {
+  std::string log_line;
+
+  g_mutex_lock(&phpgtk_watchdog_mutex);
+  if (phpgtk_watchdog_pending != nullptr) {
+    phpgtk_watchdog_pending->duration_us = now - phpgtk_watchdog_busy_since.load();
+    phpgtk_watchdog_pending->complete = true;
+    if (!phpgtk_watchdog_log_path.empty()) {
+      log_line = phpgtk_watchdog_format(*phpgtk_watchdog_pending);
+    }
+    phpgtk_watchdog_pending = nullptr;
+  }
+  g_mutex_unlock(&phpgtk_watchdog_mutex);
+
+  if (!log_line.empty()) {
+    phpgtk_watchdog_append(phpgtk_watchdog_log_path, log_line);
+  }
+}
+
+static gint phpgtk_watchdog_poll(GPollFD *ufds, guint nfds, gint timeout) {
+  gint64 now = g_get_monotonic_time();
+  phpgtk_watchdog_finish_iteration(now);
+  phpgtk_watchdog_busy_since.store(0);
+
+  gint ret = phpgtk_watchdog_previous_poll(ufds, nfds, timeout);
+
+  phpgtk_watchdog_iteration++;
+  phpgtk_watchdog_busy_since.store(g_get_monotonic_time());
+
+  return ret;
+}
+
+/**
+ * Runs on the main thread at the next opcode after the watchdog asked for it
+ */
+static void phpgtk_watchdog_interrupt(zend_execute_data *execute_data) {
+  g_mutex_lock(&phpgtk_watchdog_mutex);
+  st_stall_report *report = phpgtk_watchdog_pending;
+  if (report != nullptr && report->function.empty() &&
+      report->iteration == phpgtk_watchdog_iteration.load()) {
+    const char *class_space = nullptr;
+    const char *class_name = get_active_class_name(&class_space);
+    const char *function_name = get_active_function_name();
+
+    if (function_name != nullptr) {
+      report->function = std::string(class_name) + class_space + function_name;
+    }
+
+    const char *file = zend_get_executed_filename();
+    report->file = (file != nullptr) ? file : "";
+    report->line = (int)zend_get_executed_lineno();
+  }
+  g_mutex_unlock(&phpgtk_watchdog_mutex);
+
+  if (phpgtk_watchdog_previous_interrupt != nullptr) {
+    phpgtk_watchdog_previous_interrupt(execute_data);
+  }
+}
+
+static gpointer phpgtk_watchdog_run(gpointer data) {
+  guint reported_iteration = 0;
+  bool reported = false;
+
+  g_mutex_lock(&phpgtk_watchdog_mutex);
+  while (!phpgtk_watchdog_stop) {
+    gint64 interval = MAX(phpgtk_watchdog_threshold_us / 4, 5000);
+    g_cond_wait_until(&phpgtk_watchdog_cond, &phpgtk_watchdog_mutex,
+                      g_get_monotonic_time() + interval);
+    if (phpgtk_watchdog_stop) {
+      break;
+    }
+
+    gint64 busy_since = phpgtk_watchdog_busy_since.load();
+    guint iteration = phpgtk_watchdog_iteration.load();
+    gint64 now = g_get_monotonic_time();
+
+    if (busy_since == 0 || now - busy_since < phpgtk_watchdog_threshold_us) {
+      continue;
+    }
+
+    if (reported && reported_iteration == iteration) {
+      continue;
+    }
+
+    st_stall_report &report = phpgtk_watchdog_ring[phpgtk_watchdog_next];
+    report = st_stall_report();
+    report.time_us = g_get_real_time() - (now - busy_since);
+    report.duration_us = now - busy_since;
+    report.iteration = iteration;
+
+    const char *signal = phpgtk_watchdog::current_signal.load();
+    report.signal = (signal != nullptr) ? signal : "";
+
+    phpgtk_watchdog_pending = &report;
+    phpgtk_watchdog_next = (phpgtk_watchdog_next + 1) % phpgtk_watchdog_ring.size();
+    phpgtk_watchdog_count = MIN(phpgtk_watchdog_count + 1, phpgtk_watchdog_ring.size());
+
+    reported = true;
+    reported_iteration = iteration;
+
+    phpgtk_watchdog_request_interrupt();
+  }
+  g_mutex_unlock(&phpgtk_watchdog_mutex);
+
+  return nullptr;
+}
+
+void phpgtk_watchdog::enable(gint64 threshold_us, size_t capacity, const std::string &log_path) {
+  disable();
+
+  phpgtk_watchdog_threshold_us = threshold_us;
+  phpgtk_watchdog_log_path = log_path;
+  phpgtk_watchdog_ring.assign(MAX(capacity, (size_t)1), st_stall_report());
+  phpgtk_watchdog_next = 0;
+  phpgtk_watchdog_count = 0;
+  phpgtk_watchdog_pending = nullptr;
+  phpgtk_watchdog_stop = false;
+
+  phpgtk_watchdog_vm_interrupt = &EG(vm_interrupt);
+  phpgtk_watchdog_previous_interrupt = zend_interrupt_function;
+  zend_interrupt_function = phpgtk_watchdog_interrupt;
+
+  phpgtk_watchdog_previous_poll = g_main_context_get_poll_func(nullptr);
+  g_main_context_set_poll_func(nullptr, phpgtk_watchdog_poll);
+
+  // Not inside an iteration yet, nothing to watch until the first poll returns
+  phpgtk_watchdog_busy_since.store(0);
+
+  phpgtk_watchdog_thread = g_thread_new("phpgtk-watchdog", phpgtk_watchdog_run, nullptr);
+}
+
+void phpgtk_watchdog::disable() {
+  if (phpgtk_watchdog_thread == nullptr) {
+    return;
+  }
+
+  g_mutex_lock(&phpgtk_watchdog_mutex);
+  phpgtk_watchdog_stop = true;
+  g_cond_signal(&phpgtk_watchdog_cond);
+  g_mutex_unlock(&phpgtk_watchdog_mutex);
+
+  g_thread_join(phpgtk_watchdog_thread);
+  phpgtk_watchdog_thread = nullptr;
+
+  g_main_context_set_poll_func(nullptr, phpgtk_watchdog_previous_poll);
+  zend_interrupt_function = phpgtk_watchdog_previous_interrupt;
+  phpgtk_watchdog_pending = nullptr;
+}
+
+bool phpgtk_watchdog::is_enabled() {
+  return phpgtk_watchdog_thread != nullptr;
+}
+
+Php::Value phpgtk_watchdog::reports() {
+  Php::Array ret_arr;
+
+  g_mutex_lock(&phpgtk_watchdog_mutex);
+  size_t size = phpgtk_watchdog_ring.size();
+  for (size_t i = 0; i < phpgtk_watchdog_count; i++) {
+    const st_stall_report &report =
+        phpgtk_watchdog_ring[(phpgtk_watchdog_next + size - phpgtk_watchdog_count + i) % size];
+
+    Php::Array row;
+    row["time"] = report.time_us / (double)G_USEC_PER_SEC;
+    row["duration_ms"] = report.duration_us / 1000.0;
+    row["complete"] = report.complete;
+    row["signal"] = report.signal.empty() ? Php::Value(nullptr) : Php::Value(report.signal);
+    row["function"] = report.function.empty() ? Php::Value(nullptr) : Php::Value(report.function);
+    row["file"] = report.file.empty() ? Php::Value(nullptr) : Php::Value(report.file);
+    row["line"] = report.line;
+    ret_arr[(int)i] = row;
+  }
+  g_mutex_unlock(&phpgtk_watchdog_mutex);
+
+  return ret_arr;
+}
+
+void phpgtk_watchdog::clear() {
+  g_mutex_lock(&phpgtk_watchdog_mutex);
+  phpgtk_watchdog_count = 0;
+  phpgtk_watchdog_pending = nullptr;
+  g_mutex_unlock(&phpgtk_watchdog_mutex);
+}
+
+void phpgtk_watchdog::dump(const std::string &path) {
+  std::string text;
+
+  g_mutex_lock(&phpgtk_watchdog_mutex);
+  size_t size = phpgtk_watchdog_ring.size();
+  for (size_t i = 0; i < phpgtk_watchdog_count; i++) {
+    text += phpgtk_watchdog_format(
+        phpgtk_watchdog_ring[(phpgtk_watchdog_next + size - phpgtk_watchdog_count + i) % size]);
+  }
+  g_mutex_unlock(&phpgtk_watchdog_mutex);
+
+  if (!phpgtk_watchdog_append(path, text)) {
+    throw Php::Exception("Gtk::watchdog_dump: cannot open " + path);
+  }
+}
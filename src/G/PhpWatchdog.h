@@ -0,0 +1,40 @@
+#ifndef _PHPGTK_PHPWATCHDOG_H_
+#define _PHPGTK_PHPWATCHDOG_H_
+
+#include <phpcpp.h>
+#include <atomic>
+#include <string>
+#include <gtk/gtk.h>
+
+/**
+ * Main loop stall watchdog
+ *
+ * The default main context poll function marks when an iteration starts working and when it
+ * goes back to waiting. A thread checks that mark, and once an iteration runs past the
+ * threshold it records a report and raises a VM interrupt, so the main thread fills in the PHP
+ * function, file and line it is executing at its next opcode
+ */
+class phpgtk_watchdog {
+ public:
+  /**
+   * Signal being dispatched to PHP, set by phpgtk_profile_scope
+   */
+  static std::atomic<const char *> current_signal;
+
+  static void enable(gint64 threshold_us, size_t capacity, const std::string &log_path);
+  static void disable();
+  static bool is_enabled();
+
+  /**
+   * Reports oldest first
+   */
+  static Php::Value reports();
+  static void clear();
+
+  /**
+   * Append the reports to a log file
+   */
+  static void dump(const std::string &path);
+};
+
+#endif
@@ -2,6 +2,7 @@
 #include "Gdk.h"
 #include "../../php-gtk.h"
 #include "GdkEvent.h"
+#include "../Cairo/CairoContext.h"
 
 /**
  *
@@ -79,24 +80,17 @@ Php::Value Gdk_::test_simulate_button(Php::Parameters &parameters) {
  * https://developer.gnome.org/gdk3/stable/gdk3-Cairo-Interaction.html#gdk-cairo-set-source-pixbuf
  */
 void Gdk_::cairo_set_source_pixbuf(Php::Parameters &parameters) {
-  // Parameter 1: cairo_t* - passed as GdkEvent object from draw signal
-  // Note: Cairo context is a G_TYPE_BOXED that gets wrapped as GdkEvent by GObject callback,
-  // even though it's actually a cairo_t*. We extract the raw pointer from GdkEvent::instance.
+  // Parameter 1: CairoContext from the draw signal (a GdkEvent carrier is still accepted)
   if (parameters.empty()) {
     throw Php::Exception("cairo_set_source_pixbuf: Missing cairo_context parameter");
   }
   if (parameters[0].type() != Php::Type::Object) {
-    throw Php::Exception("cairo_set_source_pixbuf: cairo_context must be a GdkEvent object");
+    throw Php::Exception("cairo_set_source_pixbuf: cairo_context must be a CairoContext object");
   }
-  if (!parameters[0].instanceOf("GdkEvent")) {
-    throw Php::Exception("cairo_set_source_pixbuf: cairo_context must be a GdkEvent object");
+  if (!phpgtk_is_cairo_context(parameters[0])) {
+    throw Php::Exception("cairo_set_source_pixbuf: cairo_context must be a CairoContext object");
   }
-  Php::Value object_event = parameters[0];
-  GdkEvent_ *phpgtk_event = (GdkEvent_ *)object_event.implementation();
-
-  // The instance pointer is actually cairo_t*, not GdkEvent*
-  // We need to get it before any GdkEvent-specific operations are performed
-  cairo_t *cr = (cairo_t *)phpgtk_event->instance;
+  cairo_t *cr = phpgtk_get_cairo_context(parameters[0]);
 
   if (cr == nullptr) {
     throw Php::Exception("cairo_set_source_pixbuf: Invalid cairo context (null pointer)");
@@ -154,23 +148,17 @@ void Gdk_::cairo_set_source_pixbuf(Php::Parameters &parameters) {
  * https://www.cairographics.org/manual/cairo-cairo-t.html#cairo-paint
  */
 void Gdk_::cairo_paint(Php::Parameters &parameters) {
-  // Parameter 1: cairo_t* - passed as GdkEvent object from draw signal
-  // Note: Cairo context is a G_TYPE_BOXED that gets wrapped as GdkEvent by GObject callback,
-  // even though it's actually a cairo_t*. We extract the raw pointer from GdkEvent::instance.
+  // Parameter 1: CairoContext from the draw signal (a GdkEvent carrier is still accepted)
   if (parameters.empty()) {
     throw Php::Exception("cairo_paint: Missing cairo_context parameter");
   }
   if (parameters[0].type() != Php::Type::Object) {
-    throw Php::Exception("cairo_paint: cairo_context must be a GdkEvent object");
+    throw Php::Exception("cairo_paint: cairo_context must be a CairoContext object");
   }
-  if (!parameters[0].instanceOf("GdkEvent")) {
-    throw Php::Exception("cairo_paint: cairo_context must be a GdkEvent object");
+  if (!phpgtk_is_cairo_context(parameters[0])) {
+    throw Php::Exception("cairo_paint: cairo_context must be a CairoContext object");
   }
-  Php::Value object_event = parameters[0];
-  GdkEvent_ *phpgtk_event = (GdkEvent_ *)object_event.implementation();
-
-  // The instance pointer is actually cairo_t*, not GdkEvent*
-  cairo_t *cr = (cairo_t *)phpgtk_event->instance;
+  cairo_t *cr = phpgtk_get_cairo_context(parameters[0]);
 
   if (cr == nullptr) {
     throw Php::Exception("cairo_paint: Invalid cairo context (null pointer)");
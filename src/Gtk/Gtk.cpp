@@ -1,16 +1,36 @@
 
 #include "Gtk.h"
 
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <glib-unix.h>
+#include <php.h>
+
 // https://developer.gnome.org/gtk3/stable/gtkbase.html
 
 /**
  * Struct for callback gpointer
  */
-struct Gtk_::st_timeout_add {
-  Php::Value callback_name;
+struct Gtk_::st_timeout_add : public phpgtk_closure {
   Php::Array callback_params;
 };
 
+/**
+ * Struct for io watch gpointer
+ */
+struct Gtk_::st_io_watch : public phpgtk_closure {
+  Php::Value stream;
+  gint fd{-1};
+};
+
+/**
+ * Size of each read, and maximum delivered on one wake-up so a busy fd does not starve the loop
+ */
+#define PHPGTK_IO_CHUNK_SIZE 65536
+#define PHPGTK_IO_MAX_BATCH (16 * PHPGTK_IO_CHUNK_SIZE)
+
 /**
  *
  */
@@ -39,17 +59,16 @@ Php::Value Gtk_::timeout_add(Php::Parameters &parameters) {
     callback_params[i - 2] = parameters[i];
   }
 
-  // Create gpointer user data
-  struct st_timeout_add *callback_object =
-      (struct st_timeout_add *)malloc(sizeof(struct st_timeout_add));
-  memset(callback_object, 0, sizeof(struct st_timeout_add));
+  // Create gpointer user data, released when the source is removed
+  struct st_timeout_add *callback_object = new st_timeout_add();
 
   // Add my internal parameters
   callback_object->callback_name = parameters[1];
   callback_object->callback_params = callback_params;
 
   // Call
-  gint ret = g_timeout_add(interval, timeout_add_callback, callback_object);
+  gint ret = g_timeout_add_full(G_PRIORITY_DEFAULT, interval, timeout_add_callback,
+                                callback_object, phpgtk_closure::destroy);
   return ret;
 }
 
@@ -64,6 +83,7 @@ gint Gtk_::timeout_add_callback(gpointer data) {
   // Wrap in try-catch to properly handle exceptions from PHP callbacks
   Php::Value ret;
   try {
+    phpgtk_profile_scope profile_scope(callback_object, "timeout");
     ret = Php::call("call_user_func_array", callback_object->callback_name, internal_parameters);
   } catch (Php::Exception &exception) {
     // Re-throw to let PHP-CPP handle the exception properly
@@ -78,6 +98,155 @@ gint Gtk_::timeout_add_callback(gpointer data) {
   return ret;
 }
 
+/**
+ * Resolve the fd behind a PHP stream
+ *
+ * The callback reads the descriptor directly, so streams that would not see the same bytes are
+ * refused: data already in the PHP read buffer, stream filters and TLS. Returns -1 for those and
+ * for streams without a descriptor
+ */
+static gint phpgtk_stream_to_fd(const Php::Value &stream, zval *stream_zval) {
+  if (Z_TYPE_P(stream_zval) != IS_RESOURCE) {
+    return -1;
+  }
+
+  php_stream *native = (php_stream *)zend_fetch_resource2(Z_RES_P(stream_zval), nullptr,
+                                                          php_file_le_stream(),
+                                                          php_file_le_pstream());
+  if (native == nullptr) {
+    return -1;
+  }
+
+  if (native->writepos > native->readpos || native->readfilters.head != nullptr ||
+      native->writefilters.head != nullptr) {
+    return -1;
+  }
+
+  Php::Value meta_data = Php::call("stream_get_meta_data", stream);
+  if (meta_data.contains("crypto")) {
+    return -1;
+  }
+
+  php_socket_t fd = -1;
+  if (php_stream_cast(native, PHP_STREAM_AS_FD_FOR_SELECT | PHP_STREAM_CAST_INTERNAL,
+                      (void **)&fd, 0) != SUCCESS) {
+    return -1;
+  }
+
+  return (gint)fd;
+}
+
+Php::Value Gtk_::io_add_watch(Php::Parameters &parameters) {
+  if (parameters.size() < 3) {
+    throw Php::Exception("Gtk::io_add_watch expects a stream or fd, the conditions and a callable");
+  }
+
+  if (!parameters[2].isCallable()) {
+    throw Php::Exception("Gtk::io_add_watch parameter 3 must be callable");
+  }
+
+  GIOCondition conditions = (GIOCondition)(int)parameters[1];
+
+  gint fd = -1;
+  if (parameters[0].isNumeric()) {
+    fd = (gint)parameters[0];
+  } else if (!parameters[0].isNull()) {
+    // The zval of the first argument, Php::Value does not expose it
+    fd = phpgtk_stream_to_fd(parameters[0], ZEND_CALL_ARG(EG(current_execute_data), 1));
+  }
+
+  if (fd < 0 || fcntl(fd, F_GETFD) == -1) {
+    throw Php::Exception(
+        "Gtk::io_add_watch: the stream is not backed by an open file descriptor, or is buffered, "
+        "filtered or encrypted");
+  }
+
+  // Create gpointer user data, released when the source is removed
+  struct st_io_watch *callback_object = new st_io_watch();
+  callback_object->callback_name = parameters[2];
+  callback_object->stream = parameters[0];
+  callback_object->fd = fd;
+  for (size_t i = 3; i < parameters.size(); i++) {
+    callback_object->user_parameters.push_back(parameters[i]);
+  }
+
+  guint ret = g_unix_fd_add_full(G_PRIORITY_DEFAULT, fd, conditions, io_watch_callback,
+                                 callback_object, phpgtk_closure::destroy);
+
+  return (int)ret;
+}
+
+gboolean Gtk_::io_watch_callback(gint fd, GIOCondition condition, gpointer data) {
+  struct st_io_watch *callback_object = (struct st_io_watch *)data;
+
+  // Drain what is readable now, one PHP call per wake-up
+  Php::Value chunk;
+  bool eof = false;
+  if (condition & (G_IO_IN | G_IO_PRI)) {
+    std::string buffer;
+    char read_buffer[PHPGTK_IO_CHUNK_SIZE];
+
+    while (buffer.size() < PHPGTK_IO_MAX_BATCH) {
+      ssize_t n_read = read(fd, read_buffer, sizeof(read_buffer));
+      if (n_read < 0 && errno == EINTR) {
+        continue;
+      }
+
+      if (n_read <= 0) {
+        eof = (n_read == 0);
+        break;
+      }
+
+      buffer.append(read_buffer, n_read);
+      if (n_read < (ssize_t)sizeof(read_buffer)) {
+        break;
+      }
+
+      // Only keep reading while more data is ready, the fd may be blocking
+      struct pollfd pfd = {fd, POLLIN, 0};
+      if (poll(&pfd, 1, 0) <= 0 || !(pfd.revents & POLLIN)) {
+        break;
+      }
+    }
+
+    chunk = buffer;
+  }
+
+  if (eof) {
+    condition = (GIOCondition)(condition | G_IO_HUP);
+  }
+
+  Php::Value internal_parameters;
+  internal_parameters[0] = callback_object->stream;
+  internal_parameters[1] = (int)condition;
+  internal_parameters[2] = chunk;
+  for (size_t i = 0; i < callback_object->user_parameters.size(); i++) {
+    internal_parameters[(int)i + 3] = callback_object->user_parameters[i];
+  }
+
+  Php::Value ret;
+  try {
+    phpgtk_profile_scope profile_scope(callback_object, "io");
+    ret = Php::call("call_user_func_array", callback_object->callback_name, internal_parameters);
+  } catch (Php::Exception &exception) {
+    // Re-throw to let PHP-CPP handle the exception properly
+    throw;
+  }
+
+  // Nothing more will come from a closed or broken fd. A hung up one wakes up forever: keep it
+  // only while it still has data to drain, the read then reaches end of file
+  bool drained = !(condition & (G_IO_IN | G_IO_PRI));
+  if (eof || (condition & (G_IO_ERR | G_IO_NVAL)) || ((condition & G_IO_HUP) && drained)) {
+    return G_SOURCE_REMOVE;
+  }
+
+  if (ret.type() == Php::Type::False) {
+    return G_SOURCE_REMOVE;
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
 Php::Value Gtk_::source_remove(Php::Parameters &parameters) {
   guint tag = (int)parameters[0];
 
@@ -131,6 +300,97 @@ Php::Value Gtk_::show_uri_on_window(Php::Parameters &parameters) {
   return ret;
 }
 
+void Gtk_::profiler_enable(Php::Parameters &parameters) {
+  double stall_threshold_ms = 16;
+  if (!parameters.empty()) {
+    stall_threshold_ms = parameters[0].floatValue();
+  }
+
+  int max_trace_events = 100000;
+  if (parameters.size() > 1) {
+    max_trace_events = parameters[1];
+  }
+
+  if (stall_threshold_ms < 0 || max_trace_events < 0) {
+    throw Php::Exception("Gtk::profiler_enable expects positive numbers");
+  }
+
+  phpgtk_profiler::enable((gint64)(stall_threshold_ms * 1000), (size_t)max_trace_events);
+}
+
+void Gtk_::profiler_disable() {
+  phpgtk_profiler::disable();
+}
+
+void Gtk_::profiler_reset() {
+  phpgtk_profiler::reset();
+}
+
+Php::Value Gtk_::profiler_report() {
+  return phpgtk_profiler::report();
+}
+
+Php::Value Gtk_::profiler_export_trace(Php::Parameters &parameters) {
+  std::string trace = phpgtk_profiler::trace_json();
+
+  if (parameters.empty() || parameters[0].isNull()) {
+    return Php::Value(trace.data(), (int)trace.size());
+  }
+
+  std::string s_path = parameters[0];
+  GError *error = nullptr;
+  if (!g_file_set_contents(s_path.c_str(), trace.data(), (gssize)trace.size(), &error)) {
+    std::string message = (error != nullptr) ? error->message : "unknown error";
+    if (error != nullptr) {
+      g_error_free(error);
+    }
+    throw Php::Exception("Gtk::profiler_export_trace: " + message);
+  }
+
+  return true;
+}
+
+void Gtk_::watchdog_enable(Php::Parameters &parameters) {
+  double threshold_ms = 200;
+  if (!parameters.empty()) {
+    threshold_ms = parameters[0].floatValue();
+  }
+
+  int capacity = 64;
+  if (parameters.size() > 1) {
+    capacity = parameters[1];
+  }
+
+  std::string log_path;
+  if (parameters.size() > 2 && !parameters[2].isNull()) {
+    log_path = parameters[2].stringValue();
+  }
+
+  if (threshold_ms <= 0 || capacity < 1) {
+    throw Php::Exception("Gtk::watchdog_enable expects a positive threshold and capacity");
+  }
+
+  phpgtk_watchdog::enable((gint64)(threshold_ms * 1000), (size_t)capacity, log_path);
+}
+
+void Gtk_::watchdog_disable() {
+  phpgtk_watchdog::disable();
+}
+
+Php::Value Gtk_::watchdog_reports() {
+  return phpgtk_watchdog::reports();
+}
+
+void Gtk_::watchdog_clear() {
+  phpgtk_watchdog::clear();
+}
+
+void Gtk_::watchdog_dump(Php::Parameters &parameters) {
+  std::string s_path = parameters[0];
+
+  phpgtk_watchdog::dump(s_path);
+}
+
 Php::Value Gtk_::events_pending() {
   return gtk_events_pending();
 }
@@ -196,6 +456,23 @@ Php::Value Gtk_::get_minor_version() {
   return (int)ret;
 }
 
+void Gtk_::resources_register(Php::Parameters &parameters) {
+  std::string s_file = parameters[0];
+
+  GError *error = nullptr;
+  GResource *resource = g_resource_load(s_file.c_str(), &error);
+
+  if (error != nullptr) {
+    std::string error_msg = error->message;
+    g_error_free(error);
+    throw Php::Exception("Failed to load resource bundle: " + error_msg);
+  }
+
+  // Registered resources live for the whole process
+  g_resources_register(resource);
+  g_resource_unref(resource);
+}
+
 void Gtk_::init() {
   gtk_init(nullptr, nullptr);
 }
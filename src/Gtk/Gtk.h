@@ -26,6 +26,7 @@ class Gtk_ : public Php::Base {
   GtkWidget *widget{};
 
   struct st_timeout_add;
+  struct st_io_watch;
 
   /**
    * Publics
@@ -54,12 +55,59 @@ class Gtk_ : public Php::Base {
   static Php::Value show_uri_on_window(Php::Parameters &parameters);
   static gint timeout_add_callback(gpointer data);
 
+  /**
+   * Watch a PHP stream or a raw fd from the main loop
+   *
+   * Gtk::io_add_watch($stream_or_fd, $conditions, callable $callback, ...$user_data)
+   * The callback receives ($stream_or_fd, $condition, $data, ...$user_data), where $data holds
+   * everything readable on this wake-up (null when G_IO_IN is not set). Returning false, end of
+   * file, G_IO_HUP or G_IO_ERR removes the watch. Returns the source id for Gtk::source_remove
+   *
+   * The fd is read directly: buffered, filtered and TLS streams are refused, and the stream must
+   * not also be read with fread() while watched
+   */
+  static Php::Value io_add_watch(Php::Parameters &parameters);
+  static gboolean io_watch_callback(gint fd, GIOCondition condition, gpointer data);
+
+  /**
+   * Profiler of the PHP handlers called from signals, timeouts and io watches
+   *
+   * Gtk::profiler_enable([$stall_threshold_ms = 16 [, $max_trace_events = 100000]])
+   * Gtk::profiler_report() rows of type, signal, handler, count, total/max/avg/stall ms, stalls
+   * Gtk::profiler_export_trace([$path]) Chrome trace JSON, written to $path when given
+   */
+  static void profiler_enable(Php::Parameters &parameters);
+  static void profiler_disable();
+  static void profiler_reset();
+  static Php::Value profiler_report();
+  static Php::Value profiler_export_trace(Php::Parameters &parameters);
+
+  /**
+   * Main loop stall watchdog
+   *
+   * Gtk::watchdog_enable([$threshold_ms = 200 [, $capacity = 64 [, $log_path]]])
+   * Gtk::watchdog_reports() rows of time, duration_ms, complete, signal, function, file, line
+   * Gtk::watchdog_dump($path) appends the reports to a log file
+   */
+  static void watchdog_enable(Php::Parameters &parameters);
+  static void watchdog_disable();
+  static Php::Value watchdog_reports();
+  static void watchdog_clear();
+  static void watchdog_dump(Php::Parameters &parameters);
+
   static Php::Value events_pending();
   static Php::Value main_do_event(Php::Parameters &parameters);
   static Php::Value main_iteration();
   static Php::Value get_major_version();
   static Php::Value get_micro_version();
   static Php::Value get_minor_version();
+
+  /**
+   * Load a compiled GResource bundle (glib-compile-resources) and register it for the process
+   *
+   * https://docs.gtk.org/gio/func.resources_register.html
+   */
+  static void resources_register(Php::Parameters &parameters);
   static void init();
 };
 
@@ -13,35 +13,23 @@ GtkApplication_::GtkApplication_() = default;
 GtkApplication_::~GtkApplication_() = default;
 
 void GtkApplication_::__construct(Php::Parameters &parameters) {
-  std::string s_application_id = parameters[0];
-  gchar *application_id = (gchar *)s_application_id.c_str();
-
-  // ----
-  phpgtk_check_parameter(parameters, 2, Php::Type::Numeric, TRUE, nullptr);
-  int int_flags = (int)parameters[1];
-  GApplicationFlags flags = (GApplicationFlags)int_flags;
+  // GApplication allows no id
+  const gchar *application_id = phpgtk_param_string_or_null(parameters, 1);
+  GApplicationFlags flags = phpgtk_param_integer<GApplicationFlags>(parameters, 2);
 
   instance = (gpointer *)gtk_application_new(application_id, flags);
 }
 
 void GtkApplication_::add_window(Php::Parameters &parameters) {
-  GtkWindow *window;
-  if (!parameters.empty()) {
-    Php::Value object_window = parameters[0];
-    GtkWindow_ *phpgtk_window = (GtkWindow_ *)object_window.implementation();
-    window = GTK_WINDOW(phpgtk_window->get_instance());
-  }
+  GtkWindow_ *phpgtk_window = phpgtk_param_object<GtkWindow_>(parameters, 1, "GtkWindow");
+  GtkWindow *window = GTK_WINDOW(phpgtk_window->get_instance());
 
   gtk_application_add_window(GTK_APPLICATION(instance), window);
 }
 
 void GtkApplication_::remove_window(Php::Parameters &parameters) {
-  GtkWindow *window;
-  if (!parameters.empty()) {
-    Php::Value object_window = parameters[0];
-    GtkWindow_ *phpgtk_window = (GtkWindow_ *)object_window.implementation();
-    window = GTK_WINDOW(phpgtk_window->get_instance());
-  }
+  GtkWindow_ *phpgtk_window = phpgtk_param_object<GtkWindow_>(parameters, 1, "GtkWindow");
+  GtkWindow *window = GTK_WINDOW(phpgtk_window->get_instance());
 
   gtk_application_remove_window(GTK_APPLICATION(instance), window);
 }
@@ -59,61 +47,58 @@ Php::Value GtkApplication_::get_windows() {
 }
 
 Php::Value GtkApplication_::get_window_by_id(Php::Parameters &parameters) {
-  guint id = (int)parameters[0];
+  guint id = phpgtk_param_integer<guint>(parameters, 1);
 
   GtkWindow *ret = gtk_application_get_window_by_id(GTK_APPLICATION(instance), id);
 
-  GtkWindow_ *return_parsed = new GtkWindow_();
-  return_parsed->set_instance((gpointer *)ret);
-  return Php::Object("GtkWindow", return_parsed);
+  if (ret == nullptr) {
+    return nullptr;
+  }
+
+  return cobject_to_phpobject((gpointer *)ret);
 }
 
 Php::Value GtkApplication_::get_active_window() {
   GtkWindow *ret = gtk_application_get_active_window(GTK_APPLICATION(instance));
 
-  GtkWindow_ *return_parsed = new GtkWindow_();
-  return_parsed->set_instance((gpointer *)ret);
-  return Php::Object("GtkWindow", return_parsed);
-}
-
-Php::Value GtkApplication_::inhibit(Php::Parameters &parameters) {
-  GtkWindow *window;
-  if (!parameters.empty()) {
-    Php::Value object_window = parameters[0];
-    GtkWindow_ *phpgtk_window = (GtkWindow_ *)object_window.implementation();
-    window = GTK_WINDOW(phpgtk_window->get_instance());
+  if (ret == nullptr) {
+    return nullptr;
   }
 
-  int int_flags = (int)parameters[1];
-  GtkApplicationInhibitFlags flags = (GtkApplicationInhibitFlags)int_flags;
+  return cobject_to_phpobject((gpointer *)ret);
+}
 
-  std::string s_reason = parameters[2];
-  gchar *reason = (gchar *)s_reason.c_str();
+Php::Value GtkApplication_::inhibit(Php::Parameters &parameters) {
+  GtkWindow_ *phpgtk_window = phpgtk_param_object<GtkWindow_>(parameters, 1, "GtkWindow");
+  GtkWindow *window = GTK_WINDOW(phpgtk_window->get_instance());
+  GtkApplicationInhibitFlags flags =
+      phpgtk_param_integer<GtkApplicationInhibitFlags>(parameters, 2);
+  const gchar *reason = phpgtk_param_string(parameters, 3);
 
-  int ret = gtk_application_inhibit(GTK_APPLICATION(instance), window, flags, reason);
+  guint ret = gtk_application_inhibit(GTK_APPLICATION(instance), window, flags, reason);
 
-  return ret;
+  return (int64_t)ret;
 }
 
 void GtkApplication_::uninhibit(Php::Parameters &parameters) {
-  guint cookie = (int)parameters[0];
+  guint cookie = phpgtk_param_integer<guint>(parameters, 1);
 
   gtk_application_uninhibit(GTK_APPLICATION(instance), cookie);
 }
 
 Php::Value GtkApplication_::is_inhibited(Php::Parameters &parameters) {
-  int int_flags = (int)parameters[0];
-  GtkApplicationInhibitFlags flags = (GtkApplicationInhibitFlags)int_flags;
+  GtkApplicationInhibitFlags flags =
+      phpgtk_param_integer<GtkApplicationInhibitFlags>(parameters, 1);
 
-  bool ret = gtk_application_is_inhibited(GTK_APPLICATION(instance), flags);
+  gboolean ret = gtk_application_is_inhibited(GTK_APPLICATION(instance), flags);
 
-  return ret;
+  return (bool)ret;
 }
 
 Php::Value GtkApplication_::prefers_app_menu() {
-  bool ret = gtk_application_prefers_app_menu(GTK_APPLICATION(instance));
+  gboolean ret = gtk_application_prefers_app_menu(GTK_APPLICATION(instance));
 
-  return ret;
+  return (bool)ret;
 }
 
 Php::Value GtkApplication_::get_app_menu() {
@@ -182,19 +167,30 @@ void GtkApplication_::remove_accelerator(Php::Parameters &parameters) {
 }
 
 Php::Value GtkApplication_::list_action_descriptions() {
-  std::string ret = *gtk_application_list_action_descriptions(GTK_APPLICATION(instance));
+  gchar **ret = gtk_application_list_action_descriptions(GTK_APPLICATION(instance));
+
+  Php::Array ret_arr;
+  for (int i = 0; ret != nullptr && ret[i] != nullptr; i++) {
+    ret_arr[i] = ret[i];
+  }
+  g_strfreev(ret);
 
-  return ret;
+  return ret_arr;
 }
 
 Php::Value GtkApplication_::get_accels_for_action(Php::Parameters &parameters) {
-  std::string s_detailed_action_name = parameters[0];
-  gchar *detailed_action_name = (gchar *)s_detailed_action_name.c_str();
+  const gchar *detailed_action_name = phpgtk_param_string(parameters, 1);
 
-  std::string ret =
-      *gtk_application_get_accels_for_action(GTK_APPLICATION(instance), detailed_action_name);
+  gchar **ret = gtk_application_get_accels_for_action(GTK_APPLICATION(instance),
+                                                      detailed_action_name);
 
-  return ret;
+  Php::Array ret_arr;
+  for (int i = 0; ret != nullptr && ret[i] != nullptr; i++) {
+    ret_arr[i] = ret[i];
+  }
+  g_strfreev(ret);
+
+  return ret_arr;
 }
 
 void GtkApplication_::set_accels_for_action(Php::Parameters &parameters) {
@@ -213,18 +209,17 @@ void GtkApplication_::set_accels_for_action(Php::Parameters &parameters) {
 }
 
 Php::Value GtkApplication_::get_actions_for_accel(Php::Parameters &parameters) {
-  // std::string s_accel = parameters[0];
+  const gchar *accel = phpgtk_param_string(parameters, 1);
 
-  // gchar* a = (gchar*)s_accel.c_str();
-  // const gchar*  b = (const gchar* )a;
-
-  // std::string ret = *gtk_application_get_actions_for_accel (GTK_APPLICATION(instance), b);
-
-  // return ret;
+  gchar **ret = gtk_application_get_actions_for_accel(GTK_APPLICATION(instance), accel);
 
-  Php::deprecated << "GtkApplication_::get_actions_for_accel not implemented";
+  Php::Array ret_arr;
+  for (int i = 0; ret != nullptr && ret[i] != nullptr; i++) {
+    ret_arr[i] = ret[i];
+  }
+  g_strfreev(ret);
 
-  return 1;
+  return ret_arr;
 }
 
 Php::Value GtkApplication_::window_new() {
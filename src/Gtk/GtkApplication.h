@@ -13,6 +13,10 @@
 /**
  * GtkApplication_
  *
+ * The methods whose prototype gen/run.php can express are its output: arguments are checked
+ * and read by the typed readers of PhpParam.h, strings without copy. The others are written by
+ * hand
+ *
  * https://developer.gnome.org/gtk3/stable/GtkApplication.html
  */
 class GtkApplication_ : public GApplication_ {
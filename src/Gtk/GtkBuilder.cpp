@@ -1,6 +1,88 @@
 
 #include "GtkBuilder.h"
 
+#include <glib/gstdio.h>
+
+#include <cerrno>
+
+/**
+ * Resource prefix used to look up .ui files embedded in a registered bundle
+ */
+#define PHPGTK_BUILDER_UI_RESOURCE_PREFIX "/php-gtk3/ui/"
+
+/**
+ * Files kept in the UI cache, the least recently used one is dropped first
+ */
+#define PHPGTK_BUILDER_UI_CACHE_MAX 64
+
+/**
+ * Cached .ui markup of one file
+ */
+struct st_ui_cache_entry {
+  gint64 mtime;
+  gint64 size;
+  guint64 last_used;
+  GBytes *markup;
+};
+
+/**
+ * .ui markup read by this process, keyed by path
+ */
+static std::map<std::string, st_ui_cache_entry> ui_cache;
+
+/**
+ * Use counter of the UI cache
+ */
+static guint64 ui_cache_clock = 0;
+
+/**
+ * Return the cached markup of the file, reading it again only when it changed, nullptr when the
+ * file cannot be read. The caller owns the returned reference
+ */
+static GBytes *phpgtk_builder_cached_markup(const std::string &filename, GError **error) {
+  GStatBuf st;
+  if (g_stat(filename.c_str(), &st) != 0) {
+    g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(errno), "Failed to read UI file %s",
+                filename.c_str());
+    return nullptr;
+  }
+
+  std::map<std::string, st_ui_cache_entry>::iterator it = ui_cache.find(filename);
+  if (it != ui_cache.end() && it->second.mtime == (gint64)st.st_mtime &&
+      it->second.size == (gint64)st.st_size) {
+    it->second.last_used = ++ui_cache_clock;
+    return g_bytes_ref(it->second.markup);
+  }
+
+  gchar *contents = nullptr;
+  gsize length = 0;
+  if (!g_file_get_contents(filename.c_str(), &contents, &length, error)) {
+    return nullptr;
+  }
+
+  if (it != ui_cache.end()) {
+    g_bytes_unref(it->second.markup);
+    ui_cache.erase(it);
+  } else if (ui_cache.size() >= PHPGTK_BUILDER_UI_CACHE_MAX) {
+    std::map<std::string, st_ui_cache_entry>::iterator oldest = ui_cache.begin();
+    for (it = ui_cache.begin(); it != ui_cache.end(); ++it) {
+      if (it->second.last_used < oldest->second.last_used) {
+        oldest = it;
+      }
+    }
+    g_bytes_unref(oldest->second.markup);
+    ui_cache.erase(oldest);
+  }
+
+  st_ui_cache_entry &entry = ui_cache[filename];
+  entry.mtime = (gint64)st.st_mtime;
+  entry.size = (gint64)st.st_size;
+  entry.last_used = ++ui_cache_clock;
+  entry.markup = g_bytes_new_take(contents, length);
+
+  return g_bytes_ref(entry.markup);
+}
+
 /**
  * Constructor
  */
@@ -16,8 +98,8 @@ void GtkBuilder_::__construct() {
 }
 
 Php::Value GtkBuilder_::new_from_file(Php::Parameters &parameters) {
-  std::string s_filename = parameters[0];
-  gchar *filename = (gchar *)s_filename.c_str();
+  phpgtk_string s_filename(parameters[0]);
+  const gchar *filename = s_filename.c_str();
 
   GtkBuilder *builder = gtk_builder_new_from_file(filename);
 
@@ -27,8 +109,8 @@ Php::Value GtkBuilder_::new_from_file(Php::Parameters &parameters) {
 }
 
 Php::Value GtkBuilder_::new_from_resource(Php::Parameters &parameters) {
-  std::string s_resource_path = parameters[0];
-  gchar *resource_path = (gchar *)s_resource_path.c_str();
+  phpgtk_string s_resource_path(parameters[0]);
+  const gchar *resource_path = s_resource_path.c_str();
 
   GtkBuilder *builder = gtk_builder_new_from_resource(resource_path);
 
@@ -38,10 +120,10 @@ Php::Value GtkBuilder_::new_from_resource(Php::Parameters &parameters) {
 }
 
 Php::Value GtkBuilder_::new_from_string(Php::Parameters &parameters) {
-  std::string s_string = parameters[0];
-  gchar *string = (gchar *)s_string.c_str();
+  phpgtk_string s_string(parameters[0]);
+  const gchar *string = s_string.c_str();
 
-  GtkBuilder *builder = gtk_builder_new_from_string(string, s_string.length());
+  GtkBuilder *builder = gtk_builder_new_from_string(string, s_string.size());
 
   GtkBuilder_ *phpgtk_builder = new GtkBuilder_();
   phpgtk_builder->set_instance((gpointer *)builder);
@@ -82,8 +164,8 @@ void GtkBuilder_::lookup_callback_symbol(Php::Parameters &parameters) {
 }
 
 Php::Value GtkBuilder_::add_from_file(Php::Parameters &parameters) {
-  std::string s_filename = parameters[0];
-  gchar *filename = (gchar *)s_filename.c_str();
+  phpgtk_string s_filename(parameters[0]);
+  const gchar *filename = s_filename.c_str();
 
   GError *err = nullptr;
 
@@ -93,8 +175,8 @@ Php::Value GtkBuilder_::add_from_file(Php::Parameters &parameters) {
 }
 
 Php::Value GtkBuilder_::add_from_resource(Php::Parameters &parameters) {
-  std::string s_resource_path = parameters[0];
-  gchar *resource_path = (gchar *)s_resource_path.c_str();
+  phpgtk_string s_resource_path(parameters[0]);
+  const gchar *resource_path = s_resource_path.c_str();
 
   GError *err = nullptr;
 
@@ -104,16 +186,71 @@ Php::Value GtkBuilder_::add_from_resource(Php::Parameters &parameters) {
 }
 
 Php::Value GtkBuilder_::add_from_string(Php::Parameters &parameters) {
-  std::string s_buffer = parameters[0];
-  gchar *buffer = (gchar *)s_buffer.c_str();
+  phpgtk_string s_buffer(parameters[0]);
+  const gchar *buffer = s_buffer.c_str();
+
+  GError *err = nullptr;
+
+  int ret = gtk_builder_add_from_string(GTK_BUILDER(instance), buffer, s_buffer.size(), &err);
+
+  return ret;
+}
+
+Php::Value GtkBuilder_::new_from_file_cached(Php::Parameters &parameters) {
+  GtkBuilder_ *phpgtk_builder = new GtkBuilder_();
+  phpgtk_builder->set_instance((gpointer *)gtk_builder_new());
+  Php::Value ret = Php::Object("GtkBuilder", phpgtk_builder);
+
+  phpgtk_builder->add_from_file_cached(parameters);
+
+  return ret;
+}
+
+Php::Value GtkBuilder_::add_from_file_cached(Php::Parameters &parameters) {
+  std::string s_filename = parameters[0];
 
   GError *err = nullptr;
 
-  int ret = gtk_builder_add_from_string(GTK_BUILDER(instance), buffer, s_buffer.length(), &err);
+  // An embedded copy, preprocessed when the bundle was compiled, needs no file access
+  gchar *basename = g_path_get_basename(s_filename.c_str());
+  std::string resource_path = std::string(PHPGTK_BUILDER_UI_RESOURCE_PREFIX) + basename;
+  g_free(basename);
+  if (g_resources_get_info(resource_path.c_str(), G_RESOURCE_LOOKUP_FLAGS_NONE, nullptr, nullptr,
+                           nullptr)) {
+    int ret = gtk_builder_add_from_resource(GTK_BUILDER(instance), resource_path.c_str(), &err);
+    if (err != nullptr) {
+      g_error_free(err);
+    }
+
+    return ret;
+  }
+
+  GBytes *markup = phpgtk_builder_cached_markup(s_filename, &err);
+  if (markup == nullptr) {
+    g_error_free(err);
+    return 0;
+  }
+
+  gsize length = 0;
+  const gchar *data = (const gchar *)g_bytes_get_data(markup, &length);
+  int ret = gtk_builder_add_from_string(GTK_BUILDER(instance), data, length, &err);
+  g_bytes_unref(markup);
+
+  if (err != nullptr) {
+    g_error_free(err);
+  }
 
   return ret;
 }
 
+void GtkBuilder_::clear_cache() {
+  for (std::map<std::string, st_ui_cache_entry>::iterator it = ui_cache.begin();
+       it != ui_cache.end(); ++it) {
+    g_bytes_unref(it->second.markup);
+  }
+  ui_cache.clear();
+}
+
 Php::Value GtkBuilder_::add_objects_from_file(Php::Parameters &parameters) {
   // std::string s_buffer = parameters[0];
   // gchar *buffer = (gchar *)s_buffer.c_str();
@@ -173,27 +310,88 @@ Php::Value GtkBuilder_::extend_with_template(Php::Parameters &parameters) {
   throw Php::Exception("GtkBuilder_::extend_with_template not implemented");
 }
 
-Php::Value GtkBuilder_::get_object(Php::Parameters &parameters) {
-  std::string s_name = parameters[0];
-  gchar *name = (gchar *)s_name.c_str();
+/**
+ * Return the cached wrapper of the object, creating it on first use
+ */
+Php::Value GtkBuilder_::wrap_object(const gchar *name, GObject *object) {
+  name = g_intern_string(name);
 
-  GObject *object = gtk_builder_get_object(GTK_BUILDER(instance), name);
+  std::map<const gchar *, Php::Value>::iterator it = object_cache.find(name);
+  if (it != object_cache.end()) {
+    return it->second;
+  }
 
   // Get name of gType
-  std::string gtype_name = g_type_name(G_TYPE_FROM_INSTANCE(object));
+  const gchar *gtype_name = g_type_name(G_TYPE_FROM_INSTANCE(object));
 
   // Return PHPGTK Object
   GObject_ *phpgtk_widget = new GObject_();
   phpgtk_widget->set_instance((gpointer *)object);
-  return Php::Object(gtype_name.c_str(), phpgtk_widget);
+  Php::Value ret = Php::Object(gtype_name, phpgtk_widget);
+
+  // Objects are kept by the builder, so the wrapper stays valid
+  object_cache[name] = ret;
+
+  return ret;
 }
 
+Php::Value GtkBuilder_::get_object(Php::Parameters &parameters) {
+  phpgtk_string s_name(parameters[0]);
+  const gchar *name = s_name.c_str();
+
+  GObject *object = gtk_builder_get_object(GTK_BUILDER(instance), name);
+  if (object == nullptr) {
+    return nullptr;
+  }
+
+  return wrap_object(name, object);
+}
+
+/**
+ * Return all named objects, keyed by id
+ */
 Php::Value GtkBuilder_::get_objects() {
-  // GObject ret = gtk_builder_get_objects (GTK_BUILDER(instance));
+  Php::Value ret = Php::Array();
 
-  // return ret;
+  GSList *objects = gtk_builder_get_objects(GTK_BUILDER(instance));
+  for (GSList *item = objects; item != nullptr; item = item->next) {
+    GObject *object = G_OBJECT(item->data);
+    if (!GTK_IS_BUILDABLE(object)) {
+      continue;
+    }
+
+    // Objects without id get an internal "___object_N___" name
+    const gchar *name = gtk_buildable_get_name(GTK_BUILDABLE(object));
+    if (name == nullptr || g_str_has_prefix(name, "___object_")) {
+      continue;
+    }
+
+    ret[name] = wrap_object(name, object);
+  }
+  g_slist_free(objects);
+
+  return ret;
+}
+
+Php::Value GtkBuilder_::bind_objects(Php::Parameters &parameters) {
+  if (parameters.empty() || !parameters[0].isObject()) {
+    throw Php::Exception("GtkBuilder::bind_objects requires a view object");
+  }
+
+  Php::Value view = parameters[0];
+  Php::Value objects = get_objects();
+
+  int bound = 0;
+  for (auto &iter : objects) {
+    if (!Php::call("property_exists", view, iter.first).boolValue()) {
+      continue;
+    }
 
-  throw Php::Exception("GtkBuilder_::get_objects not implemented");
+    view.set(iter.first.stringValue(), iter.second);
+    bound++;
+  }
+
+  return bound;
 }
 
 void GtkBuilder_::expose_object(Php::Parameters &parameters) {
@@ -229,28 +427,25 @@ void GtkBuilder_::connect_signals_full(Php::Parameters &parameters) {
 /**
  * Struct for callback gpointer
  */
-struct GtkBuilder_::st_callback {
-  Php::Value callback_name;
+struct GtkBuilder_::st_callback : public phpgtk_closure {
   Php::Array callback_params;
-  Php::Object self_widget;
-  Php::Parameters parameters;
-
-  guint signal_id;
-  const gchar *signal_name;
-  GType itype;
-  GSignalFlags signal_flags;
-  GType return_type;
-  guint n_params;
-  const GType *param_types;
+  std::vector<Php::Value> parameters;
+
+  guint signal_id{};
+  const gchar *signal_name{};
+  GType itype{};
+  GSignalFlags signal_flags{};
+  GType return_type{};
+  guint n_params{};
+  const GType *param_types{};
 };
 
 void GtkBuilder_::connect_signals_full_callback(GtkBuilder *builder, GObject *instance,
                                                 const gchar *signal_name, const char *handler_name,
                                                 GObject *object, GConnectFlags flags,
                                                 gpointer data) {
-  // Create gpoint param
-  struct st_callback *callback_object = (struct st_callback *)malloc(sizeof(struct st_callback));
-  memset(callback_object, 0, sizeof(struct st_callback));
+  // Create gpoint param, released with the closure
+  struct st_callback *callback_object = new st_callback();
 
   // Add my internal parameters
   callback_object->callback_name = handler_name;
@@ -260,6 +455,7 @@ void GtkBuilder_::connect_signals_full_callback(GtkBuilder *builder, GObject *in
 
   // Retriave and store signal query parameters , to be used on callback
   GSignalQuery signal_info;
+  memset(&signal_info, 0, sizeof(GSignalQuery));
 
   if (G_IS_OBJECT(instance)) {
     g_signal_query(g_signal_lookup(signal_name, G_OBJECT_TYPE(instance)), &signal_info);
@@ -279,8 +475,8 @@ void GtkBuilder_::connect_signals_full_callback(GtkBuilder *builder, GObject *in
 
   // Connect
   GClosure *closure;
-  closure =
-      g_cclosure_new_swap(G_CALLBACK(connect_signals_full_callback1), callback_object, nullptr);
+  closure = g_cclosure_new_swap(G_CALLBACK(connect_signals_full_callback1), callback_object,
+                                phpgtk_closure::closure_notify);
   g_signal_connect_closure(instance, signal_name, closure, TRUE);
 }
 
@@ -396,6 +592,93 @@ void GtkBuilder_::connect_signals_full_callback1(gpointer user_data, ...) {
   }
 }
 
+/**
+ * State of one connect_signals_to() pass
+ */
+struct GtkBuilder_::st_dispatch {
+  GtkBuilder_ *self;
+  Php::Value handler;
+
+  // Handler name => [handler, method], or null when the method does not exist
+  std::map<std::string, Php::Value> table;
+
+  int connected;
+};
+
+Php::Value GtkBuilder_::connect_signals_to(Php::Parameters &parameters) {
+  if (parameters.empty() || !parameters[0].isObject()) {
+    throw Php::Exception("GtkBuilder::connect_signals_to requires a handler object");
+  }
+
+  st_dispatch dispatch;
+  dispatch.self = this;
+  dispatch.handler = parameters[0];
+  dispatch.connected = 0;
+
+  gtk_builder_connect_signals_full(GTK_BUILDER(instance), connect_signals_to_callback, &dispatch);
+
+  return dispatch.connected;
+}
+
+void GtkBuilder_::connect_signals_to_callback(GtkBuilder *builder, GObject *object,
+                                              const gchar *signal_name, const char *handler_name,
+                                              GObject *connect_object, GConnectFlags flags,
+                                              gpointer data) {
+  st_dispatch *dispatch = (st_dispatch *)data;
+
+  // Resolve each handler name once
+  std::map<std::string, Php::Value>::iterator it = dispatch->table.find(handler_name);
+  if (it == dispatch->table.end()) {
+    Php::Value callback;
+    if (Php::call("method_exists", dispatch->handler, handler_name).boolValue()) {
+      callback[0] = dispatch->handler;
+      callback[1] = handler_name;
+    } else {
+      std::string class_name = Php::call("get_class", dispatch->handler).stringValue();
+      Php::warning << "GtkBuilder::connect_signals_to: handler " << handler_name
+                   << " is not a method of " << class_name << std::flush;
+    }
+
+    it = dispatch->table.insert(std::make_pair(std::string(handler_name), callback)).first;
+  }
+
+  if (it->second.isNull()) {
+    return;
+  }
+
+  // PHP object of a builder object, the cached wrapper when it has an id
+  auto wrap = [dispatch](GObject *builder_object) -> Php::Value {
+    const gchar *name = GTK_IS_BUILDABLE(builder_object)
+                            ? gtk_buildable_get_name(GTK_BUILDABLE(builder_object))
+                            : nullptr;
+    if (name != nullptr) {
+      return dispatch->self->wrap_object(name, builder_object);
+    }
+
+    return cobject_to_phpobject((gpointer *)builder_object);
+  };
+
+  // Same order as gtk_builder_connect_signals(): the "object" attribute of <signal> is the user
+  // data, last, and swapped="yes" exchanges it with the emitter. Without "object", the handler
+  // object stands for the user data of a swapped handler
+  Php::Value self_widget = wrap(object);
+
+  // Laid out like the parameters of GObject::connect, extra values start at index 2
+  std::vector<Php::Value> user_parameters(2);
+
+  if (flags & G_CONNECT_SWAPPED) {
+    user_parameters.push_back(self_widget);
+    self_widget = (connect_object != nullptr) ? wrap(connect_object) : dispatch->handler;
+  } else if (connect_object != nullptr) {
+    user_parameters.push_back(wrap(connect_object));
+  }
+
+  GObject_::connect_php_callback(object, signal_name, it->second, self_widget, user_parameters,
+                                 (flags & G_CONNECT_AFTER) != 0);
+
+  dispatch->connected++;
+}
+
 void GtkBuilder_::set_translation_domain(Php::Parameters &parameters) {
   // std::string s_domain = parameters[0];
   // gchar *domain = (gchar *)s_domain.c_str();
@@ -438,8 +721,8 @@ void GtkBuilder_::set_application(Php::Parameters &parameters) {
 }
 
 Php::Value GtkBuilder_::get_type_from_name(Php::Parameters &parameters) {
-  std::string s_type_name = parameters[0];
-  gchar *type_name = (gchar *)s_type_name.c_str();
+  phpgtk_string s_type_name(parameters[0]);
+  const gchar *type_name = s_type_name.c_str();
 
   GType ret = gtk_builder_get_type_from_name(GTK_BUILDER(instance), type_name);
 
@@ -5,6 +5,7 @@
 #include <phpcpp.h>
 #include <gtk/gtk.h>
 
+#include <map>
 #include <sstream>
 #include <string>
 
@@ -23,6 +24,14 @@ class GtkBuilder_ : public GObject_ {
    */
  private:
   struct st_callback;
+  struct st_dispatch;
+
+  /**
+   * PHP wrappers already returned, keyed by interned object id
+   */
+  std::map<const gchar *, Php::Value> object_cache;
+
+  Php::Value wrap_object(const gchar *name, GObject *object);
 
   /**
    * Publics
@@ -54,6 +63,20 @@ class GtkBuilder_ : public GObject_ {
 
   Php::Value add_from_string(Php::Parameters &parameters);
 
+  /**
+   * Load .ui files through the process-wide UI cache
+   *
+   * A copy embedded in a registered bundle (Gtk::resources_register()) under
+   * /php-gtk3/ui/<basename> is loaded first, so compiling the .ui files with
+   * preprocess="xml-stripblanks" skips the file access and the blank text at load time.
+   * Otherwise each file is read once per path and mtime, later loads replay the cached markup
+   * without reading the file again; GtkBuilder still parses it. Up to 64 files are kept. Like
+   * add_from_file(), returns 0 on error
+   */
+  static Php::Value new_from_file_cached(Php::Parameters &parameters);
+  Php::Value add_from_file_cached(Php::Parameters &parameters);
+  static void clear_cache();
+
   Php::Value add_objects_from_file(Php::Parameters &parameters);
 
   Php::Value add_objects_from_string(Php::Parameters &parameters);
@@ -66,6 +89,13 @@ class GtkBuilder_ : public GObject_ {
 
   Php::Value get_objects();
 
+  /**
+   * Assign every named object to the property of the same name on a PHP view object
+   *
+   * Only properties declared by the view are bound. Returns the number of bound properties
+   */
+  Php::Value bind_objects(Php::Parameters &parameters);
+
   void expose_object(Php::Parameters &parameters);
 
   void connect_signals(Php::Parameters &parameters);
@@ -77,6 +107,19 @@ class GtkBuilder_ : public GObject_ {
                                             gpointer data);
   static void connect_signals_full_callback1(gpointer user_data, ...);
 
+  /**
+   * Autoconnect every handler of the UI to the method of the same name of a handler object
+   *
+   * Handler names are resolved against the object once, into a dispatch table, and connected
+   * with GObject::connect semantics (closures released with the object). Returns the number of
+   * connected signals, missing methods raise one warning each
+   */
+  Php::Value connect_signals_to(Php::Parameters &parameters);
+  static void connect_signals_to_callback(GtkBuilder *builder, GObject *object,
+                                          const gchar *signal_name, const char *handler_name,
+                                          GObject *connect_object, GConnectFlags flags,
+                                          gpointer data);
+
   void set_translation_domain(Php::Parameters &parameters);
 
   Php::Value get_translation_domain();
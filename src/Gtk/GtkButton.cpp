@@ -16,8 +16,8 @@ void GtkButton_::__construct() {
 }
 
 Php::Value GtkButton_::new_with_label(Php::Parameters &parameters) {
-  std::string s_label = parameters[0];
-  gchar *label = (gchar *)s_label.c_str();
+  phpgtk_string s_label(parameters[0]);
+  const gchar *label = s_label.c_str();
 
   GtkWidget *ret = gtk_button_new_with_label(label);
 
@@ -27,8 +27,8 @@ Php::Value GtkButton_::new_with_label(Php::Parameters &parameters) {
 }
 
 Php::Value GtkButton_::new_with_mnemonic(Php::Parameters &parameters) {
-  std::string s_label = parameters[0];
-  gchar *label = (gchar *)s_label.c_str();
+  phpgtk_string s_label(parameters[0]);
+  const gchar *label = s_label.c_str();
 
   GtkWidget *ret = gtk_button_new_with_mnemonic(label);
 
@@ -38,8 +38,8 @@ Php::Value GtkButton_::new_with_mnemonic(Php::Parameters &parameters) {
 }
 
 Php::Value GtkButton_::new_from_icon_name(Php::Parameters &parameters) {
-  std::string s_icon_name = parameters[0];
-  gchar *icon_name = (gchar *)s_icon_name.c_str();
+  phpgtk_string s_icon_name(parameters[0]);
+  const gchar *icon_name = s_icon_name.c_str();
 
   int int_size = (int)parameters[1];
   GtkIconSize size = (GtkIconSize)int_size;
@@ -105,8 +105,8 @@ Php::Value GtkButton_::get_label() {
 }
 
 void GtkButton_::set_label(Php::Parameters &parameters) {
-  std::string s_label = parameters[0];
-  gchar *label = (gchar *)s_label.c_str();
+  phpgtk_string s_label(parameters[0]);
+  const gchar *label = s_label.c_str();
 
   gtk_button_set_label(GTK_BUTTON(instance), label);
 }
@@ -1,12 +1,19 @@
 
 #include "GtkClipboard.h"
 
+#include <memory>
+
 /**
  * Struct for callback gpointer
  */
-struct GtkClipboard_::st_request_callback {
-  Php::Parameters user_parameters;
-  Php::Object self_widget;
+struct GtkClipboard_::st_request_callback : public phpgtk_closure {};
+
+/**
+ * Struct for the set_with_data provider, alive while the clipboard holds our data
+ */
+struct GtkClipboard_::st_provider : public phpgtk_closure {
+  Php::Value clear_callback;
+  std::vector<std::string> targets;
 };
 
 /**
@@ -56,21 +63,112 @@ Php::Value GtkClipboard_::get_display() {
 }
 
 Php::Value GtkClipboard_::set_with_data(Php::Parameters &parameters) {
-  // GtkTargetEntry *targets;
-  // if(parameters.size() > 0) {
-  // 	Php::Value object_targets = parameters[0];
-  // 	GtkTargetEntry_ *phpgtk_targets = (GtkTargetEntry_ *)object_targets.implementation();
-  // 	targets = GTK_WIDGET(phpgtk_targets->get_instance());
-  // }
+  if (parameters.size() < 2 || !parameters[0].isArray() || !parameters[1].isCallable()) {
+    throw Php::Exception("GtkClipboard::set_with_data expects an array of targets and a callable");
+  }
 
-  // guint n_targets = (guint)parameters[1];
+  // Create the provider state, released by provider_clear_callback
+  struct st_provider *provider = new st_provider();
+  provider->callback_name = parameters[1];
+  provider->self_widget = Php::Object("GtkClipboard", this);
+  if (parameters.size() > 2) {
+    provider->clear_callback = parameters[2];
+  }
+  for (size_t i = 3; i < parameters.size(); i++) {
+    provider->user_parameters.push_back(parameters[i]);
+  }
 
-  // gboolean ret = gtk_clipboard_set_with_data (GTK_CLIPBOARD(instance), targets, n_targets);
+  Php::Value targets_value = parameters[0];
+  for (auto &iter : targets_value) {
+    provider->targets.push_back(iter.second.stringValue());
+  }
 
-  // return ret;
+  std::vector<GtkTargetEntry> entries;
+  for (size_t i = 0; i < provider->targets.size(); i++) {
+    GtkTargetEntry entry;
+    entry.target = (gchar *)provider->targets[i].c_str();
+    entry.flags = 0;
+    entry.info = (guint)i;
+    entries.push_back(entry);
+  }
 
-  throw Php::Exception("tkClipboard_::set_with_data not implemented");
-  return -1;
+  gboolean ret =
+      gtk_clipboard_set_with_data(GTK_CLIPBOARD(instance), entries.data(), (guint)entries.size(),
+                                  provider_get_callback, provider_clear_callback, provider);
+
+  // GTK ignores the callbacks on failure, so nothing else will release the state
+  if (!ret) {
+    delete provider;
+  }
+
+  return (bool)ret;
+}
+
+void GtkClipboard_::provider_get_callback(GtkClipboard *clipboard,
+                                          GtkSelectionData *selection_data, guint info,
+                                          gpointer user_data) {
+  struct st_provider *provider = (struct st_provider *)user_data;
+  if (info >= provider->targets.size()) {
+    return;
+  }
+
+  Php::Value internal_parameters;
+  internal_parameters[0] = provider->self_widget;
+  internal_parameters[1] = provider->targets[info];
+  for (size_t i = 0; i < provider->user_parameters.size(); i++) {
+    internal_parameters[(int)i + 2] = provider->user_parameters[i];
+  }
+
+  Php::Value ret;
+  try {
+    ret = Php::call("call_user_func_array", provider->callback_name, internal_parameters);
+  } catch (Php::Exception &exception) {
+    // Re-throw to let PHP-CPP handle the exception properly
+    throw;
+  }
+
+  if (ret.isNull() || ret.type() == Php::Type::False) {
+    return;
+  }
+
+  // Strings are used as is, iterables (generators too) are joined chunk by chunk
+  std::string data;
+  if (ret.isString()) {
+    data = ret.stringValue();
+  } else {
+    for (auto &chunk : ret) {
+      data.append(chunk.second.stringValue());
+    }
+  }
+
+  GdkAtom target = gtk_selection_data_get_target(selection_data);
+  GdkAtom text_targets[] = {target};
+  if (gtk_targets_include_text(text_targets, 1)) {
+    gtk_selection_data_set_text(selection_data, data.c_str(), (gint)data.size());
+  } else {
+    gtk_selection_data_set(selection_data, target, 8, (const guchar *)data.data(),
+                           (gint)data.size());
+  }
+}
+
+void GtkClipboard_::provider_clear_callback(GtkClipboard *clipboard, gpointer user_data) {
+  struct st_provider *provider = (struct st_provider *)user_data;
+  std::unique_ptr<st_provider> provider_guard(provider);
+
+  if (provider->clear_callback.isCallable()) {
+    Php::Value internal_parameters;
+    internal_parameters[0] = provider->self_widget;
+    for (size_t i = 0; i < provider->user_parameters.size(); i++) {
+      internal_parameters[(int)i + 1] = provider->user_parameters[i];
+    }
+
+    try {
+      Php::call("call_user_func_array", provider->clear_callback, internal_parameters);
+    } catch (Php::Exception &exception) {
+      // Re-throw to let PHP-CPP handle the exception properly
+      throw;
+    }
+  }
 }
 
 Php::Value GtkClipboard_::set_with_owner(Php::Parameters &parameters) {
@@ -127,103 +225,185 @@ void GtkClipboard_::set_image(Php::Parameters &parameters) {
   gtk_clipboard_set_image(GTK_CLIPBOARD(instance), pixbuf);
 }
 
-void GtkClipboard_::request_contents(Php::Parameters &parameters) {
-  // std::string s_user_function = parameters[0];
-  // gchar *user_function = (gchar *)s_user_function.c_str();
+GtkClipboard_::st_request_callback *GtkClipboard_::new_request_callback(
+    Php::Parameters &parameters, size_t offset) {
+  if (parameters.size() <= offset || !parameters[offset].isCallable()) {
+    throw Php::Exception("GtkClipboard: the request callback must be callable");
+  }
 
-  // gpointer user_data = (gpointer)parameters[1];
+  // Released by the callback, requests are one shot
+  struct st_request_callback *callback_object = new st_request_callback();
+  callback_object->callback_name = parameters[offset];
+  callback_object->self_widget = Php::Object("GtkClipboard", this);
+  for (size_t i = offset + 1; i < parameters.size(); i++) {
+    callback_object->user_parameters.push_back(parameters[i]);
+  }
 
-  // gtk_clipboard_request_contents (GTK_CLIPBOARD(instance), user_function, user_data);
+  return callback_object;
+}
 
-  throw Php::Exception("tkClipboard_::request_contents not implemented");
+void GtkClipboard_::invoke_request_callback(st_request_callback *callback_object,
+                                            const std::vector<Php::Value> &payload) {
+  // Create internal params, GtkClipboard + payload + user_data...
+  Php::Value internal_parameters;
+  int index = 0;
+  internal_parameters[index++] = callback_object->self_widget;
+  for (auto &value : payload) {
+    internal_parameters[index++] = value;
+  }
+  for (auto &value : callback_object->user_parameters) {
+    internal_parameters[index++] = value;
+  }
+
+  // Call php function with parameters
+  // Wrap in try-catch to properly handle exceptions from PHP callbacks
+  try {
+    Php::call("call_user_func_array", callback_object->callback_name, internal_parameters);
+  } catch (Php::Exception &exception) {
+    // Re-throw to let PHP-CPP handle the exception properly
+    throw;
+  }
 }
 
-void GtkClipboard_::request_text(Php::Parameters &parameters) {
-  // std::string s_user_function = parameters[0];
-  // gchar *user_function = (gchar *)s_user_function.c_str();
+void GtkClipboard_::request_contents(Php::Parameters &parameters) {
+  std::string s_target = parameters[0];
+  GdkAtom target = gdk_atom_intern(s_target.c_str(), FALSE);
 
-  // gpointer user_data = (gpointer)parameters[1];
+  gtk_clipboard_request_contents(GTK_CLIPBOARD(instance), target, request_contents_callback,
+                                 new_request_callback(parameters, 1));
+}
 
-  // Create user data param of callaback
-  struct st_request_callback *callback_object =
-      (struct st_request_callback *)malloc(sizeof(struct st_request_callback));
-  memset(callback_object, 0, sizeof(struct st_request_callback));
-  callback_object->user_parameters = parameters;
-  callback_object->self_widget = Php::Object("GtkClipboard", this);
+void GtkClipboard_::request_contents_callback(GtkClipboard *clipboard,
+                                              GtkSelectionData *selection_data,
+                                              gpointer user_data) {
+  struct st_request_callback *callback_object = (struct st_request_callback *)user_data;
+  std::unique_ptr<st_request_callback> callback_guard(callback_object);
+
+  Php::Value contents;
+  gint length = (selection_data != nullptr) ? gtk_selection_data_get_length(selection_data) : -1;
+  if (length >= 0) {
+    gchar *target = gdk_atom_name(gtk_selection_data_get_target(selection_data));
+    gchar *type = gdk_atom_name(gtk_selection_data_get_data_type(selection_data));
+    const guchar *data = gtk_selection_data_get_data(selection_data);
+
+    contents["target"] = target;
+    contents["type"] = type;
+    contents["format"] = gtk_selection_data_get_format(selection_data);
+    contents["data"] = Php::Value((const char *)data, length);
+
+    g_free(target);
+    g_free(type);
+  }
+
+  invoke_request_callback(callback_object, {contents});
+}
 
-  // handle the callback
+void GtkClipboard_::request_text(Php::Parameters &parameters) {
   gtk_clipboard_request_text(GTK_CLIPBOARD(instance), request_text_callback,
-                             (gpointer)callback_object);
+                             new_request_callback(parameters, 0));
 }
 
 void GtkClipboard_::request_text_callback(GtkClipboard *clipboard, const gchar *clipboard_text,
                                           gpointer user_data) {
-  // Return to st_callback
   struct st_request_callback *callback_object = (struct st_request_callback *)user_data;
+  std::unique_ptr<st_request_callback> callback_guard(callback_object);
 
-  // Callback_name
-  std::string callback_name = callback_object->user_parameters[0];
-
-  // Create internal params, GtkClipboard + text + user_data...
-  Php::Value internal_parameters;
-  internal_parameters[0] = callback_object->self_widget;
-  internal_parameters[1] = clipboard_text;
-  for (int i = 1; i < (int)callback_object->user_parameters.size(); i++) {
-    internal_parameters[i + 1] = callback_object->user_parameters[i];
+  Php::Value text;
+  if (clipboard_text != nullptr) {
+    text = clipboard_text;
   }
 
-  // Call php function with parameters
-  // Wrap in try-catch to properly handle exceptions from PHP callbacks
-  try {
-    Php::call("call_user_func_array", callback_name, internal_parameters);
-  } catch (Php::Exception &exception) {
-    // Re-throw to let PHP-CPP handle the exception properly
-    throw;
-  }
+  invoke_request_callback(callback_object, {text});
 }
 
 void GtkClipboard_::request_image(Php::Parameters &parameters) {
-  // std::string s_user_function = parameters[0];
-  // gchar *user_function = (gchar *)s_user_function.c_str();
-
-  // gpointer user_data = (gpointer)parameters[1];
+  gtk_clipboard_request_image(GTK_CLIPBOARD(instance), request_image_callback,
+                              new_request_callback(parameters, 0));
+}
 
-  // gtk_clipboard_request_image (GTK_CLIPBOARD(instance), user_function, user_data);
+void GtkClipboard_::request_image_callback(GtkClipboard *clipboard, GdkPixbuf *pixbuf,
+                                           gpointer user_data) {
+  struct st_request_callback *callback_object = (struct st_request_callback *)user_data;
+  std::unique_ptr<st_request_callback> callback_guard(callback_object);
+
+  Php::Value image;
+  if (pixbuf != nullptr) {
+    // The pixbuf belongs to GTK and is released after this callback
+    GdkPixbuf_ *return_parsed = new GdkPixbuf_();
+    return_parsed->set_instance((GdkPixbuf *)g_object_ref(pixbuf));
+    image = Php::Object("GdkPixbuf", return_parsed);
+  }
 
-  throw Php::Exception("GtkClipboard_::request_image not implemented");
+  invoke_request_callback(callback_object, {image});
 }
 
 void GtkClipboard_::request_targets(Php::Parameters &parameters) {
-  // std::string s_user_function = parameters[0];
-  // gchar *user_function = (gchar *)s_user_function.c_str();
+  gtk_clipboard_request_targets(GTK_CLIPBOARD(instance), request_targets_callback,
+                                new_request_callback(parameters, 0));
+}
 
-  // gpointer user_data = (gpointer)parameters[1];
+void GtkClipboard_::request_targets_callback(GtkClipboard *clipboard, GdkAtom *atoms,
+                                             gint n_atoms, gpointer user_data) {
+  struct st_request_callback *callback_object = (struct st_request_callback *)user_data;
+  std::unique_ptr<st_request_callback> callback_guard(callback_object);
 
-  // gtk_clipboard_request_targets (GTK_CLIPBOARD(instance), user_function, user_data);
+  Php::Array targets;
+  for (gint i = 0; i < n_atoms; i++) {
+    gchar *name = gdk_atom_name(atoms[i]);
+    targets[i] = name;
+    g_free(name);
+  }
 
-  throw Php::Exception("tkClipboard_::request_targets not implemented");
+  invoke_request_callback(callback_object, {targets});
 }
 
 void GtkClipboard_::request_rich_text(Php::Parameters &parameters) {
-  // std::string s_user_function = parameters[0];
-  // gchar *user_function = (gchar *)s_user_function.c_str();
+  if (parameters.empty() || !parameters[0].instanceOf("GtkTextBuffer")) {
+    throw Php::Exception("GtkClipboard::request_rich_text expects a GtkTextBuffer");
+  }
+
+  GtkTextBuffer_ *phpgtk_buffer = (GtkTextBuffer_ *)parameters[0].implementation();
+  GtkTextBuffer *buffer = GTK_TEXT_BUFFER(phpgtk_buffer->get_instance());
+
+  gtk_clipboard_request_rich_text(GTK_CLIPBOARD(instance), buffer, request_rich_text_callback,
+                                  new_request_callback(parameters, 1));
+}
 
-  // gpointer user_data = (gpointer)parameters[1];
+void GtkClipboard_::request_rich_text_callback(GtkClipboard *clipboard, GdkAtom format,
+                                               const guint8 *text, gsize length,
+                                               gpointer user_data) {
+  struct st_request_callback *callback_object = (struct st_request_callback *)user_data;
+  std::unique_ptr<st_request_callback> callback_guard(callback_object);
 
-  // gtk_clipboard_request_rich_text (GTK_CLIPBOARD(instance), user_function, user_data);
+  Php::Value data;
+  Php::Value format_name;
+  if (text != nullptr) {
+    data = Php::Value((const char *)text, (int)length);
 
-  throw Php::Exception("tkClipboard_::request_rich_text not implemented");
+    gchar *name = gdk_atom_name(format);
+    format_name = name;
+    g_free(name);
+  }
+
+  invoke_request_callback(callback_object, {data, format_name});
 }
 
 void GtkClipboard_::request_uris(Php::Parameters &parameters) {
-  // std::string s_user_function = parameters[0];
-  // gchar *user_function = (gchar *)s_user_function.c_str();
+  gtk_clipboard_request_uris(GTK_CLIPBOARD(instance), request_uris_callback,
+                             new_request_callback(parameters, 0));
+}
 
-  // gpointer user_data = (gpointer)parameters[1];
+void GtkClipboard_::request_uris_callback(GtkClipboard *clipboard, gchar **uris,
+                                          gpointer user_data) {
+  struct st_request_callback *callback_object = (struct st_request_callback *)user_data;
+  std::unique_ptr<st_request_callback> callback_guard(callback_object);
 
-  // gtk_clipboard_request_uris (GTK_CLIPBOARD(instance), user_function, user_data);
+  Php::Array uris_arr;
+  for (int i = 0; uris != nullptr && uris[i] != nullptr; i++) {
+    uris_arr[i] = uris[i];
+  }
 
-  throw Php::Exception("tkClipboard_::request_uris not implemented");
+  invoke_request_callback(callback_object, {uris_arr});
 }
 
 Php::Value GtkClipboard_::wait_for_contents(Php::Parameters &parameters) {
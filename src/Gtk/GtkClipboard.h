@@ -5,6 +5,8 @@
 #include <phpcpp.h>
 #include <gtk/gtk.h>
 
+#include <vector>
+
 #include "../G/GObject.h"
 #include "../Gdk/GdkPixbuf.h"
 #include "GtkTextBuffer.h"
@@ -20,6 +22,32 @@ class GtkClipboard_ : public GObject_ {
    */
  private:
   struct st_request_callback;
+  struct st_provider;
+
+  /**
+   * Call the PHP callback of a request with ($clipboard, ...$payload, ...$user_data)
+   */
+  static void invoke_request_callback(st_request_callback *callback_object,
+                                      const std::vector<Php::Value> &payload);
+
+  /**
+   * Build the callback state of request_*, callable at parameters[offset], user data after it
+   */
+  st_request_callback *new_request_callback(Php::Parameters &parameters, size_t offset);
+
+  static void request_image_callback(GtkClipboard *clipboard, GdkPixbuf *pixbuf,
+                                     gpointer user_data);
+  static void request_targets_callback(GtkClipboard *clipboard, GdkAtom *atoms, gint n_atoms,
+                                       gpointer user_data);
+  static void request_rich_text_callback(GtkClipboard *clipboard, GdkAtom format,
+                                         const guint8 *text, gsize length, gpointer user_data);
+  static void request_uris_callback(GtkClipboard *clipboard, gchar **uris, gpointer user_data);
+  static void request_contents_callback(GtkClipboard *clipboard, GtkSelectionData *selection_data,
+                                        gpointer user_data);
+
+  static void provider_get_callback(GtkClipboard *clipboard, GtkSelectionData *selection_data,
+                                    guint info, gpointer user_data);
+  static void provider_clear_callback(GtkClipboard *clipboard, gpointer user_data);
 
   /**
    * Publics
@@ -40,6 +68,12 @@ class GtkClipboard_ : public GObject_ {
 
   Php::Value get_display();
 
+  /**
+   * set_with_data(array $targets, callable $provider [, callable $clear [, ...$user_data]])
+   *
+   * Lazy provider: $provider($clipboard, $target, ...$user_data) runs only when a paste asks for
+   * one of the targets, and returns a string, an iterable of string chunks, or null to refuse
+   */
   Php::Value set_with_data(Php::Parameters &parameters);
 
   Php::Value set_with_owner(Php::Parameters &parameters);
@@ -52,6 +86,16 @@ class GtkClipboard_ : public GObject_ {
 
   void set_image(Php::Parameters &parameters);
 
+  /**
+   * Asynchronous requests, the callback receives ($clipboard, $payload..., ...$user_data)
+   *
+   * request_contents($target, $callback): ['target', 'type', 'format', 'data'] or null
+   * request_text($callback): string or null
+   * request_image($callback): GdkPixbuf or null
+   * request_targets($callback): array of target names
+   * request_rich_text($buffer, $callback): serialized data or null, then the format name
+   * request_uris($callback): array of URIs
+   */
   void request_contents(Php::Parameters &parameters);
 
   void request_text(Php::Parameters &parameters);
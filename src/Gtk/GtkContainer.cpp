@@ -93,8 +93,9 @@ Php::Value GtkContainer_::get_children() {
   }
 
   Php::Array ret_arr;
-  for (int i = 0; GList *item = g_list_nth(ret, i); ++i) {
-    ret_arr[i] = cobject_to_phpobject((gpointer *)item->data);
+  int i = 0;
+  for (GList *item = ret; item != nullptr; item = item->next) {
+    ret_arr[i++] = cobject_to_phpobject((gpointer *)item->data);
   }
   g_list_free(ret);
   return ret_arr;
@@ -1,5 +1,30 @@
 
 #include "GtkCssProvider.h"
+#include "Gtk.h"
+
+#include <map>
+#include <set>
+#include <string>
+
+/**
+ * Resource prefix used to look up precompiled stylesheets, keyed by content hash
+ */
+#define PHPGTK_CSS_CACHE_RESOURCE_PREFIX "/php-gtk3/css/"
+
+/**
+ * Key of the stylesheet a provider last loaded through the cache
+ */
+#define PHPGTK_CSS_CACHE_KEY "phpgtk-css-cache-key"
+
+/**
+ * Nesting of @import followed when hashing a stylesheet
+ */
+#define PHPGTK_CSS_CACHE_MAX_IMPORT_DEPTH 16
+
+/**
+ * Validated and normalized stylesheets of this process, keyed by content hash
+ */
+static std::map<std::string, std::string> css_cache;
 
 /**
  * Constructor
@@ -30,6 +55,7 @@ Php::Value GtkCssProvider_::load_from_data(Php::Parameters &parameters) {
   GError *error = nullptr;
 
   bool ret = gtk_css_provider_load_from_data(GTK_CSS_PROVIDER(instance), data, length, &error);
+  g_object_set_data(G_OBJECT(instance), PHPGTK_CSS_CACHE_KEY, nullptr);
 
   return ret;
 }
@@ -43,6 +69,7 @@ Php::Value GtkCssProvider_::load_from_file(Php::Parameters &parameters) {
   GError *error = nullptr;
 
   bool ret = gtk_css_provider_load_from_file(GTK_CSS_PROVIDER(instance), file, &error);
+  g_object_set_data(G_OBJECT(instance), PHPGTK_CSS_CACHE_KEY, nullptr);
 
   g_object_unref(file);
 
@@ -56,6 +83,7 @@ Php::Value GtkCssProvider_::load_from_path(Php::Parameters &parameters) {
   GError *error = nullptr;
 
   bool ret = gtk_css_provider_load_from_path(GTK_CSS_PROVIDER(instance), path, &error);
+  g_object_set_data(G_OBJECT(instance), PHPGTK_CSS_CACHE_KEY, nullptr);
 
   return ret;
 }
@@ -65,6 +93,202 @@ void GtkCssProvider_::load_from_resource(Php::Parameters &parameters) {
   gchar *resource_path = (gchar *)s_resource_path.c_str();
 
   gtk_css_provider_load_from_resource(GTK_CSS_PROVIDER(instance), resource_path);
+  g_object_set_data(G_OBJECT(instance), PHPGTK_CSS_CACHE_KEY, nullptr);
+}
+
+/**
+ * Parse data into the provider, throwing the GError message on invalid CSS
+ */
+static void phpgtk_css_provider_load_checked(GtkCssProvider *provider, const gchar *data,
+                                             gssize length, const gchar *origin) {
+  GError *error = nullptr;
+
+  gtk_css_provider_load_from_data(provider, data, length, &error);
+
+  if (error != nullptr) {
+    std::string error_msg = error->message;
+    g_error_free(error);
+    throw Php::Exception(std::string("Failed to load stylesheet ") + origin + ": " + error_msg);
+  }
+}
+
+/**
+ * Feed the stylesheet and, recursively, the local files it @imports into the checksum, so
+ * editing an imported file changes the key too. Imports that cannot be read are hashed by name
+ */
+static void phpgtk_css_provider_hash_imports(GChecksum *checksum, GFile *file,
+                                             const gchar *contents, gsize length,
+                                             std::set<std::string> &seen, int depth) {
+  static GRegex *import_regex = g_regex_new(
+      "@import\\s+(?:url\\(\\s*)?[\"']?([^\"')\\s;]+)", G_REGEX_OPTIMIZE, (GRegexMatchFlags)0,
+      nullptr);
+
+  g_checksum_update(checksum, (const guchar *)contents, length);
+  if (depth >= PHPGTK_CSS_CACHE_MAX_IMPORT_DEPTH) {
+    return;
+  }
+
+  GFile *parent = g_file_get_parent(file);
+
+  GMatchInfo *match_info = nullptr;
+  g_regex_match_full(import_regex, contents, (gssize)length, 0, (GRegexMatchFlags)0, &match_info,
+                     nullptr);
+  while (g_match_info_matches(match_info)) {
+    gchar *location = g_match_info_fetch(match_info, 1);
+    g_checksum_update(checksum, (const guchar *)location, -1);
+
+    GFile *import = (parent != nullptr) ? g_file_resolve_relative_path(parent, location)
+                                        : g_file_new_for_commandline_arg(location);
+    gchar *import_path = g_file_get_path(import);
+    if (import_path != nullptr && seen.insert(import_path).second) {
+      gchar *import_contents = nullptr;
+      gsize import_length = 0;
+      if (g_file_get_contents(import_path, &import_contents, &import_length, nullptr)) {
+        phpgtk_css_provider_hash_imports(checksum, import, import_contents, import_length, seen,
+                                         depth + 1);
+        g_free(import_contents);
+      }
+    }
+
+    g_free(import_path);
+    g_object_unref(import);
+    g_free(location);
+    g_match_info_next(match_info, nullptr);
+  }
+  g_match_info_free(match_info);
+
+  if (parent != nullptr) {
+    g_object_unref(parent);
+  }
+}
+
+Php::Value GtkCssProvider_::load_from_file_cached(Php::Parameters &parameters) {
+  std::string s_file = parameters[0];
+  const gchar *filepath = s_file.c_str();
+
+  // Cache directory, default to the user cache dir
+  std::string s_cache_dir;
+  if (parameters.size() > 1 && !parameters[1].isNull()) {
+    s_cache_dir = parameters[1].stringValue();
+  } else {
+    gchar *default_dir = g_build_filename(g_get_user_cache_dir(), "php-gtk3", "css", nullptr);
+    s_cache_dir = default_dir;
+    g_free(default_dir);
+  }
+
+  // Read original stylesheet
+  gchar *contents = nullptr;
+  gsize length = 0;
+  GError *error = nullptr;
+  if (!g_file_get_contents(filepath, &contents, &length, &error)) {
+    std::string error_msg = error->message;
+    g_error_free(error);
+    throw Php::Exception("Failed to read stylesheet: " + error_msg);
+  }
+
+  // Content hash of the stylesheet, its location and its imports is the cache key
+  GFile *file = g_file_new_for_path(filepath);
+  gchar *uri = g_file_get_uri(file);
+  GChecksum *checksum = g_checksum_new(G_CHECKSUM_SHA256);
+  g_checksum_update(checksum, (const guchar *)uri, -1);
+  std::set<std::string> seen;
+  phpgtk_css_provider_hash_imports(checksum, file, contents, length, seen, 0);
+  std::string key = g_checksum_get_string(checksum);
+  g_checksum_free(checksum);
+  g_free(uri);
+
+  // 0. This provider already holds the stylesheet, nothing to parse
+  const gchar *loaded_key =
+      (const gchar *)g_object_get_data(G_OBJECT(instance), PHPGTK_CSS_CACHE_KEY);
+  if (loaded_key != nullptr && key == loaded_key) {
+    g_object_unref(file);
+    g_free(contents);
+    return true;
+  }
+
+  // 1. Process cache
+  std::map<std::string, std::string>::iterator it = css_cache.find(key);
+  if (it != css_cache.end()) {
+    g_object_unref(file);
+    g_free(contents);
+    phpgtk_css_provider_load_checked(GTK_CSS_PROVIDER(instance), it->second.c_str(),
+                                     it->second.length(), filepath);
+    g_object_set_data_full(G_OBJECT(instance), PHPGTK_CSS_CACHE_KEY, g_strdup(key.c_str()),
+                           g_free);
+    return true;
+  }
+
+  // 2. Registered GResource bundle
+  std::string resource_path = PHPGTK_CSS_CACHE_RESOURCE_PREFIX + key + ".css";
+  GBytes *bytes =
+      g_resources_lookup_data(resource_path.c_str(), G_RESOURCE_LOOKUP_FLAGS_NONE, nullptr);
+  if (bytes != nullptr) {
+    gsize bytes_size = 0;
+    const gchar *bytes_data = (const gchar *)g_bytes_get_data(bytes, &bytes_size);
+    css_cache[key] = std::string(bytes_data, bytes_size);
+    g_bytes_unref(bytes);
+    g_object_unref(file);
+    g_free(contents);
+
+    phpgtk_css_provider_load_checked(GTK_CSS_PROVIDER(instance), css_cache[key].c_str(),
+                                     css_cache[key].length(), filepath);
+    g_object_set_data_full(G_OBJECT(instance), PHPGTK_CSS_CACHE_KEY, g_strdup(key.c_str()),
+                           g_free);
+    return true;
+  }
+
+  // 3. On-disk cache
+  gchar *cache_file = g_build_filename(s_cache_dir.c_str(), (key + ".css").c_str(), nullptr);
+  gchar *cached = nullptr;
+  gsize cached_length = 0;
+  if (g_file_get_contents(cache_file, &cached, &cached_length, nullptr)) {
+    css_cache[key] = std::string(cached, cached_length);
+    g_free(cached);
+    g_free(cache_file);
+    g_object_unref(file);
+    g_free(contents);
+
+    phpgtk_css_provider_load_checked(GTK_CSS_PROVIDER(instance), css_cache[key].c_str(),
+                                     css_cache[key].length(), filepath);
+    g_object_set_data_full(G_OBJECT(instance), PHPGTK_CSS_CACHE_KEY, g_strdup(key.c_str()),
+                           g_free);
+    return true;
+  }
+
+  // 4. Miss: parse and validate the original from its file, so relative url() and @import
+  // resolve against the stylesheet, then store the normalized copy with them resolved
+  g_free(contents);
+  error = nullptr;
+  gtk_css_provider_load_from_file(GTK_CSS_PROVIDER(instance), file, &error);
+  g_object_unref(file);
+  if (error != nullptr) {
+    std::string error_msg = error->message;
+    g_error_free(error);
+    g_free(cache_file);
+    throw Php::Exception(std::string("Failed to load stylesheet ") + filepath + ": " + error_msg);
+  }
+
+  gchar *normalized = gtk_css_provider_to_string(GTK_CSS_PROVIDER(instance));
+  css_cache[key] = normalized;
+  g_free(normalized);
+  g_object_set_data_full(G_OBJECT(instance), PHPGTK_CSS_CACHE_KEY, g_strdup(key.c_str()),
+                         g_free);
+
+  // Failing to write the disk cache is not fatal, the next run will just parse again
+  if (g_mkdir_with_parents(s_cache_dir.c_str(), 0700) == 0) {
+    g_file_set_contents(cache_file, css_cache[key].c_str(), css_cache[key].length(), nullptr);
+  }
+  g_free(cache_file);
+
+  return true;
+}
+
+void GtkCssProvider_::register_cache_bundle(Php::Parameters &parameters) {
+  Gtk_::resources_register(parameters);
+}
+
+void GtkCssProvider_::clear_cache() {
+  css_cache.clear();
 }
 
 void GtkCssProvider_::__construct() {
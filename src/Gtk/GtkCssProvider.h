@@ -33,6 +33,32 @@ class GtkCssProvider_ : public GObject_ {
 
   void load_from_resource(Php::Parameters &parameters);
 
+  /**
+   * Load a stylesheet through the precompiled theme cache
+   *
+   * The key hashes (SHA-256) the file location, its contents and the contents of the local files
+   * it @imports, so editing an import invalidates the entry. The validated, normalized copy
+   * produced by gtk_css_provider_to_string() is looked up, in order, in the process cache, in any
+   * registered GResource bundle under /php-gtk3/css/<hash>.css and in the on-disk cache directory.
+   *
+   * A miss loads the original through its GFile, so relative url() and @import resolve against
+   * the stylesheet, and stores the normalized copy with those references resolved. A hit skips
+   * reading the imports and parses only that flattened copy, GTK 3 has no pre-parsed form to
+   * restore; loading the same key again into the same provider parses nothing. Bundles must be
+   * built from the installed stylesheets, since the copies carry their resolved locations.
+   */
+  Php::Value load_from_file_cached(Php::Parameters &parameters);
+
+  /**
+   * Register a compiled GResource bundle (glib-compile-resources) holding cached stylesheets
+   */
+  static void register_cache_bundle(Php::Parameters &parameters);
+
+  /**
+   * Drop the in-process stylesheet cache
+   */
+  static void clear_cache();
+
   void __construct();
 
   Php::Value to_string();
@@ -1,5 +1,64 @@
 
 #include "GtkDrawingArea.h"
+#include "../Cairo/CairoContext.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/**
+ * Key of the layers state on the GObject
+ */
+#define PHPGTK_DRAWING_AREA_LAYERS_KEY "phpgtk-drawing-area-layers"
+
+/**
+ * One retained layer
+ */
+struct GtkDrawingArea_::st_layer {
+  std::string name;
+  Php::Value render_callback;
+
+  cairo_surface_t *surface = nullptr;
+
+  // Area to render again on next draw, nullptr when the layer is clean
+  cairo_region_t *damage = nullptr;
+
+  // The list of layers holds one reference, a draw in progress another
+  int refs = 1;
+
+  void ref() {
+    refs++;
+  }
+
+  void unref() {
+    if (--refs == 0) {
+      delete this;
+    }
+  }
+
+  ~st_layer() {
+    if (surface != nullptr) {
+      cairo_surface_destroy(surface);
+    }
+    if (damage != nullptr) {
+      cairo_region_destroy(damage);
+    }
+  }
+};
+
+/**
+ * Layers of one drawing area, owned by the GObject
+ */
+struct GtkDrawingArea_::st_layers {
+  Php::Object self_widget;
+  std::vector<st_layer *> layers;
+
+  ~st_layers() {
+    for (size_t i = 0; i < layers.size(); i++) {
+      layers[i]->unref();
+    }
+  }
+};
 
 GtkDrawingArea_::GtkDrawingArea_() = default;
 GtkDrawingArea_::~GtkDrawingArea_() = default;
@@ -7,3 +66,260 @@ GtkDrawingArea_::~GtkDrawingArea_() = default;
 void GtkDrawingArea_::__construct() {
   instance = (gpointer *)gtk_drawing_area_new();
 }
+
+GtkDrawingArea_::st_layers *GtkDrawingArea_::get_layers(bool create) {
+  st_layers *state =
+      (st_layers *)g_object_get_data(G_OBJECT(instance), PHPGTK_DRAWING_AREA_LAYERS_KEY);
+
+  if (state == nullptr && create) {
+    state = new st_layers();
+    state->self_widget = Php::Object("GtkDrawingArea", this);
+
+    // State lives with the widget, the compositor runs before user draw handlers
+    g_object_set_data_full(G_OBJECT(instance), PHPGTK_DRAWING_AREA_LAYERS_KEY, state,
+                           layers_destroy_notify);
+    g_signal_connect(instance, "draw", G_CALLBACK(layers_draw_callback), state);
+  }
+
+  return state;
+}
+
+GtkDrawingArea_::st_layer *GtkDrawingArea_::find_layer(const std::string &name) {
+  st_layers *state = get_layers(false);
+  if (state == nullptr) {
+    return nullptr;
+  }
+
+  for (size_t i = 0; i < state->layers.size(); i++) {
+    if (state->layers[i]->name == name) {
+      return state->layers[i];
+    }
+  }
+
+  return nullptr;
+}
+
+void GtkDrawingArea_::layers_destroy_notify(gpointer user_data) {
+  st_layers *state = (st_layers *)user_data;
+
+  delete state;
+}
+
+gboolean GtkDrawingArea_::layers_draw_callback(GtkWidget *widget, cairo_t *cr,
+                                               gpointer user_data) {
+  st_layers *state = (st_layers *)user_data;
+
+  GdkWindow *window = gtk_widget_get_window(widget);
+  if (window == nullptr) {
+    return FALSE;
+  }
+
+  int width = gtk_widget_get_allocated_width(widget);
+  int height = gtk_widget_get_allocated_height(widget);
+  int scale = gtk_widget_get_scale_factor(widget);
+
+  // Render callbacks may remove layers or destroy the widget: walk a referenced copy, and keep
+  // the widget, which owns the state, alive until the end
+  std::vector<st_layer *> layers = state->layers;
+  for (st_layer *layer : layers) {
+    layer->ref();
+  }
+  g_object_ref(widget);
+
+  for (size_t i = 0; i < layers.size(); i++) {
+    st_layer *layer = layers[i];
+
+    // Removed by a previous callback
+    if (std::find(state->layers.begin(), state->layers.end(), layer) == state->layers.end()) {
+      continue;
+    }
+
+    // (Re)create the surface on size change, which damages the whole layer
+    if (layer->surface == nullptr ||
+        cairo_image_surface_get_width(layer->surface) != width * scale ||
+        cairo_image_surface_get_height(layer->surface) != height * scale) {
+      if (layer->surface != nullptr) {
+        cairo_surface_destroy(layer->surface);
+      }
+      layer->surface = gdk_window_create_similar_image_surface(window, CAIRO_FORMAT_ARGB32,
+                                                               width * scale, height * scale, scale);
+
+      if (layer->damage != nullptr) {
+        cairo_region_destroy(layer->damage);
+      }
+      cairo_rectangle_int_t full = {0, 0, width, height};
+      layer->damage = cairo_region_create_rectangle(&full);
+    }
+
+    // Render only the damaged area of the layer
+    if (layer->damage != nullptr) {
+      cairo_region_t *damage = layer->damage;
+      layer->damage = nullptr;
+
+      cairo_t *layer_cr = cairo_create(layer->surface);
+      gdk_cairo_region(layer_cr, damage);
+      cairo_clip(layer_cr);
+
+      cairo_save(layer_cr);
+      cairo_set_operator(layer_cr, CAIRO_OPERATOR_CLEAR);
+      cairo_paint(layer_cr);
+      cairo_restore(layer_cr);
+
+      cairo_rectangle_int_t extents;
+      cairo_region_get_extents(damage, &extents);
+      cairo_region_destroy(damage);
+
+      CairoContext_ *cairo_ = new CairoContext_();
+      cairo_->set_instance(layer_cr);
+      cairo_destroy(layer_cr);
+
+      Php::Value area;
+      area["x"] = extents.x;
+      area["y"] = extents.y;
+      area["width"] = extents.width;
+      area["height"] = extents.height;
+
+      Php::Value internal_parameters;
+      internal_parameters[0] = state->self_widget;
+      internal_parameters[1] = Php::Object("CairoContext", cairo_);
+      internal_parameters[2] = area;
+
+      try {
+        Php::call("call_user_func_array", layer->render_callback, internal_parameters);
+      } catch (Php::Exception &exception) {
+        for (st_layer *held : layers) {
+          held->unref();
+        }
+        g_object_unref(widget);
+
+        // Re-throw to let PHP-CPP handle the exception properly
+        throw;
+      }
+
+      // The callback may have removed this layer
+      if (std::find(state->layers.begin(), state->layers.end(), layer) == state->layers.end()) {
+        continue;
+      }
+    }
+
+    cairo_set_source_surface(cr, layer->surface, 0, 0);
+    cairo_paint(cr);
+  }
+
+  for (st_layer *layer : layers) {
+    layer->unref();
+  }
+  g_object_unref(widget);
+
+  // Let the PHP draw handlers paint the overlays
+  return FALSE;
+}
+
+void GtkDrawingArea_::add_layer(Php::Parameters &parameters) {
+  if (parameters.size() < 2 || !parameters[1].isCallable()) {
+    throw Php::Exception("GtkDrawingArea::add_layer requires a name and a render callback");
+  }
+
+  std::string s_name = parameters[0];
+  if (find_layer(s_name) != nullptr) {
+    throw Php::Exception("GtkDrawingArea::add_layer: layer " + s_name + " already exists");
+  }
+
+  st_layer *layer = new st_layer();
+  layer->name = s_name;
+  layer->render_callback = parameters[1];
+
+  get_layers(true)->layers.push_back(layer);
+
+  gtk_widget_queue_draw(GTK_WIDGET(instance));
+}
+
+void GtkDrawingArea_::remove_layer(Php::Parameters &parameters) {
+  std::string s_name = parameters[0];
+
+  st_layers *state = get_layers(false);
+  if (state == nullptr) {
+    return;
+  }
+
+  for (size_t i = 0; i < state->layers.size(); i++) {
+    if (state->layers[i]->name == s_name) {
+      state->layers[i]->unref();
+      state->layers.erase(state->layers.begin() + i);
+
+      gtk_widget_queue_draw(GTK_WIDGET(instance));
+      return;
+    }
+  }
+}
+
+Php::Value GtkDrawingArea_::has_layer(Php::Parameters &parameters) {
+  std::string s_name = parameters[0];
+
+  return find_layer(s_name) != nullptr;
+}
+
+Php::Value GtkDrawingArea_::is_layer_dirty(Php::Parameters &parameters) {
+  std::string s_name = parameters[0];
+
+  st_layer *layer = find_layer(s_name);
+  if (layer == nullptr) {
+    throw Php::Exception("GtkDrawingArea::is_layer_dirty: there is no layer " + s_name);
+  }
+
+  return layer->surface == nullptr || layer->damage != nullptr;
+}
+
+void GtkDrawingArea_::invalidate_layer(Php::Parameters &parameters) {
+  st_layers *state = get_layers(false);
+  if (state == nullptr) {
+    return;
+  }
+
+  // Damaged area, whole widget by default
+  cairo_rectangle_int_t rect = {0, 0, gtk_widget_get_allocated_width(GTK_WIDGET(instance)),
+                                gtk_widget_get_allocated_height(GTK_WIDGET(instance))};
+  bool partial = false;
+  if (parameters.size() >= 5) {
+    rect.x = (int)parameters[1];
+    rect.y = (int)parameters[2];
+    rect.width = (int)parameters[3];
+    rect.height = (int)parameters[4];
+    partial = true;
+  }
+
+  // Layer name, or null for all layers
+  bool all_layers = parameters.empty() || parameters[0].isNull();
+  std::string s_name;
+  if (!all_layers) {
+    s_name = parameters[0].stringValue();
+  }
+
+  bool found = false;
+  for (size_t i = 0; i < state->layers.size(); i++) {
+    st_layer *layer = state->layers[i];
+    if (!all_layers && layer->name != s_name) {
+      continue;
+    }
+
+    if (layer->damage == nullptr) {
+      layer->damage = cairo_region_create_rectangle(&rect);
+    } else {
+      cairo_region_union_rectangle(layer->damage, &rect);
+    }
+    found = true;
+  }
+
+  if (!found) {
+    if (!all_layers) {
+      throw Php::Exception("GtkDrawingArea::invalidate_layer: there is no layer " + s_name);
+    }
+    return;
+  }
+
+  if (partial) {
+    gtk_widget_queue_draw_area(GTK_WIDGET(instance), rect.x, rect.y, rect.width, rect.height);
+  } else {
+    gtk_widget_queue_draw(GTK_WIDGET(instance));
+  }
+}
@@ -1,4 +1,3 @@
-
 #ifndef _PHPGTK_GTKDRAWINGAREA_H_
 #define _PHPGTK_GTKDRAWINGAREA_H_
 
@@ -8,6 +7,19 @@
 #include "GtkWidget.h"
 
 class GtkDrawingArea_ : public GtkWidget_ {
+  /**
+   * Privates
+   */
+ private:
+  struct st_layer;
+  struct st_layers;
+
+  st_layers *get_layers(bool create);
+  st_layer *find_layer(const std::string &name);
+
+  static gboolean layers_draw_callback(GtkWidget *widget, cairo_t *cr, gpointer user_data);
+  static void layers_destroy_notify(gpointer user_data);
+
   /**
    * Publics
    */
@@ -19,6 +31,28 @@ class GtkDrawingArea_ : public GtkWidget_ {
   ~GtkDrawingArea_();
 
   void __construct();
+
+  /**
+   * Retained layers
+   *
+   * Each layer is an image surface rendered by a PHP callback only when it was invalidated, and
+   * composited natively (in insertion order) before the PHP "draw" handlers run, so handlers
+   * only have to paint the overlays. Add the layers before connecting the draw handlers.
+   *
+   * The render callback receives ($widget, CairoContext $cr, array $area), with $cr clipped to
+   * the damaged area, already cleared.
+   */
+  void add_layer(Php::Parameters &parameters);
+  void remove_layer(Php::Parameters &parameters);
+  Php::Value has_layer(Php::Parameters &parameters);
+  Php::Value is_layer_dirty(Php::Parameters &parameters);
+
+  /**
+   * Damage a layer (or all layers, when name is null), fully or only the given area
+   *
+   * Also queues the redraw of the same area with gtk_widget_queue_draw_area()
+   */
+  void invalidate_layer(Php::Parameters &parameters);
 };
 
 #endif
@@ -64,7 +64,7 @@ Php::Value GtkEntry_::get_text() {
  * Sets the text in the widget to the given value, replacing the current contents.
  */
 void GtkEntry_::set_text(Php::Parameters &parameters) {
-  std::string text = parameters[0];
+  phpgtk_string text(parameters[0]);
   gtk_entry_set_text(GTK_ENTRY(instance), text.c_str());
 }
 
@@ -21,29 +21,29 @@ void GtkLabel_::__construct(Php::Parameters &parameters) {
 }
 
 void GtkLabel_::set_text(Php::Parameters &parameters) {
-  std::string s_str = parameters[0];
-  gchar *str = (gchar *)s_str.c_str();
+  phpgtk_string s_str(parameters[0]);
+  const gchar *str = s_str.c_str();
 
   gtk_label_set_text(GTK_LABEL(instance), str);
 }
 
 void GtkLabel_::set_markup(Php::Parameters &parameters) {
-  std::string s_str = parameters[0];
-  gchar *str = (gchar *)s_str.c_str();
+  phpgtk_string s_str(parameters[0]);
+  const gchar *str = s_str.c_str();
 
   gtk_label_set_markup(GTK_LABEL(instance), str);
 }
 
 void GtkLabel_::set_markup_with_mnemonic(Php::Parameters &parameters) {
-  std::string s_str = parameters[0];
-  gchar *str = (gchar *)s_str.c_str();
+  phpgtk_string s_str(parameters[0]);
+  const gchar *str = s_str.c_str();
 
   gtk_label_set_markup_with_mnemonic(GTK_LABEL(instance), str);
 }
 
 void GtkLabel_::set_pattern(Php::Parameters &parameters) {
-  std::string s_str = parameters[0];
-  gchar *str = (gchar *)s_str.c_str();
+  phpgtk_string s_str(parameters[0]);
+  const gchar *str = s_str.c_str();
 
   gtk_label_set_pattern(GTK_LABEL(instance), str);
 }
@@ -136,8 +136,8 @@ void GtkLabel_::set_selectable(Php::Parameters &parameters) {
 }
 
 void GtkLabel_::set_text_with_mnemonic(Php::Parameters &parameters) {
-  std::string s_str = parameters[0];
-  gchar *str = (gchar *)s_str.c_str();
+  phpgtk_string s_str(parameters[0]);
+  const gchar *str = s_str.c_str();
 
   gtk_label_set_text_with_mnemonic(GTK_LABEL(instance), str);
 }
@@ -225,8 +225,8 @@ Php::Value GtkLabel_::get_angle() {
 }
 
 void GtkLabel_::set_label(Php::Parameters &parameters) {
-  std::string s_str = parameters[0];
-  gchar *str = (gchar *)s_str.c_str();
+  phpgtk_string s_str(parameters[0]);
+  const gchar *str = s_str.c_str();
 
   gtk_label_set_label(GTK_LABEL(instance), str);
 }
@@ -1,10 +1,7 @@
 
 #include "GtkListStore.h"
 
-struct GtkListStore_::st_request_callback {
-  Php::Parameters user_parameters;
-  Php::Object self_widget;
-};
+struct GtkListStore_::st_request_callback : public phpgtk_closure {};
 
 /**
  * Constructor
@@ -321,15 +318,13 @@ void GtkListStore_::move_after(Php::Parameters &parameters) {
 void GtkListStore_::set_sort_func(Php::Parameters &parameters) {
   gint sort_column_id = (gint)parameters[0];
 
-  // Create gpointer user data
-  struct st_request_callback *callback_object =
-      (struct st_request_callback *)malloc(sizeof(struct st_request_callback));
-  memset(callback_object, 0, sizeof(struct st_request_callback));
+  // Create gpointer user data, released when the sort func is replaced or the model finalized
+  struct st_request_callback *callback_object = new st_request_callback();
   callback_object->user_parameters = parameters;
   callback_object->self_widget = Php::Object("GtkListStore", this);
 
   gtk_tree_sortable_set_sort_func(GTK_TREE_SORTABLE(model), sort_column_id, set_sort_func_callback,
-                                  (gpointer)callback_object, nullptr);
+                                  (gpointer)callback_object, phpgtk_closure::destroy);
 }
 
 gint GtkListStore_::set_sort_func_callback(GtkTreeModel *model, GtkTreeIter *a, GtkTreeIter *b,
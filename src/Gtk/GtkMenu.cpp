@@ -5,7 +5,7 @@
 /**
  * Struct for popup callback
  */
-struct GtkMenu_::st_popup_callback {
+struct GtkMenu_::st_popup_callback : public phpgtk_closure {
   Php::Value callback_function;
   Php::Value user_data;
   Php::Value menu_object;  // Store the original menu PHP object
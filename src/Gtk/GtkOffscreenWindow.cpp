@@ -0,0 +1,255 @@
+#include "GtkOffscreenWindow.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+/**
+ * Constructor
+ */
+GtkOffscreenWindow_::GtkOffscreenWindow_() = default;
+
+/**
+ * Destructor
+ */
+GtkOffscreenWindow_::~GtkOffscreenWindow_() = default;
+
+void GtkOffscreenWindow_::__construct() {
+  instance = (gpointer *)gtk_offscreen_window_new();
+}
+
+Php::Value GtkOffscreenWindow_::get_pixbuf() {
+  GdkPixbuf *ret = gtk_offscreen_window_get_pixbuf(GTK_OFFSCREEN_WINDOW(instance));
+  if (ret == nullptr) {
+    return nullptr;
+  }
+
+  GdkPixbuf_ *return_parsed = new GdkPixbuf_();
+  return_parsed->set_instance(ret);
+  return Php::Object("GdkPixbuf", return_parsed);
+}
+
+/**
+ * Collect the hidden widgets of a tree, the ones gtk_widget_show_all() is about to show
+ */
+static void phpgtk_offscreen_collect_hidden(GtkWidget *widget, gpointer data) {
+  if (gtk_widget_get_no_show_all(widget)) {
+    return;
+  }
+
+  if (!gtk_widget_get_visible(widget)) {
+    ((std::vector<GtkWidget *> *)data)->push_back(widget);
+  }
+
+  if (GTK_IS_CONTAINER(widget)) {
+    gtk_container_foreach(GTK_CONTAINER(widget), phpgtk_offscreen_collect_hidden, data);
+  }
+}
+
+/**
+ * Lay the widget out and draw it on a new image surface
+ */
+static cairo_surface_t *phpgtk_offscreen_draw(GtkWidget *widget, int width, int height,
+                                              double scale) {
+  if (width <= 0 || height <= 0 || scale <= 0) {
+    throw Php::Exception("GtkOffscreenWindow::render expects a positive size and scale");
+  }
+
+  GtkWidget *toplevel = widget;
+  bool temporary = false;
+  bool was_floating = false;
+
+  if (!GTK_IS_OFFSCREEN_WINDOW(widget)) {
+    if (gtk_widget_get_parent(widget) != nullptr || GTK_IS_WINDOW(widget)) {
+      throw Php::Exception(
+          "GtkOffscreenWindow::render: the widget must have no parent, or be a GtkOffscreenWindow");
+    }
+
+    // Keep the widget alive across the temporary parent, and give it back as it came
+    was_floating = g_object_is_floating(widget);
+    g_object_ref(widget);
+
+    toplevel = gtk_offscreen_window_new();
+    gtk_container_add(GTK_CONTAINER(toplevel), widget);
+    temporary = true;
+  }
+
+  // Show the tree for the drawing only, the caller's widgets get their visibility back
+  std::vector<GtkWidget *> hidden;
+  phpgtk_offscreen_collect_hidden(widget, &hidden);
+  gtk_widget_show_all(toplevel);
+
+  // Layout synchronously, no frame clock involved
+  GtkRequisition minimum;
+  gtk_widget_get_preferred_size(toplevel, &minimum, nullptr);
+
+  GtkAllocation allocation;
+  allocation.x = 0;
+  allocation.y = 0;
+  allocation.width = MAX(width, minimum.width);
+  allocation.height = MAX(height, minimum.height);
+  gtk_widget_size_allocate(toplevel, &allocation);
+
+  cairo_surface_t *surface = cairo_image_surface_create(
+      CAIRO_FORMAT_ARGB32, (int)std::ceil(width * scale), (int)std::ceil(height * scale));
+  cairo_surface_set_device_scale(surface, scale, scale);
+
+  cairo_t *cr = cairo_create(surface);
+  gtk_widget_draw(toplevel, cr);
+  cairo_destroy(cr);
+  cairo_surface_flush(surface);
+
+  for (auto it = hidden.rbegin(); it != hidden.rend(); ++it) {
+    gtk_widget_hide(*it);
+  }
+
+  if (temporary) {
+    gtk_container_remove(GTK_CONTAINER(toplevel), widget);
+    gtk_widget_destroy(toplevel);
+
+    if (was_floating) {
+      g_object_force_floating(G_OBJECT(widget));
+    } else {
+      g_object_unref(widget);
+    }
+  }
+
+  return surface;
+}
+
+static cairo_status_t phpgtk_offscreen_png_write(void *closure, const unsigned char *data,
+                                                 unsigned int length) {
+  ((std::string *)closure)->append((const char *)data, length);
+  return CAIRO_STATUS_SUCCESS;
+}
+
+/**
+ * Convert the drawn surface to the requested output
+ */
+static Php::Value phpgtk_offscreen_result(cairo_surface_t *surface, const std::string &format,
+                                          const std::string &file) {
+  int width = cairo_image_surface_get_width(surface);
+  int height = cairo_image_surface_get_height(surface);
+
+  if (!file.empty()) {
+    cairo_status_t status = cairo_surface_write_to_png(surface, file.c_str());
+    if (status != CAIRO_STATUS_SUCCESS) {
+      throw Php::Exception("GtkOffscreenWindow::render: cannot write " + file + ": " +
+                           cairo_status_to_string(status));
+    }
+
+    return true;
+  }
+
+  if (format == "png") {
+    std::string png;
+    cairo_surface_write_to_png_stream(surface, phpgtk_offscreen_png_write, &png);
+
+    return Php::Value(png.data(), (int)png.size());
+  }
+
+  GdkPixbuf *pixbuf = gdk_pixbuf_get_from_surface(surface, 0, 0, width, height);
+  if (pixbuf == nullptr) {
+    throw Php::Exception("GtkOffscreenWindow::render: cannot read the rendered surface");
+  }
+
+  if (format == "rgba") {
+    int rowstride = gdk_pixbuf_get_rowstride(pixbuf);
+    const guchar *pixels = gdk_pixbuf_read_pixels(pixbuf);
+
+    std::string data;
+    data.reserve((size_t)width * height * 4);
+    for (int y = 0; y < height; y++) {
+      data.append((const char *)pixels + (size_t)y * rowstride, (size_t)width * 4);
+    }
+    g_object_unref(pixbuf);
+
+    Php::Array ret_arr;
+    ret_arr["width"] = width;
+    ret_arr["height"] = height;
+    ret_arr["data"] = Php::Value(data.data(), (int)data.size());
+
+    return ret_arr;
+  }
+
+  if (format != "pixbuf") {
+    g_object_unref(pixbuf);
+    throw Php::Exception("GtkOffscreenWindow::render: unknown format " + format);
+  }
+
+  GdkPixbuf_ *return_parsed = new GdkPixbuf_();
+  return_parsed->set_instance(pixbuf);
+  return Php::Object("GdkPixbuf", return_parsed);
+}
+
+/**
+ * Run one render job
+ */
+static Php::Value phpgtk_offscreen_render(const Php::Value &object_widget, int width, int height,
+                                          double scale, const std::string &format,
+                                          const std::string &file) {
+  if (!object_widget.instanceOf("GtkWidget")) {
+    throw Php::Exception("GtkOffscreenWindow::render expects a GtkWidget");
+  }
+
+  GtkWidget_ *phpgtk_widget = (GtkWidget_ *)object_widget.implementation();
+  GtkWidget *widget = GTK_WIDGET(phpgtk_widget->get_instance());
+
+  cairo_surface_t *surface = phpgtk_offscreen_draw(widget, width, height, scale);
+
+  try {
+    Php::Value ret = phpgtk_offscreen_result(surface, format, file);
+    cairo_surface_destroy(surface);
+    return ret;
+  } catch (Php::Exception &exception) {
+    cairo_surface_destroy(surface);
+    throw;
+  }
+}
+
+Php::Value GtkOffscreenWindow_::render(Php::Parameters &parameters) {
+  if (parameters.size() < 3) {
+    throw Php::Exception("GtkOffscreenWindow::render expects a widget, a width and a height");
+  }
+
+  double scale = 1;
+  if (parameters.size() > 3) {
+    scale = parameters[3].floatValue();
+  }
+
+  std::string format = "pixbuf";
+  if (parameters.size() > 4) {
+    format = parameters[4].stringValue();
+  }
+
+  return phpgtk_offscreen_render(parameters[0], (int)parameters[1], (int)parameters[2], scale,
+                                 format, "");
+}
+
+Php::Value GtkOffscreenWindow_::render_many(Php::Parameters &parameters) {
+  if (parameters.empty() || !parameters[0].isArray()) {
+    throw Php::Exception("GtkOffscreenWindow::render_many expects an array of jobs");
+  }
+
+  Php::Value jobs = parameters[0];
+  Php::Array ret_arr;
+
+  for (auto &iter : jobs) {
+    const Php::Value &job = iter.second;
+
+    double scale = job.contains("scale") ? job.get("scale").floatValue() : 1;
+    std::string format = job.contains("format") ? job.get("format").stringValue() : "pixbuf";
+    std::string file = job.contains("file") ? job.get("file").stringValue() : "";
+
+    Php::Value result = phpgtk_offscreen_render(job.get("widget"), (int)job.get("width"),
+                                                (int)job.get("height"), scale, format, file);
+
+    if (iter.first.isNumeric()) {
+      ret_arr[(int)iter.first.numericValue()] = result;
+    } else {
+      ret_arr[iter.first.stringValue()] = result;
+    }
+  }
+
+  return ret_arr;
+}
@@ -0,0 +1,50 @@
+#ifndef _PHPGTK_GTKOFFSCREENWINDOW_H_
+#define _PHPGTK_GTKOFFSCREENWINDOW_H_
+
+#include <phpcpp.h>
+#include <gtk/gtk.h>
+
+#include "GtkWindow.h"
+#include "../Gdk/GdkPixbuf.h"
+
+/**
+ * GtkOffscreenWindow_
+ *
+ * Toplevel that is never shown on screen, used to render widgets headless
+ *
+ * https://docs.gtk.org/gtk3/class.OffscreenWindow.html
+ */
+class GtkOffscreenWindow_ : public GtkWindow_ {
+  /**
+   * Publics
+   */
+ public:
+  /**
+   *  C++ constructor and destructor
+   */
+  GtkOffscreenWindow_();
+  ~GtkOffscreenWindow_();
+
+  void __construct();
+
+  Php::Value get_pixbuf();
+
+  /**
+   * render(GtkWidget $widget, int $width, int $height [, float $scale = 1 [, string $format]])
+   *
+   * Lays the widget out at width x height and draws it synchronously. A widget without parent
+   * is put in a temporary offscreen window, a GtkOffscreenWindow is drawn as is. $format is
+   * "pixbuf" (GdkPixbuf, default), "png" (PNG bytes) or "rgba" (['width', 'height', 'data'],
+   * unpremultiplied RGBA rows without padding). Widgets hidden before the call are hidden again
+   * once drawn
+   */
+  static Php::Value render(Php::Parameters &parameters);
+
+  /**
+   * render_many(array $jobs): each job is ['widget', 'width', 'height', 'scale', 'format',
+   * 'file']. With 'file', the PNG is written there and true is returned for that job
+   */
+  static Php::Value render_many(Php::Parameters &parameters);
+};
+
+#endif
@@ -5,6 +5,7 @@
 #include "../Gdk/GdkWindow.h"
 #include "../Gdk/GdkRGBA.h"
 #include "GtkWidgetPath.h"
+#include "../Cairo/CairoContext.h"
 
 /**
  * Constructor
@@ -534,6 +535,51 @@ void GtkStyleContext_::reset_widgets() {
   }
 }
 
+void GtkStyleContext_::replace_providers_for_screen(Php::Parameters &parameters) {
+  if (parameters.size() < 2) {
+    throw Php::Exception(
+        "GtkStyleContext::replace_providers_for_screen requires the providers to remove and add");
+  }
+
+  Php::Value remove_providers = parameters[0];
+  Php::Value add_providers = parameters[1];
+
+  guint priority = GTK_STYLE_PROVIDER_PRIORITY_USER;
+  if (parameters.size() > 2) {
+    priority = (int)parameters[2];
+  }
+
+  GdkScreen *screen = gdk_screen_get_default();
+  if (screen == nullptr) {
+    throw Php::Exception(
+        "GtkStyleContext::replace_providers_for_screen: no default screen available");
+  }
+
+  // Removals
+  for (int i = 0; i < remove_providers.size(); i++) {
+    Php::Value object_provider = remove_providers[i];
+    if (!object_provider.instanceOf("GtkCssProvider")) {
+      throw Php::Exception("GtkStyleContext::replace_providers_for_screen expects GtkCssProvider");
+    }
+
+    GtkCssProvider_ *phpgtk_provider = (GtkCssProvider_ *)object_provider.implementation();
+    gtk_style_context_remove_provider_for_screen(
+        screen, GTK_STYLE_PROVIDER(phpgtk_provider->get_instance()));
+  }
+
+  // Additions
+  for (int i = 0; i < add_providers.size(); i++) {
+    Php::Value object_provider = add_providers[i];
+    if (!object_provider.instanceOf("GtkCssProvider")) {
+      throw Php::Exception("GtkStyleContext::replace_providers_for_screen expects GtkCssProvider");
+    }
+
+    GtkCssProvider_ *phpgtk_provider = (GtkCssProvider_ *)object_provider.implementation();
+    gtk_style_context_add_provider_for_screen(
+        screen, GTK_STYLE_PROVIDER(phpgtk_provider->get_instance()), priority);
+  }
+}
+
 void GtkStyleContext_::set_background(Php::Parameters &parameters) {
   GdkWindow *window = nullptr;
   if (!parameters.empty() && !parameters[0].isNull()) {
@@ -868,15 +914,15 @@ void GtkStyleContext_::gtk_border_free() {
 }
 
 void GtkStyleContext_::gtk_render_arrow(Php::Parameters &parameters) {
-  // Extract cairo context from GdkEvent wrapper (first parameter)
+  // Extract cairo context (first parameter)
   if (parameters.size() < 5) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_arrow: Requires five parameters: GdkEvent (cairo context), "
+        "GtkStyleContext_::gtk_render_arrow: Requires five parameters: CairoContext, "
         "angle, x, y, size");
   }
-  if (!parameters[0].instanceOf("GdkEvent")) {
+  if (!phpgtk_is_cairo_context(parameters[0])) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_arrow: First parameter must be a GdkEvent (cairo context)");
+        "GtkStyleContext_::gtk_render_arrow: First parameter must be a CairoContext");
   }
   if (!parameters[1].isNumeric() || !parameters[2].isNumeric() || !parameters[3].isNumeric() ||
       !parameters[4].isNumeric()) {
@@ -884,8 +930,7 @@ void GtkStyleContext_::gtk_render_arrow(Php::Parameters &parameters) {
         "GtkStyleContext_::gtk_render_arrow: Parameters 2-5 (angle, x, y, size) must be numeric");
   }
 
-  GdkEvent_ *phpgtk_event = (GdkEvent_ *)parameters[0].implementation();
-  cairo_t *cr = (cairo_t *)phpgtk_event->instance;
+  cairo_t *cr = phpgtk_get_cairo_context(parameters[0]);
 
   if (cr == nullptr) {
     throw Php::Exception("GtkStyleContext_::gtk_render_arrow: Invalid cairo context");
@@ -900,16 +945,15 @@ void GtkStyleContext_::gtk_render_arrow(Php::Parameters &parameters) {
 }
 
 void GtkStyleContext_::gtk_render_background(Php::Parameters &parameters) {
-  // Extract cairo context from GdkEvent wrapper (first parameter)
+  // Extract cairo context (first parameter)
   if (parameters.size() < 5) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_background: Requires five parameters: GdkEvent (cairo "
-        "context), x, y, width, height");
+        "GtkStyleContext_::gtk_render_background: Requires five parameters: CairoContext, "
+        "x, y, width, height");
   }
-  if (!parameters[0].instanceOf("GdkEvent")) {
+  if (!phpgtk_is_cairo_context(parameters[0])) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_background: First parameter must be a GdkEvent (cairo "
-        "context)");
+        "GtkStyleContext_::gtk_render_background: First parameter must be a CairoContext");
   }
   if (!parameters[1].isNumeric() || !parameters[2].isNumeric() || !parameters[3].isNumeric() ||
       !parameters[4].isNumeric()) {
@@ -918,8 +962,7 @@ void GtkStyleContext_::gtk_render_background(Php::Parameters &parameters) {
         "numeric");
   }
 
-  GdkEvent_ *phpgtk_event = (GdkEvent_ *)parameters[0].implementation();
-  cairo_t *cr = (cairo_t *)phpgtk_event->instance;
+  cairo_t *cr = phpgtk_get_cairo_context(parameters[0]);
 
   if (cr == nullptr) {
     throw Php::Exception("GtkStyleContext_::gtk_render_background: Invalid cairo context");
@@ -940,15 +983,15 @@ void GtkStyleContext_::gtk_render_background_get_clip(Php::Parameters &parameter
 }
 
 void GtkStyleContext_::gtk_render_check(Php::Parameters &parameters) {
-  // Extract cairo context from GdkEvent wrapper (first parameter)
+  // Extract cairo context (first parameter)
   if (parameters.size() < 5) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_check: Requires five parameters: GdkEvent (cairo context), "
+        "GtkStyleContext_::gtk_render_check: Requires five parameters: CairoContext, "
         "x, y, width, height");
   }
-  if (!parameters[0].instanceOf("GdkEvent")) {
+  if (!phpgtk_is_cairo_context(parameters[0])) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_check: First parameter must be a GdkEvent (cairo context)");
+        "GtkStyleContext_::gtk_render_check: First parameter must be a CairoContext");
   }
   if (!parameters[1].isNumeric() || !parameters[2].isNumeric() || !parameters[3].isNumeric() ||
       !parameters[4].isNumeric()) {
@@ -956,8 +999,7 @@ void GtkStyleContext_::gtk_render_check(Php::Parameters &parameters) {
         "GtkStyleContext_::gtk_render_check: Parameters 2-5 (x, y, width, height) must be numeric");
   }
 
-  GdkEvent_ *phpgtk_event = (GdkEvent_ *)parameters[0].implementation();
-  cairo_t *cr = (cairo_t *)phpgtk_event->instance;
+  cairo_t *cr = phpgtk_get_cairo_context(parameters[0]);
 
   if (cr == nullptr) {
     throw Php::Exception("GtkStyleContext_::gtk_render_check: Invalid cairo context");
@@ -972,16 +1014,15 @@ void GtkStyleContext_::gtk_render_check(Php::Parameters &parameters) {
 }
 
 void GtkStyleContext_::gtk_render_expander(Php::Parameters &parameters) {
-  // Extract cairo context from GdkEvent wrapper (first parameter)
+  // Extract cairo context (first parameter)
   if (parameters.size() < 5) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_expander: Requires five parameters: GdkEvent (cairo "
-        "context), x, y, width, height");
+        "GtkStyleContext_::gtk_render_expander: Requires five parameters: CairoContext, "
+        "x, y, width, height");
   }
-  if (!parameters[0].instanceOf("GdkEvent")) {
+  if (!phpgtk_is_cairo_context(parameters[0])) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_expander: First parameter must be a GdkEvent (cairo "
-        "context)");
+        "GtkStyleContext_::gtk_render_expander: First parameter must be a CairoContext");
   }
   if (!parameters[1].isNumeric() || !parameters[2].isNumeric() || !parameters[3].isNumeric() ||
       !parameters[4].isNumeric()) {
@@ -990,8 +1031,7 @@ void GtkStyleContext_::gtk_render_expander(Php::Parameters &parameters) {
         "numeric");
   }
 
-  GdkEvent_ *phpgtk_event = (GdkEvent_ *)parameters[0].implementation();
-  cairo_t *cr = (cairo_t *)phpgtk_event->instance;
+  cairo_t *cr = phpgtk_get_cairo_context(parameters[0]);
 
   if (cr == nullptr) {
     throw Php::Exception("GtkStyleContext_::gtk_render_expander: Invalid cairo context");
@@ -1006,16 +1046,15 @@ void GtkStyleContext_::gtk_render_expander(Php::Parameters &parameters) {
 }
 
 void GtkStyleContext_::gtk_render_extension(Php::Parameters &parameters) {
-  // Extract cairo context from GdkEvent wrapper (first parameter)
+  // Extract cairo context (first parameter)
   if (parameters.size() < 6) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_extension: Requires six parameters: GdkEvent (cairo "
-        "context), x, y, width, height, gap_side");
+        "GtkStyleContext_::gtk_render_extension: Requires six parameters: CairoContext, "
+        "x, y, width, height, gap_side");
   }
-  if (!parameters[0].instanceOf("GdkEvent")) {
+  if (!phpgtk_is_cairo_context(parameters[0])) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_extension: First parameter must be a GdkEvent (cairo "
-        "context)");
+        "GtkStyleContext_::gtk_render_extension: First parameter must be a CairoContext");
   }
   if (!parameters[1].isNumeric() || !parameters[2].isNumeric() || !parameters[3].isNumeric() ||
       !parameters[4].isNumeric() || !parameters[5].isNumeric()) {
@@ -1024,8 +1063,7 @@ void GtkStyleContext_::gtk_render_extension(Php::Parameters &parameters) {
         "must be numeric");
   }
 
-  GdkEvent_ *phpgtk_event = (GdkEvent_ *)parameters[0].implementation();
-  cairo_t *cr = (cairo_t *)phpgtk_event->instance;
+  cairo_t *cr = phpgtk_get_cairo_context(parameters[0]);
 
   if (cr == nullptr) {
     throw Php::Exception("GtkStyleContext_::gtk_render_extension: Invalid cairo context");
@@ -1042,15 +1080,15 @@ void GtkStyleContext_::gtk_render_extension(Php::Parameters &parameters) {
 }
 
 void GtkStyleContext_::gtk_render_focus(Php::Parameters &parameters) {
-  // Extract cairo context from GdkEvent wrapper (first parameter)
+  // Extract cairo context (first parameter)
   if (parameters.size() < 5) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_focus: Requires five parameters: GdkEvent (cairo context), "
+        "GtkStyleContext_::gtk_render_focus: Requires five parameters: CairoContext, "
         "x, y, width, height");
   }
-  if (!parameters[0].instanceOf("GdkEvent")) {
+  if (!phpgtk_is_cairo_context(parameters[0])) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_focus: First parameter must be a GdkEvent (cairo context)");
+        "GtkStyleContext_::gtk_render_focus: First parameter must be a CairoContext");
   }
   if (!parameters[1].isNumeric() || !parameters[2].isNumeric() || !parameters[3].isNumeric() ||
       !parameters[4].isNumeric()) {
@@ -1058,8 +1096,7 @@ void GtkStyleContext_::gtk_render_focus(Php::Parameters &parameters) {
         "GtkStyleContext_::gtk_render_focus: Parameters 2-5 (x, y, width, height) must be numeric");
   }
 
-  GdkEvent_ *phpgtk_event = (GdkEvent_ *)parameters[0].implementation();
-  cairo_t *cr = (cairo_t *)phpgtk_event->instance;
+  cairo_t *cr = phpgtk_get_cairo_context(parameters[0]);
 
   if (cr == nullptr) {
     throw Php::Exception("GtkStyleContext_::gtk_render_focus: Invalid cairo context");
@@ -1074,15 +1111,15 @@ void GtkStyleContext_::gtk_render_focus(Php::Parameters &parameters) {
 }
 
 void GtkStyleContext_::gtk_render_frame(Php::Parameters &parameters) {
-  // Extract cairo context from GdkEvent wrapper (first parameter)
+  // Extract cairo context (first parameter)
   if (parameters.size() < 5) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_frame: Requires five parameters: GdkEvent (cairo context), "
+        "GtkStyleContext_::gtk_render_frame: Requires five parameters: CairoContext, "
         "x, y, width, height");
   }
-  if (!parameters[0].instanceOf("GdkEvent")) {
+  if (!phpgtk_is_cairo_context(parameters[0])) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_frame: First parameter must be a GdkEvent (cairo context)");
+        "GtkStyleContext_::gtk_render_frame: First parameter must be a CairoContext");
   }
   if (!parameters[1].isNumeric() || !parameters[2].isNumeric() || !parameters[3].isNumeric() ||
       !parameters[4].isNumeric()) {
@@ -1090,8 +1127,7 @@ void GtkStyleContext_::gtk_render_frame(Php::Parameters &parameters) {
         "GtkStyleContext_::gtk_render_frame: Parameters 2-5 (x, y, width, height) must be numeric");
   }
 
-  GdkEvent_ *phpgtk_event = (GdkEvent_ *)parameters[0].implementation();
-  cairo_t *cr = (cairo_t *)phpgtk_event->instance;
+  cairo_t *cr = phpgtk_get_cairo_context(parameters[0]);
 
   if (cr == nullptr) {
     throw Php::Exception("GtkStyleContext_::gtk_render_frame: Invalid cairo context");
@@ -1106,16 +1142,15 @@ void GtkStyleContext_::gtk_render_frame(Php::Parameters &parameters) {
 }
 
 void GtkStyleContext_::gtk_render_frame_gap(Php::Parameters &parameters) {
-  // Extract cairo context from GdkEvent wrapper (first parameter)
+  // Extract cairo context (first parameter)
   if (parameters.size() < 8) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_frame_gap: Requires eight parameters: GdkEvent (cairo "
-        "context), x, y, width, height, gap_side, xy0_gap, xy1_gap");
+        "GtkStyleContext_::gtk_render_frame_gap: Requires eight parameters: CairoContext, "
+        "x, y, width, height, gap_side, xy0_gap, xy1_gap");
   }
-  if (!parameters[0].instanceOf("GdkEvent")) {
+  if (!phpgtk_is_cairo_context(parameters[0])) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_frame_gap: First parameter must be a GdkEvent (cairo "
-        "context)");
+        "GtkStyleContext_::gtk_render_frame_gap: First parameter must be a CairoContext");
   }
   // Validate parameters 1-7 (user parameters 2-8) are numeric
   if (!parameters[1].isNumeric() || !parameters[2].isNumeric() || !parameters[3].isNumeric() ||
@@ -1126,8 +1161,7 @@ void GtkStyleContext_::gtk_render_frame_gap(Php::Parameters &parameters) {
         "xy0_gap, xy1_gap) must be numeric");
   }
 
-  GdkEvent_ *phpgtk_event = (GdkEvent_ *)parameters[0].implementation();
-  cairo_t *cr = (cairo_t *)phpgtk_event->instance;
+  cairo_t *cr = phpgtk_get_cairo_context(parameters[0]);
 
   if (cr == nullptr) {
     throw Php::Exception("GtkStyleContext_::gtk_render_frame_gap: Invalid cairo context");
@@ -1147,15 +1181,15 @@ void GtkStyleContext_::gtk_render_frame_gap(Php::Parameters &parameters) {
 }
 
 void GtkStyleContext_::gtk_render_handle(Php::Parameters &parameters) {
-  // Extract cairo context from GdkEvent wrapper (first parameter)
+  // Extract cairo context (first parameter)
   if (parameters.size() < 5) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_handle: Requires five parameters: GdkEvent (cairo context), "
+        "GtkStyleContext_::gtk_render_handle: Requires five parameters: CairoContext, "
         "x, y, width, height");
   }
-  if (!parameters[0].instanceOf("GdkEvent")) {
+  if (!phpgtk_is_cairo_context(parameters[0])) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_handle: First parameter must be a GdkEvent (cairo context)");
+        "GtkStyleContext_::gtk_render_handle: First parameter must be a CairoContext");
   }
   if (!parameters[1].isNumeric() || !parameters[2].isNumeric() || !parameters[3].isNumeric() ||
       !parameters[4].isNumeric()) {
@@ -1164,8 +1198,7 @@ void GtkStyleContext_::gtk_render_handle(Php::Parameters &parameters) {
         "numeric");
   }
 
-  GdkEvent_ *phpgtk_event = (GdkEvent_ *)parameters[0].implementation();
-  cairo_t *cr = (cairo_t *)phpgtk_event->instance;
+  cairo_t *cr = phpgtk_get_cairo_context(parameters[0]);
 
   if (cr == nullptr) {
     throw Php::Exception("GtkStyleContext_::gtk_render_handle: Invalid cairo context");
@@ -1186,15 +1219,15 @@ void GtkStyleContext_::gtk_render_layout(Php::Parameters &parameters) {
 }
 
 void GtkStyleContext_::gtk_render_line(Php::Parameters &parameters) {
-  // Extract cairo context from GdkEvent wrapper (first parameter)
+  // Extract cairo context (first parameter)
   if (parameters.size() < 5) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_line: Requires five parameters: GdkEvent (cairo context), "
+        "GtkStyleContext_::gtk_render_line: Requires five parameters: CairoContext, "
         "x0, y0, x1, y1");
   }
-  if (!parameters[0].instanceOf("GdkEvent")) {
+  if (!phpgtk_is_cairo_context(parameters[0])) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_line: First parameter must be a GdkEvent (cairo context)");
+        "GtkStyleContext_::gtk_render_line: First parameter must be a CairoContext");
   }
   if (!parameters[1].isNumeric() || !parameters[2].isNumeric() || !parameters[3].isNumeric() ||
       !parameters[4].isNumeric()) {
@@ -1202,8 +1235,7 @@ void GtkStyleContext_::gtk_render_line(Php::Parameters &parameters) {
         "GtkStyleContext_::gtk_render_line: Parameters 2-5 (x0, y0, x1, y1) must be numeric");
   }
 
-  GdkEvent_ *phpgtk_event = (GdkEvent_ *)parameters[0].implementation();
-  cairo_t *cr = (cairo_t *)phpgtk_event->instance;
+  cairo_t *cr = phpgtk_get_cairo_context(parameters[0]);
 
   if (cr == nullptr) {
     throw Php::Exception("GtkStyleContext_::gtk_render_line: Invalid cairo context");
@@ -1218,15 +1250,15 @@ void GtkStyleContext_::gtk_render_line(Php::Parameters &parameters) {
 }
 
 void GtkStyleContext_::gtk_render_option(Php::Parameters &parameters) {
-  // Extract cairo context from GdkEvent wrapper (first parameter)
+  // Extract cairo context (first parameter)
   if (parameters.size() < 5) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_option: Requires five parameters: GdkEvent (cairo context), "
+        "GtkStyleContext_::gtk_render_option: Requires five parameters: CairoContext, "
         "x, y, width, height");
   }
-  if (!parameters[0].instanceOf("GdkEvent")) {
+  if (!phpgtk_is_cairo_context(parameters[0])) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_option: First parameter must be a GdkEvent (cairo context)");
+        "GtkStyleContext_::gtk_render_option: First parameter must be a CairoContext");
   }
   if (!parameters[1].isNumeric() || !parameters[2].isNumeric() || !parameters[3].isNumeric() ||
       !parameters[4].isNumeric()) {
@@ -1235,8 +1267,7 @@ void GtkStyleContext_::gtk_render_option(Php::Parameters &parameters) {
         "numeric");
   }
 
-  GdkEvent_ *phpgtk_event = (GdkEvent_ *)parameters[0].implementation();
-  cairo_t *cr = (cairo_t *)phpgtk_event->instance;
+  cairo_t *cr = phpgtk_get_cairo_context(parameters[0]);
 
   if (cr == nullptr) {
     throw Php::Exception("GtkStyleContext_::gtk_render_option: Invalid cairo context");
@@ -1251,15 +1282,15 @@ void GtkStyleContext_::gtk_render_option(Php::Parameters &parameters) {
 }
 
 void GtkStyleContext_::gtk_render_slider(Php::Parameters &parameters) {
-  // Extract cairo context from GdkEvent wrapper (first parameter)
+  // Extract cairo context (first parameter)
   if (parameters.size() < 6) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_slider: Requires six parameters: GdkEvent (cairo context), "
+        "GtkStyleContext_::gtk_render_slider: Requires six parameters: CairoContext, "
         "x, y, width, height, orientation");
   }
-  if (!parameters[0].instanceOf("GdkEvent")) {
+  if (!phpgtk_is_cairo_context(parameters[0])) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_slider: First parameter must be a GdkEvent (cairo context)");
+        "GtkStyleContext_::gtk_render_slider: First parameter must be a CairoContext");
   }
   if (!parameters[1].isNumeric() || !parameters[2].isNumeric() || !parameters[3].isNumeric() ||
       !parameters[4].isNumeric() || !parameters[5].isNumeric()) {
@@ -1268,8 +1299,7 @@ void GtkStyleContext_::gtk_render_slider(Php::Parameters &parameters) {
         "must be numeric");
   }
 
-  GdkEvent_ *phpgtk_event = (GdkEvent_ *)parameters[0].implementation();
-  cairo_t *cr = (cairo_t *)phpgtk_event->instance;
+  cairo_t *cr = phpgtk_get_cairo_context(parameters[0]);
 
   if (cr == nullptr) {
     throw Php::Exception("GtkStyleContext_::gtk_render_slider: Invalid cairo context");
@@ -1286,16 +1316,15 @@ void GtkStyleContext_::gtk_render_slider(Php::Parameters &parameters) {
 }
 
 void GtkStyleContext_::gtk_render_activity(Php::Parameters &parameters) {
-  // Extract cairo context from GdkEvent wrapper (first parameter)
+  // Extract cairo context (first parameter)
   if (parameters.size() < 5) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_activity: Requires five parameters: GdkEvent (cairo "
-        "context), x, y, width, height");
+        "GtkStyleContext_::gtk_render_activity: Requires five parameters: CairoContext, "
+        "x, y, width, height");
   }
-  if (!parameters[0].instanceOf("GdkEvent")) {
+  if (!phpgtk_is_cairo_context(parameters[0])) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_activity: First parameter must be a GdkEvent (cairo "
-        "context)");
+        "GtkStyleContext_::gtk_render_activity: First parameter must be a CairoContext");
   }
   if (!parameters[1].isNumeric() || !parameters[2].isNumeric() || !parameters[3].isNumeric() ||
       !parameters[4].isNumeric()) {
@@ -1304,8 +1333,7 @@ void GtkStyleContext_::gtk_render_activity(Php::Parameters &parameters) {
         "numeric");
   }
 
-  GdkEvent_ *phpgtk_event = (GdkEvent_ *)parameters[0].implementation();
-  cairo_t *cr = (cairo_t *)phpgtk_event->instance;
+  cairo_t *cr = phpgtk_get_cairo_context(parameters[0]);
 
   if (cr == nullptr) {
     throw Php::Exception("GtkStyleContext_::gtk_render_activity: Invalid cairo context");
@@ -1371,14 +1399,12 @@ Php::Value GtkStyleContext_::gtk_render_icon_pixbuf(Php::Parameters &parameters)
 }
 
 void GtkStyleContext_::gtk_render_icon_surface(Php::Parameters &parameters) {
-  // Extract cairo context from GdkEvent wrapper (first parameter)
-  if (parameters.empty() || !parameters[0].instanceOf("GdkEvent")) {
+  // Extract cairo context (first parameter)
+  if (parameters.empty() || !phpgtk_is_cairo_context(parameters[0])) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_icon_surface: First parameter must be a GdkEvent (cairo "
-        "context)");
+        "GtkStyleContext_::gtk_render_icon_surface: First parameter must be a CairoContext");
   }
-  GdkEvent_ *phpgtk_event = (GdkEvent_ *)parameters[0].implementation();
-  cairo_t *cr = (cairo_t *)phpgtk_event->instance;
+  cairo_t *cr = phpgtk_get_cairo_context(parameters[0]);
 
   if (cr == nullptr) {
     throw Php::Exception("GtkStyleContext_::gtk_render_icon_surface: Invalid cairo context");
@@ -1395,12 +1421,12 @@ void GtkStyleContext_::gtk_render_icon(Php::Parameters &parameters) {
   // Validate parameters
   if (parameters.size() < 4) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_icon: Requires four parameters: GdkEvent (cairo context), "
+        "GtkStyleContext_::gtk_render_icon: Requires four parameters: CairoContext, "
         "GdkPixbuf, x, y");
   }
-  if (!parameters[0].instanceOf("GdkEvent")) {
+  if (!phpgtk_is_cairo_context(parameters[0])) {
     throw Php::Exception(
-        "GtkStyleContext_::gtk_render_icon: First parameter must be a GdkEvent (cairo context)");
+        "GtkStyleContext_::gtk_render_icon: First parameter must be a CairoContext");
   }
   if (!parameters[1].instanceOf("GdkPixbuf")) {
     throw Php::Exception("GtkStyleContext_::gtk_render_icon: Second parameter must be a GdkPixbuf");
@@ -1410,9 +1436,8 @@ void GtkStyleContext_::gtk_render_icon(Php::Parameters &parameters) {
         "GtkStyleContext_::gtk_render_icon: Third and fourth parameters (x, y) must be numeric");
   }
 
-  // Extract cairo context from GdkEvent wrapper (first parameter)
-  GdkEvent_ *phpgtk_event = (GdkEvent_ *)parameters[0].implementation();
-  cairo_t *cr = (cairo_t *)phpgtk_event->instance;
+  // Extract cairo context (first parameter)
+  cairo_t *cr = phpgtk_get_cairo_context(parameters[0]);
 
   if (cr == nullptr) {
     throw Php::Exception("GtkStyleContext_::gtk_render_icon: Invalid cairo context");
@@ -97,6 +97,14 @@ class GtkStyleContext_ : public GObject_ {
 
   void reset_widgets();
 
+  /**
+   * Swap a set of screen providers (runtime theme switch) and restyle once
+   *
+   * All removals and additions happen without returning to the main loop, so the styles they
+   * invalidate are recomputed once, on the next frame, instead of once per provider
+   */
+  void replace_providers_for_screen(Php::Parameters &parameters);
+
   void set_background(Php::Parameters &parameters);
 
   void restore();
@@ -1,5 +1,12 @@
 
 #include "GtkTextBuffer.h"
+#include "../../php-gtk.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <set>
 
 /**
  * Constructor
@@ -40,8 +47,8 @@ void GtkTextBuffer_::insert(Php::Parameters &parameters) {
   GtkTextIter_ *phpgtk_iter = (GtkTextIter_ *)object_iter.implementation();
   GtkTextIter iter = phpgtk_iter->get_instance();
 
-  std::string s_text = parameters[1];
-  gchar *text = (gchar *)s_text.c_str();
+  phpgtk_string s_text(parameters[1]);
+  const gchar *text = s_text.c_str();
 
   gint len = -1;
   if (parameters.size() >= 3) {
@@ -52,8 +59,8 @@ void GtkTextBuffer_::insert(Php::Parameters &parameters) {
 }
 
 void GtkTextBuffer_::insert_at_cursor(Php::Parameters &parameters) {
-  std::string s_text = parameters[0];
-  gchar *text = (gchar *)s_text.c_str();
+  phpgtk_string s_text(parameters[0]);
+  const gchar *text = s_text.c_str();
 
   gint len = -1;
   if (parameters.size() >= 2) {
@@ -68,8 +75,8 @@ Php::Value GtkTextBuffer_::insert_interactive(Php::Parameters &parameters) {
   GtkTextIter_ *phpgtk_iter = (GtkTextIter_ *)object_iter.implementation();
   GtkTextIter iter = phpgtk_iter->get_instance();
 
-  std::string s_text = parameters[1];
-  gchar *text = (gchar *)s_text.c_str();
+  phpgtk_string s_text(parameters[1]);
+  const gchar *text = s_text.c_str();
 
   gint len = -1;
   if (parameters.size() >= 3) {
@@ -88,8 +95,8 @@ Php::Value GtkTextBuffer_::insert_interactive(Php::Parameters &parameters) {
 }
 
 Php::Value GtkTextBuffer_::insert_interactive_at_cursor(Php::Parameters &parameters) {
-  std::string s_text = parameters[0];
-  gchar *text = (gchar *)s_text.c_str();
+  phpgtk_string s_text(parameters[0]);
+  const gchar *text = s_text.c_str();
 
   gint len = -1;
   if (parameters.size() >= 2) {
@@ -149,8 +156,8 @@ void GtkTextBuffer_::insert_with_tags(Php::Parameters &parameters) {
   GtkTextIter_ *phpgtk_iter = (GtkTextIter_ *)object_iter.implementation();
   GtkTextIter iter = phpgtk_iter->get_instance();
 
-  std::string s_text = parameters[1];
-  gchar *text = (gchar *)s_text.c_str();
+  phpgtk_string s_text(parameters[1]);
+  const gchar *text = s_text.c_str();
 
   gint len = -1;
   if (parameters.size() >= 3) {
@@ -172,8 +179,8 @@ void GtkTextBuffer_::insert_with_tags_by_name(Php::Parameters &parameters) {
   GtkTextIter_ *phpgtk_iter = (GtkTextIter_ *)object_iter.implementation();
   GtkTextIter iter = phpgtk_iter->get_instance();
 
-  std::string s_text = parameters[1];
-  gchar *text = (gchar *)s_text.c_str();
+  phpgtk_string s_text(parameters[1]);
+  const gchar *text = s_text.c_str();
 
   gint len = -1;
   if (parameters.size() >= 3) {
@@ -196,8 +203,8 @@ void GtkTextBuffer_::insert_markup(Php::Parameters &parameters) {
   GtkTextIter_ *phpgtk_iter = (GtkTextIter_ *)object_iter.implementation();
   GtkTextIter iter = phpgtk_iter->get_instance();
 
-  std::string s_markup = parameters[1];
-  gchar *markup = (gchar *)s_markup.c_str();
+  phpgtk_string s_markup(parameters[1]);
+  const gchar *markup = s_markup.c_str();
 
   gint len = -1;
   if (parameters.size() >= 3) {
@@ -252,10 +259,10 @@ Php::Value GtkTextBuffer_::backspace(Php::Parameters &parameters) {
 }
 
 void GtkTextBuffer_::set_text(Php::Parameters &parameters) {
-  std::string s_text = parameters[0];
-  gchar *text = (gchar *)s_text.c_str();
+  phpgtk_string s_text(parameters[0]);
+  const gchar *text = s_text.c_str();
 
-  gint len = s_text.length();
+  gint len = s_text.size();
   if (parameters.size() >= 2) {
     len = (gint)parameters[1];
   }
@@ -310,8 +317,8 @@ void GtkTextBuffer_::insert_pixbuf(Php::Parameters &parameters) {
 }
 
 Php::Value GtkTextBuffer_::create_mark(Php::Parameters &parameters) {
-  std::string s_mark_name = parameters[0];
-  gchar *mark_name = (gchar *)s_mark_name.c_str();
+  phpgtk_string s_mark_name(parameters[0]);
+  const gchar *mark_name = s_mark_name.c_str();
 
   Php::Value object_where = parameters[1];
   GtkTextIter_ *phpgtk_where = (GtkTextIter_ *)object_where.implementation();
@@ -343,8 +350,8 @@ void GtkTextBuffer_::move_mark(Php::Parameters &parameters) {
 }
 
 void GtkTextBuffer_::move_mark_by_name(Php::Parameters &parameters) {
-  std::string s_name = parameters[0];
-  gchar *name = (gchar *)s_name.c_str();
+  phpgtk_string s_name(parameters[0]);
+  const gchar *name = s_name.c_str();
 
   Php::Value object_where = parameters[1];
   GtkTextIter_ *phpgtk_where = (GtkTextIter_ *)object_where.implementation();
@@ -380,15 +387,15 @@ void GtkTextBuffer_::delete_mark(Php::Parameters &parameters) {
 }
 
 void GtkTextBuffer_::delete_mark_by_name(Php::Parameters &parameters) {
-  std::string s_name = parameters[0];
-  gchar *name = (gchar *)s_name.c_str();
+  phpgtk_string s_name(parameters[0]);
+  const gchar *name = s_name.c_str();
 
   gtk_text_buffer_delete_mark_by_name(GTK_TEXT_BUFFER(instance), name);
 }
 
 Php::Value GtkTextBuffer_::get_mark(Php::Parameters &parameters) {
-  std::string s_name = parameters[0];
-  gchar *name = (gchar *)s_name.c_str();
+  phpgtk_string s_name(parameters[0]);
+  const gchar *name = s_name.c_str();
 
   GtkTextMark *ret = gtk_text_buffer_get_mark(GTK_TEXT_BUFFER(instance), name);
 
@@ -478,8 +485,8 @@ void GtkTextBuffer_::remove_tag(Php::Parameters &parameters) {
 }
 
 void GtkTextBuffer_::apply_tag_by_name(Php::Parameters &parameters) {
-  std::string s_name = parameters[0];
-  gchar *name = (gchar *)s_name.c_str();
+  phpgtk_string s_name(parameters[0]);
+  const gchar *name = s_name.c_str();
 
   Php::Value object_start = parameters[1];
   GtkTextIter_ *phpgtk_start = (GtkTextIter_ *)object_start.implementation();
@@ -493,8 +500,8 @@ void GtkTextBuffer_::apply_tag_by_name(Php::Parameters &parameters) {
 }
 
 void GtkTextBuffer_::remove_tag_by_name(Php::Parameters &parameters) {
-  std::string s_name = parameters[0];
-  gchar *name = (gchar *)s_name.c_str();
+  phpgtk_string s_name(parameters[0]);
+  const gchar *name = s_name.c_str();
 
   Php::Value object_start = parameters[1];
   GtkTextIter_ *phpgtk_start = (GtkTextIter_ *)object_start.implementation();
@@ -520,11 +527,11 @@ void GtkTextBuffer_::remove_all_tags(Php::Parameters &parameters) {
 }
 
 Php::Value GtkTextBuffer_::create_tag(Php::Parameters &parameters) {
-  std::string s_tag_name = parameters[0];
-  gchar *tag_name = (gchar *)s_tag_name.c_str();
+  phpgtk_string s_tag_name(parameters[0]);
+  const gchar *tag_name = s_tag_name.c_str();
 
-  std::string s_first_property_name = parameters[1];
-  gchar *first_property_name = (gchar *)s_first_property_name.c_str();
+  phpgtk_string s_first_property_name(parameters[1]);
+  const gchar *first_property_name = s_first_property_name.c_str();
 
   GtkTextTag *ret =
       gtk_text_buffer_create_tag(GTK_TEXT_BUFFER(instance), tag_name, first_property_name);
@@ -778,3 +785,954 @@ Php::Value GtkTextBuffer_::unregister_serialize_format(Php::Parameters &paramete
   throw Php::Exception("GtkTextBuffer_::unregister_serialize_format not implemented");
   return -1;
 }
+
+/**
+ * Cancellable shared by the pending async searches of a buffer
+ */
+#define PHPGTK_TEXT_BUFFER_SEARCH_KEY "phpgtk-text-buffer-search"
+
+/**
+ * One search over a copy of the buffer text, safe to run away from the main thread
+ */
+struct st_text_search {
+  std::string text;
+  GRegex *regex{};
+  int limit{};
+  GCancellable *cancellable{};
+
+  // Set when a replacement could not be expanded
+  std::string error;
+
+  // Replacement template, expanded per match when expand is set
+  std::string replacement;
+  bool expand{};
+
+  std::vector<std::pair<gint, gint>> matches;
+  std::vector<std::string> replacements;
+
+  ~st_text_search() {
+    if (regex != nullptr) {
+      g_regex_unref(regex);
+    }
+  }
+};
+
+/**
+ * PHP side of an async search, kept out of the task data that the worker thread may release
+ */
+struct st_text_search_callback {
+  Php::Value self;
+  Php::Value done_callback;
+};
+
+static GRegex *phpgtk_search_regex(const std::string &pattern, int flags) {
+  std::string s_pattern = pattern;
+  if (!(flags & GtkTextBuffer_::SEARCH_REGEX)) {
+    gchar *escaped = g_regex_escape_string(pattern.c_str(), (gint)pattern.size());
+    s_pattern = escaped;
+    g_free(escaped);
+  }
+
+  if (flags & GtkTextBuffer_::SEARCH_WHOLE_WORD) {
+    s_pattern = "\\b(?:" + s_pattern + ")\\b";
+  }
+
+  int compile_flags = G_REGEX_MULTILINE | G_REGEX_OPTIMIZE;
+  if (flags & GtkTextBuffer_::SEARCH_CASE_INSENSITIVE) {
+    compile_flags |= G_REGEX_CASELESS;
+  }
+
+  GError *error = nullptr;
+  GRegex *regex = g_regex_new(s_pattern.c_str(), (GRegexCompileFlags)compile_flags,
+                              (GRegexMatchFlags)0, &error);
+
+  if (regex == nullptr) {
+    std::string message = (error != nullptr) ? error->message : "unknown error";
+    if (error != nullptr) {
+      g_error_free(error);
+    }
+    throw Php::Exception("GtkTextBuffer: invalid search pattern: " + message);
+  }
+
+  return regex;
+}
+
+/**
+ * Collect the matches as character offsets, counting characters only between two matches
+ */
+static void phpgtk_search_run(st_text_search *search) {
+  const gchar *text = search->text.c_str();
+  gint last_byte = 0;
+  gint last_char = 0;
+
+  GMatchInfo *match_info = nullptr;
+  g_regex_match_full(search->regex, text, (gssize)search->text.size(), 0, (GRegexMatchFlags)0,
+                     &match_info, nullptr);
+
+  while (g_match_info_matches(match_info)) {
+    if (search->cancellable != nullptr && g_cancellable_is_cancelled(search->cancellable)) {
+      break;
+    }
+
+    gint start_byte;
+    gint end_byte;
+    g_match_info_fetch_pos(match_info, 0, &start_byte, &end_byte);
+
+    gint start_char = last_char + (gint)g_utf8_strlen(text + last_byte, start_byte - last_byte);
+    gint end_char = start_char + (gint)g_utf8_strlen(text + start_byte, end_byte - start_byte);
+    last_byte = end_byte;
+    last_char = end_char;
+
+    search->matches.emplace_back(start_char, end_char);
+
+    if (search->expand) {
+      GError *error = nullptr;
+      gchar *expanded = g_match_info_expand_references(match_info, search->replacement.c_str(),
+                                                       &error);
+      if (expanded == nullptr) {
+        search->error = (error != nullptr) ? error->message : "unknown error";
+        if (error != nullptr) {
+          g_error_free(error);
+        }
+        break;
+      }
+
+      search->replacements.push_back(expanded);
+      g_free(expanded);
+    }
+
+    if (search->limit > 0 && (int)search->matches.size() >= search->limit) {
+      break;
+    }
+
+    g_match_info_next(match_info, nullptr);
+  }
+
+  g_match_info_free(match_info);
+}
+
+static Php::Value phpgtk_search_matches(st_text_search *search) {
+  Php::Array ret_arr;
+  for (size_t i = 0; i < search->matches.size(); i++) {
+    Php::Array match;
+    match[0] = search->matches[i].first;
+    match[1] = search->matches[i].second;
+    ret_arr[(int)i] = match;
+  }
+
+  return ret_arr;
+}
+
+/**
+ * Copy the whole text, get_slice keeps one character per pixbuf so offsets line up
+ */
+static std::string phpgtk_search_text(GtkTextBuffer *buffer) {
+  GtkTextIter start;
+  GtkTextIter end;
+  gtk_text_buffer_get_bounds(buffer, &start, &end);
+
+  gchar *text = gtk_text_buffer_get_slice(buffer, &start, &end, TRUE);
+  std::string s_text = text;
+  g_free(text);
+
+  return s_text;
+}
+
+Php::Value GtkTextBuffer_::search_all(Php::Parameters &parameters) {
+  std::string pattern = parameters[0];
+  int flags = (parameters.size() > 1) ? (int)parameters[1] : 0;
+
+  st_text_search search;
+  search.regex = phpgtk_search_regex(pattern, flags);
+  search.text = phpgtk_search_text(GTK_TEXT_BUFFER(instance));
+  if (parameters.size() > 2) {
+    search.limit = parameters[2];
+  }
+
+  phpgtk_search_run(&search);
+
+  return phpgtk_search_matches(&search);
+}
+
+static void phpgtk_search_thread(GTask *task, gpointer source_object, gpointer task_data,
+                                 GCancellable *cancellable) {
+  phpgtk_search_run((st_text_search *)task_data);
+
+  if (!g_task_return_error_if_cancelled(task)) {
+    g_task_return_boolean(task, TRUE);
+  }
+}
+
+static void phpgtk_search_ready(GObject *source_object, GAsyncResult *result, gpointer data) {
+  st_text_search *search = (st_text_search *)g_task_get_task_data(G_TASK(result));
+
+  // Released here, on the main thread
+  st_text_search_callback *callback = (st_text_search_callback *)data;
+
+  // A cancelled search never calls back
+  GError *error = nullptr;
+  if (!g_task_propagate_boolean(G_TASK(result), &error)) {
+    if (error != nullptr) {
+      g_error_free(error);
+    }
+    delete callback;
+    return;
+  }
+  Php::Value done_callback = callback->done_callback;
+  Php::Value internal_parameters;
+  internal_parameters[0] = callback->self;
+  internal_parameters[1] = phpgtk_search_matches(search);
+  delete callback;
+
+  try {
+    Php::call("call_user_func_array", done_callback, internal_parameters);
+  } catch (Php::Exception &exception) {
+    // Re-throw to let PHP-CPP handle the exception properly
+    throw;
+  }
+}
+
+static void phpgtk_search_free(gpointer data) {
+  st_text_search *search = (st_text_search *)data;
+  if (search->cancellable != nullptr) {
+    g_object_unref(search->cancellable);
+  }
+
+  delete search;
+}
+
+void GtkTextBuffer_::search_all_async(Php::Parameters &parameters) {
+  if (parameters.size() < 3 || !parameters[2].isCallable()) {
+    throw Php::Exception("GtkTextBuffer::search_all_async expects a pattern, flags and a callable");
+  }
+
+  std::string pattern = parameters[0];
+  int flags = parameters[1];
+
+  // The pattern is checked here, so errors are thrown to the caller and not to the callback
+  st_text_search *search = new st_text_search();
+  try {
+    search->regex = phpgtk_search_regex(pattern, flags);
+  } catch (Php::Exception &exception) {
+    delete search;
+    throw;
+  }
+
+  search->text = phpgtk_search_text(GTK_TEXT_BUFFER(instance));
+
+  // All pending searches of the buffer share one cancellable, replaced once cancelled
+  GCancellable *cancellable =
+      (GCancellable *)g_object_get_data(G_OBJECT(instance), PHPGTK_TEXT_BUFFER_SEARCH_KEY);
+  if (cancellable == nullptr) {
+    cancellable = g_cancellable_new();
+    g_object_set_data_full(G_OBJECT(instance), PHPGTK_TEXT_BUFFER_SEARCH_KEY, cancellable,
+                           g_object_unref);
+  }
+  search->cancellable = G_CANCELLABLE(g_object_ref(cancellable));
+
+  st_text_search_callback *callback = new st_text_search_callback();
+  callback->self = cobject_to_phpobject(instance);
+  callback->done_callback = parameters[2];
+
+  GTask *task = g_task_new(nullptr, cancellable, phpgtk_search_ready, callback);
+  g_task_set_task_data(task, search, phpgtk_search_free);
+  g_task_run_in_thread(task, phpgtk_search_thread);
+  g_object_unref(task);
+}
+
+void GtkTextBuffer_::cancel_searches() {
+  GCancellable *cancellable =
+      (GCancellable *)g_object_get_data(G_OBJECT(instance), PHPGTK_TEXT_BUFFER_SEARCH_KEY);
+  if (cancellable == nullptr) {
+    return;
+  }
+
+  g_cancellable_cancel(cancellable);
+  g_object_set_data(G_OBJECT(instance), PHPGTK_TEXT_BUFFER_SEARCH_KEY, nullptr);
+}
+
+Php::Value GtkTextBuffer_::replace_all(Php::Parameters &parameters) {
+  std::string pattern = parameters[0];
+  std::string replacement = parameters[1];
+  int flags = (parameters.size() > 2) ? (int)parameters[2] : 0;
+
+  GtkTextBuffer *buffer = GTK_TEXT_BUFFER(instance);
+
+  st_text_search search;
+  search.expand = (flags & SEARCH_REGEX) != 0;
+
+  // A malformed template would otherwise expand to nothing and delete every match
+  if (search.expand) {
+    GError *error = nullptr;
+    if (!g_regex_check_replacement(replacement.c_str(), nullptr, &error)) {
+      std::string message = (error != nullptr) ? error->message : "unknown error";
+      if (error != nullptr) {
+        g_error_free(error);
+      }
+      throw Php::Exception("GtkTextBuffer::replace_all: invalid replacement: " + message);
+    }
+  }
+
+  search.regex = phpgtk_search_regex(pattern, flags);
+  search.text = phpgtk_search_text(buffer);
+  search.replacement = replacement;
+
+  phpgtk_search_run(&search);
+
+  if (!search.error.empty()) {
+    throw Php::Exception("GtkTextBuffer::replace_all: invalid replacement: " + search.error);
+  }
+
+  if (search.matches.empty()) {
+    return 0;
+  }
+
+  // Last match first, so the offsets of the ones before it stay valid
+  gtk_text_buffer_begin_user_action(buffer);
+
+  for (size_t i = search.matches.size(); i-- > 0;) {
+    GtkTextIter start;
+    GtkTextIter end;
+    gtk_text_buffer_get_iter_at_offset(buffer, &start, search.matches[i].first);
+    gtk_text_buffer_get_iter_at_offset(buffer, &end, search.matches[i].second);
+
+    gtk_text_buffer_delete(buffer, &start, &end);
+
+    const std::string &text = search.expand ? search.replacements[i] : replacement;
+    gtk_text_buffer_insert(buffer, &start, text.c_str(), (gint)text.size());
+  }
+
+  gtk_text_buffer_end_user_action(buffer);
+
+  return (int)search.matches.size();
+}
+
+/**
+ * One tagged range, in character offsets
+ */
+struct st_text_run {
+  gint start;
+  gint end;
+  GtkTextTag *tag;
+};
+
+Php::Value GtkTextBuffer_::export_runs() {
+  GtkTextBuffer *buffer = GTK_TEXT_BUFFER(instance);
+
+  GtkTextIter iter;
+  GtkTextIter end;
+  gtk_text_buffer_get_bounds(buffer, &iter, &end);
+
+  gchar *text = gtk_text_buffer_get_slice(buffer, &iter, &end, TRUE);
+  Php::Value php_text = text;
+  g_free(text);
+
+  // Walk the toggles only, opening a run on each toggle on and closing it on the toggle off
+  std::map<GtkTextTag *, gint> open_runs;
+  std::vector<st_text_run> runs;
+
+  do {
+    gint offset = gtk_text_iter_get_offset(&iter);
+
+    GSList *closed = gtk_text_iter_get_toggled_tags(&iter, FALSE);
+    for (GSList *item = closed; item != nullptr; item = item->next) {
+      auto found = open_runs.find(GTK_TEXT_TAG(item->data));
+      if (found != open_runs.end()) {
+        runs.push_back({found->second, offset, found->first});
+        open_runs.erase(found);
+      }
+    }
+    g_slist_free(closed);
+
+    GSList *opened = gtk_text_iter_get_toggled_tags(&iter, TRUE);
+    for (GSList *item = opened; item != nullptr; item = item->next) {
+      open_runs[GTK_TEXT_TAG(item->data)] = offset;
+    }
+    g_slist_free(opened);
+  } while (gtk_text_iter_forward_to_tag_toggle(&iter, nullptr));
+
+  // Tags reaching the end of the buffer
+  gint n_chars = gtk_text_iter_get_offset(&end);
+  for (auto &open_run : open_runs) {
+    runs.push_back({open_run.second, n_chars, open_run.first});
+  }
+
+  std::stable_sort(runs.begin(), runs.end(), [](const st_text_run &a, const st_text_run &b) {
+    return a.start < b.start;
+  });
+
+  Php::Array php_runs;
+  int n_runs = 0;
+  for (auto &run : runs) {
+    gchar *name = nullptr;
+    g_object_get(run.tag, "name", &name, nullptr);
+    if (name == nullptr) {
+      continue;
+    }
+
+    Php::Array php_run;
+    php_run[0] = run.start;
+    php_run[1] = run.end;
+    php_run[2] = name;
+    php_runs[n_runs++] = php_run;
+
+    g_free(name);
+  }
+
+  Php::Array ret_arr;
+  ret_arr["text"] = php_text;
+  ret_arr["runs"] = php_runs;
+
+  return ret_arr;
+}
+
+Php::Value GtkTextBuffer_::import_runs(Php::Parameters &parameters) {
+  Php::Value php_text;
+  Php::Value php_runs;
+
+  if (parameters.size() == 1 && parameters[0].isArray()) {
+    php_text = parameters[0].get("text");
+    php_runs = parameters[0].get("runs");
+  } else if (parameters.size() > 1) {
+    php_text = parameters[0];
+    php_runs = parameters[1];
+  } else {
+    throw Php::Exception(
+        "GtkTextBuffer::import_runs expects an export_runs() array, or text and runs");
+  }
+
+  GtkTextBuffer *buffer = GTK_TEXT_BUFFER(instance);
+  GtkTextTagTable *table = gtk_text_buffer_get_tag_table(buffer);
+  std::string text = php_text.stringValue();
+
+  // gtk_text_buffer_insert() silently refuses invalid UTF-8, check before the content is deleted
+  const gchar *invalid = nullptr;
+  if (!g_utf8_validate(text.c_str(), (gssize)text.size(), &invalid)) {
+    throw Php::Exception("GtkTextBuffer::import_runs: text is not valid UTF-8 at byte " +
+                         std::to_string(invalid - text.c_str()));
+  }
+
+  gtk_text_buffer_begin_user_action(buffer);
+
+  GtkTextIter start;
+  GtkTextIter end;
+  gtk_text_buffer_get_bounds(buffer, &start, &end);
+  gtk_text_buffer_delete(buffer, &start, &end);
+  gtk_text_buffer_insert(buffer, &start, text.c_str(), (gint)text.size());
+
+  // Runs repeat a handful of tag names, look each one up once
+  std::map<std::string, GtkTextTag *> tags;
+  gint n_chars = gtk_text_buffer_get_char_count(buffer);
+  int applied = 0;
+
+  for (auto &iter : php_runs) {
+    const Php::Value &php_run = iter.second;
+    if (!php_run.isArray() || php_run.size() < 3) {
+      continue;
+    }
+
+    std::string name = php_run.get(2).stringValue();
+    auto found = tags.find(name);
+    if (found == tags.end()) {
+      GtkTextTag *tag = gtk_text_tag_table_lookup(table, name.c_str());
+      found = tags.insert(std::make_pair(name, tag)).first;
+    }
+
+    gint run_start = (gint)php_run.get(0).numericValue();
+    gint run_end = (gint)php_run.get(1).numericValue();
+    if (found->second == nullptr || run_start < 0 || run_end > n_chars || run_start >= run_end) {
+      continue;
+    }
+
+    gtk_text_buffer_get_iter_at_offset(buffer, &start, run_start);
+    gtk_text_buffer_get_iter_at_offset(buffer, &end, run_end);
+    gtk_text_buffer_apply_tag(buffer, found->second, &start, &end);
+    applied++;
+  }
+
+  gtk_text_buffer_end_user_action(buffer);
+
+  return applied;
+}
+
+/**
+ * Key of the undo log on the GObject
+ */
+#define PHPGTK_TEXT_BUFFER_UNDO_KEY "phpgtk-text-buffer-undo"
+
+/**
+ * Kinds of recorded change
+ */
+enum st_undo_kind { UNDO_INSERT, UNDO_DELETE, UNDO_APPLY_TAG, UNDO_REMOVE_TAG };
+
+/**
+ * Tag covering part of a deleted range, offsets relative to the start of the range
+ */
+struct st_undo_tag_run {
+  gint start;
+  gint end;
+  GtkTextTag *tag;
+};
+
+/**
+ * One recorded change, the text and the tags of a deletion are kept so both directions can be
+ * replayed. Tag changes keep their tag over offset to offset + n_chars
+ */
+struct st_undo_op {
+  st_undo_kind kind;
+  gint offset;
+  gint n_chars;
+  std::string text;
+  GtkTextTag *tag{};
+  std::vector<st_undo_tag_run> tag_runs;
+};
+
+/**
+ * Changes undone together, one user action or one merged run of typing
+ */
+struct st_undo_step {
+  std::vector<st_undo_op> ops;
+  size_t bytes{};
+};
+
+struct GtkTextBuffer_::st_undo {
+  GtkTextBuffer *buffer{};
+  gulong handlers[6]{};
+
+  // Tags referenced by the recorded steps, held until the log goes away
+  std::set<GtkTextTag *> tags;
+
+  std::deque<st_undo_step> undo_steps;
+  std::vector<st_undo_step> redo_steps;
+  st_undo_step current;
+
+  size_t bytes{};
+  size_t max_steps{1000};
+  size_t max_bytes{4 * 1024 * 1024};
+
+  int user_action_depth{};
+  bool replaying{};
+
+  // Set when the last step is a single character edit that typing may extend
+  bool can_merge{};
+
+  ~st_undo() {
+    for (gulong handler : handlers) {
+      // Already gone when the buffer itself is finalized
+      if (handler != 0 && g_signal_handler_is_connected(buffer, handler)) {
+        g_signal_handler_disconnect(buffer, handler);
+      }
+    }
+
+    for (GtkTextTag *tag : tags) {
+      g_object_unref(tag);
+    }
+  }
+};
+
+typedef GtkTextBuffer_::st_undo st_undo_state;
+
+static void phpgtk_undo_free(gpointer data) {
+  delete (st_undo_state *)data;
+}
+
+/**
+ * Drop the oldest steps until both caps hold
+ */
+static void phpgtk_undo_trim(st_undo_state *undo) {
+  while (!undo->undo_steps.empty() &&
+         (undo->undo_steps.size() > undo->max_steps || undo->bytes > undo->max_bytes)) {
+    undo->bytes -= undo->undo_steps.front().bytes;
+    undo->undo_steps.pop_front();
+  }
+}
+
+static bool phpgtk_undo_is_space(const std::string &text) {
+  return text.size() == 1 && g_ascii_isspace(text[0]);
+}
+
+/**
+ * Extend the previous step when this is one more character typed or erased next to it,
+ * a word boundary starts a new step
+ */
+static bool phpgtk_undo_merge(st_undo_state *undo, const st_undo_op &op) {
+  if (!undo->can_merge || undo->undo_steps.empty() || op.n_chars != 1) {
+    return false;
+  }
+
+  st_undo_op &last = undo->undo_steps.back().ops.back();
+  if (last.kind != op.kind) {
+    return false;
+  }
+
+  if (op.kind == UNDO_INSERT) {
+    if (op.offset != last.offset + last.n_chars) {
+      return false;
+    }
+    bool last_is_space = g_ascii_isspace(last.text[last.text.size() - 1]);
+    if (phpgtk_undo_is_space(op.text) && !last_is_space) {
+      return false;
+    }
+
+    last.text += op.text;
+  } else if (op.offset == last.offset - 1) {
+    // Backspace, the runs recorded so far move one character right
+    last.text = op.text + last.text;
+    last.offset = op.offset;
+    for (auto &run : last.tag_runs) {
+      run.start++;
+      run.end++;
+    }
+    last.tag_runs.insert(last.tag_runs.end(), op.tag_runs.begin(), op.tag_runs.end());
+  } else if (op.offset == last.offset) {
+    // Delete key
+    last.text += op.text;
+    for (auto run : op.tag_runs) {
+      run.start += last.n_chars;
+      run.end += last.n_chars;
+      last.tag_runs.push_back(run);
+    }
+  } else {
+    return false;
+  }
+
+  size_t op_bytes = op.text.size() + op.tag_runs.size() * sizeof(st_undo_tag_run);
+  last.n_chars++;
+  undo->undo_steps.back().bytes += op_bytes;
+  undo->bytes += op_bytes;
+
+  return true;
+}
+
+/**
+ * Close the step being recorded, once no user action is open anymore
+ */
+static void phpgtk_undo_commit(st_undo_state *undo) {
+  if (undo->user_action_depth > 0 || undo->current.ops.empty()) {
+    return;
+  }
+
+  st_undo_step step;
+  std::swap(step, undo->current);
+
+  undo->redo_steps.clear();
+
+  if (step.ops.size() == 1 && phpgtk_undo_merge(undo, step.ops[0])) {
+    phpgtk_undo_trim(undo);
+    return;
+  }
+
+  undo->can_merge = (step.ops.size() == 1 && step.ops[0].n_chars == 1 &&
+                     (step.ops[0].kind == UNDO_INSERT || step.ops[0].kind == UNDO_DELETE));
+  undo->bytes += step.bytes;
+  undo->undo_steps.push_back(std::move(step));
+
+  phpgtk_undo_trim(undo);
+}
+
+/**
+ * Add the op to the step being recorded
+ */
+static void phpgtk_undo_push(st_undo_state *undo, st_undo_op &&op) {
+  if (op.tag != nullptr && undo->tags.insert(op.tag).second) {
+    g_object_ref(op.tag);
+  }
+  for (auto &run : op.tag_runs) {
+    if (undo->tags.insert(run.tag).second) {
+      g_object_ref(run.tag);
+    }
+  }
+
+  undo->current.bytes += op.text.size() + sizeof(st_undo_op) +
+                         op.tag_runs.size() * sizeof(st_undo_tag_run);
+  undo->current.ops.push_back(std::move(op));
+
+  phpgtk_undo_commit(undo);
+}
+
+static void phpgtk_undo_insert_text(GtkTextBuffer *buffer, GtkTextIter *location, gchar *text,
+                                    gint len, gpointer data) {
+  st_undo_state *undo = (st_undo_state *)data;
+  if (undo->replaying) {
+    return;
+  }
+
+  st_undo_op op;
+  op.kind = UNDO_INSERT;
+  op.offset = gtk_text_iter_get_offset(location);
+  op.text.assign(text, (size_t)len);
+  op.n_chars = (gint)g_utf8_strlen(text, len);
+
+  phpgtk_undo_push(undo, std::move(op));
+}
+
+/**
+ * Tags covering [start, end), walking the toggles only
+ */
+static void phpgtk_undo_tag_runs(const GtkTextIter *start, const GtkTextIter *end,
+                                 std::vector<st_undo_tag_run> &runs) {
+  gint base = gtk_text_iter_get_offset(start);
+  gint end_offset = gtk_text_iter_get_offset(end);
+  std::map<GtkTextTag *, gint> open_runs;
+
+  GSList *tags = gtk_text_iter_get_tags(start);
+  for (GSList *item = tags; item != nullptr; item = item->next) {
+    open_runs[GTK_TEXT_TAG(item->data)] = base;
+  }
+  g_slist_free(tags);
+
+  GtkTextIter iter = *start;
+  while (gtk_text_iter_forward_to_tag_toggle(&iter, nullptr) &&
+         gtk_text_iter_get_offset(&iter) < end_offset) {
+    gint offset = gtk_text_iter_get_offset(&iter);
+
+    GSList *closed = gtk_text_iter_get_toggled_tags(&iter, FALSE);
+    for (GSList *item = closed; item != nullptr; item = item->next) {
+      auto found = open_runs.find(GTK_TEXT_TAG(item->data));
+      if (found != open_runs.end()) {
+        runs.push_back({found->second - base, offset - base, found->first});
+        open_runs.erase(found);
+      }
+    }
+    g_slist_free(closed);
+
+    GSList *opened = gtk_text_iter_get_toggled_tags(&iter, TRUE);
+    for (GSList *item = opened; item != nullptr; item = item->next) {
+      open_runs[GTK_TEXT_TAG(item->data)] = offset;
+    }
+    g_slist_free(opened);
+  }
+
+  for (auto &open_run : open_runs) {
+    runs.push_back({open_run.second - base, end_offset - base, open_run.first});
+  }
+}
+
+/**
+ * Connected before the default handler, the deleted text and its tags are still there
+ */
+static void phpgtk_undo_delete_range(GtkTextBuffer *buffer, GtkTextIter *start, GtkTextIter *end,
+                                     gpointer data) {
+  st_undo_state *undo = (st_undo_state *)data;
+  if (undo->replaying) {
+    return;
+  }
+
+  gchar *text = gtk_text_buffer_get_slice(buffer, start, end, TRUE);
+
+  st_undo_op op;
+  op.kind = UNDO_DELETE;
+  op.offset = gtk_text_iter_get_offset(start);
+  op.text = text;
+  op.n_chars = (gint)g_utf8_strlen(text, -1);
+  phpgtk_undo_tag_runs(start, end, op.tag_runs);
+  g_free(text);
+
+  phpgtk_undo_push(undo, std::move(op));
+}
+
+static void phpgtk_undo_tag_changed(st_undo_state *undo, st_undo_kind kind, GtkTextTag *tag,
+                                    GtkTextIter *start, GtkTextIter *end) {
+  if (undo->replaying) {
+    return;
+  }
+
+  st_undo_op op;
+  op.kind = kind;
+  op.offset = gtk_text_iter_get_offset(start);
+  op.n_chars = gtk_text_iter_get_offset(end) - op.offset;
+  op.tag = tag;
+
+  phpgtk_undo_push(undo, std::move(op));
+}
+
+static void phpgtk_undo_apply_tag(GtkTextBuffer *buffer, GtkTextTag *tag, GtkTextIter *start,
+                                  GtkTextIter *end, gpointer data) {
+  phpgtk_undo_tag_changed((st_undo_state *)data, UNDO_APPLY_TAG, tag, start, end);
+}
+
+static void phpgtk_undo_remove_tag(GtkTextBuffer *buffer, GtkTextTag *tag, GtkTextIter *start,
+                                   GtkTextIter *end, gpointer data) {
+  phpgtk_undo_tag_changed((st_undo_state *)data, UNDO_REMOVE_TAG, tag, start, end);
+}
+
+static void phpgtk_undo_begin_user_action(GtkTextBuffer *buffer, gpointer data) {
+  ((st_undo_state *)data)->user_action_depth++;
+}
+
+static void phpgtk_undo_end_user_action(GtkTextBuffer *buffer, gpointer data) {
+  st_undo_state *undo = (st_undo_state *)data;
+
+  if (undo->user_action_depth > 0) {
+    undo->user_action_depth--;
+  }
+  phpgtk_undo_commit(undo);
+}
+
+/**
+ * Apply a step backward (undo) or forward (redo), with recording off
+ */
+static void phpgtk_undo_replay(st_undo_state *undo, const st_undo_step &step, bool backward) {
+  GtkTextBuffer *buffer = undo->buffer;
+  GtkTextIter start;
+  GtkTextIter end;
+
+  undo->replaying = true;
+  gtk_text_buffer_begin_user_action(buffer);
+
+  size_t n_ops = step.ops.size();
+  for (size_t i = 0; i < n_ops; i++) {
+    const st_undo_op &op = backward ? step.ops[n_ops - 1 - i] : step.ops[i];
+
+    gtk_text_buffer_get_iter_at_offset(buffer, &start, op.offset);
+    gtk_text_buffer_get_iter_at_offset(buffer, &end, op.offset + op.n_chars);
+
+    if (op.kind == UNDO_APPLY_TAG || op.kind == UNDO_REMOVE_TAG) {
+      if ((op.kind == UNDO_APPLY_TAG) != backward) {
+        gtk_text_buffer_apply_tag(buffer, op.tag, &start, &end);
+      } else {
+        gtk_text_buffer_remove_tag(buffer, op.tag, &start, &end);
+      }
+      continue;
+    }
+
+    if ((op.kind == UNDO_INSERT) != backward) {
+      gtk_text_buffer_insert(buffer, &start, op.text.c_str(), (gint)op.text.size());
+
+      // Restore the tags the deleted text had
+      for (auto &run : op.tag_runs) {
+        GtkTextIter run_start;
+        GtkTextIter run_end;
+        gtk_text_buffer_get_iter_at_offset(buffer, &run_start, op.offset + run.start);
+        gtk_text_buffer_get_iter_at_offset(buffer, &run_end, op.offset + run.end);
+        gtk_text_buffer_apply_tag(buffer, run.tag, &run_start, &run_end);
+      }
+      gtk_text_buffer_get_iter_at_offset(buffer, &start, op.offset);
+    } else {
+      gtk_text_buffer_delete(buffer, &start, &end);
+    }
+
+    gtk_text_buffer_place_cursor(buffer, &start);
+  }
+
+  gtk_text_buffer_end_user_action(buffer);
+  undo->replaying = false;
+  undo->can_merge = false;
+}
+
+GtkTextBuffer_::st_undo *GtkTextBuffer_::get_undo(bool create) {
+  st_undo *undo = (st_undo *)g_object_get_data(G_OBJECT(instance), PHPGTK_TEXT_BUFFER_UNDO_KEY);
+
+  if (undo == nullptr && create) {
+    undo = new st_undo();
+    undo->buffer = GTK_TEXT_BUFFER(instance);
+
+    undo->handlers[0] = g_signal_connect(instance, "insert-text",
+                                         G_CALLBACK(phpgtk_undo_insert_text), undo);
+    undo->handlers[1] = g_signal_connect(instance, "delete-range",
+                                         G_CALLBACK(phpgtk_undo_delete_range), undo);
+    undo->handlers[2] = g_signal_connect(instance, "begin-user-action",
+                                         G_CALLBACK(phpgtk_undo_begin_user_action), undo);
+    undo->handlers[3] = g_signal_connect(instance, "end-user-action",
+                                         G_CALLBACK(phpgtk_undo_end_user_action), undo);
+    undo->handlers[4] =
+        g_signal_connect(instance, "apply-tag", G_CALLBACK(phpgtk_undo_apply_tag), undo);
+    undo->handlers[5] =
+        g_signal_connect(instance, "remove-tag", G_CALLBACK(phpgtk_undo_remove_tag), undo);
+
+    g_object_set_data_full(G_OBJECT(instance), PHPGTK_TEXT_BUFFER_UNDO_KEY, undo,
+                           phpgtk_undo_free);
+  }
+
+  return undo;
+}
+
+void GtkTextBuffer_::enable_undo(Php::Parameters &parameters) {
+  st_undo *undo = get_undo(true);
+
+  if (parameters.size() > 0) {
+    int max_steps = parameters[0];
+    undo->max_steps = (max_steps > 0) ? max_steps : 1;
+  }
+
+  if (parameters.size() > 1) {
+    int64_t max_bytes = parameters[1];
+    undo->max_bytes = (max_bytes > 0) ? (size_t)max_bytes : 1;
+  }
+
+  phpgtk_undo_trim(undo);
+}
+
+void GtkTextBuffer_::disable_undo() {
+  // The destroy notify disconnects the handlers and frees the log
+  g_object_set_data(G_OBJECT(instance), PHPGTK_TEXT_BUFFER_UNDO_KEY, nullptr);
+}
+
+void GtkTextBuffer_::clear_undo() {
+  st_undo *undo = get_undo(false);
+  if (undo == nullptr) {
+    return;
+  }
+
+  undo->undo_steps.clear();
+  undo->redo_steps.clear();
+  undo->bytes = 0;
+  undo->can_merge = false;
+}
+
+Php::Value GtkTextBuffer_::undo() {
+  st_undo *undo = get_undo(false);
+  if (undo == nullptr || undo->undo_steps.empty()) {
+    return false;
+  }
+
+  st_undo_step step = std::move(undo->undo_steps.back());
+  undo->undo_steps.pop_back();
+  undo->bytes -= step.bytes;
+
+  phpgtk_undo_replay(undo, step, true);
+  undo->redo_steps.push_back(std::move(step));
+
+  return true;
+}
+
+Php::Value GtkTextBuffer_::redo() {
+  st_undo *undo = get_undo(false);
+  if (undo == nullptr || undo->redo_steps.empty()) {
+    return false;
+  }
+
+  st_undo_step step = std::move(undo->redo_steps.back());
+  undo->redo_steps.pop_back();
+
+  phpgtk_undo_replay(undo, step, false);
+  undo->bytes += step.bytes;
+  undo->undo_steps.push_back(std::move(step));
+
+  phpgtk_undo_trim(undo);
+
+  return true;
+}
+
+Php::Value GtkTextBuffer_::can_undo() {
+  st_undo *undo = get_undo(false);
+
+  return undo != nullptr && !undo->undo_steps.empty();
+}
+
+Php::Value GtkTextBuffer_::can_redo() {
+  st_undo *undo = get_undo(false);
+
+  return undo != nullptr && !undo->redo_steps.empty();
+}
+
+Php::Value GtkTextBuffer_::get_undo_stats() {
+  st_undo *undo = get_undo(false);
+
+  Php::Array ret_arr;
+  ret_arr["undo_steps"] = (undo != nullptr) ? (int)undo->undo_steps.size() : 0;
+  ret_arr["redo_steps"] = (undo != nullptr) ? (int)undo->redo_steps.size() : 0;
+  ret_arr["bytes"] = (undo != nullptr) ? (int64_t)undo->bytes : 0;
+
+  return ret_arr;
+}
@@ -5,6 +5,9 @@
 #include <phpcpp.h>
 #include <gtk/gtk.h>
 
+#include <string>
+#include <vector>
+
 #include "GtkContainer.h"
 #include "GtkTextIter.h"
 #include "GtkTextTag.h"
@@ -21,6 +24,30 @@ class GtkTextBuffer_ : public GObject_ {
    * Publics
    */
  public:
+  /**
+   * Undo history, shared with the buffer signal handlers, defined in GtkTextBuffer.cpp
+   */
+  struct st_undo;
+
+  /**
+   * Privates
+   */
+ private:
+  st_undo *get_undo(bool create);
+
+  /**
+   * Publics
+   */
+ public:
+  /**
+   * search_all() and replace_all() flags
+   */
+  enum {
+    SEARCH_REGEX = 1 << 0,
+    SEARCH_CASE_INSENSITIVE = 1 << 1,
+    SEARCH_WHOLE_WORD = 1 << 2,
+  };
+
   /**
    *  C++ constructor and destructor
    */
@@ -164,6 +191,67 @@ class GtkTextBuffer_ : public GObject_ {
   Php::Value unregister_deserialize_format(Php::Parameters &parameters);
 
   Php::Value unregister_serialize_format(Php::Parameters &parameters);
+
+  /**
+   * search_all($pattern [, $flags [, $limit]]), [[start, end], ...] in character offsets
+   */
+  Php::Value search_all(Php::Parameters &parameters);
+
+  /**
+   * search_all_async($pattern, $flags, callable $done), the match runs on a worker thread over a
+   * copy of the text, then $done($buffer, $matches) runs on the main loop
+   */
+  void search_all_async(Php::Parameters &parameters);
+
+  /**
+   * Stop the pending search_all_async() calls of this buffer, their callbacks are not called
+   */
+  void cancel_searches();
+
+  /**
+   * replace_all($pattern, $replacement [, $flags]), one user action, returns the count.
+   * With SEARCH_REGEX the replacement may use \0 to \9 and \g<name>, a malformed one throws
+   * before the buffer is changed
+   */
+  Php::Value replace_all(Php::Parameters &parameters);
+
+  /**
+   * export_runs(), ['text' => string, 'runs' => [[start, end, tag name], ...]] in one pass.
+   * Offsets are characters, anonymous tags are left out. Pixbufs and child anchors are written
+   * as U+FFFC, import_runs() brings them back as that literal character
+   */
+  Php::Value export_runs();
+
+  /**
+   * import_runs(array $export) or import_runs($text, $runs), replace the content and apply the
+   * runs in one user action. Text that is not valid UTF-8 throws with the buffer unchanged.
+   * Runs naming a tag missing from the table are skipped, returns the number of runs applied
+   */
+  Php::Value import_runs(Php::Parameters &parameters);
+
+  /**
+   * enable_undo([$max_steps [, $max_bytes]]), record insert and delete deltas from now on.
+   * Typing and backspacing over adjacent characters merge into one step per word. Deletions keep
+   * the tags of the removed text, and apply_tag()/remove_tag() are recorded too
+   */
+  void enable_undo(Php::Parameters &parameters);
+
+  void disable_undo();
+
+  void clear_undo();
+
+  Php::Value undo();
+
+  Php::Value redo();
+
+  Php::Value can_undo();
+
+  Php::Value can_redo();
+
+  /**
+   * ['undo_steps' => int, 'redo_steps' => int, 'bytes' => int]
+   */
+  Php::Value get_undo_stats();
 };
 
 #endif
@@ -1,6 +1,10 @@
 
 #include "GtkTreeSelection.h"
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 /**
  * Constructor
  */
@@ -140,52 +144,31 @@ void GtkTreeSelection_::selected_foreach(Php::Parameters &parameters) {
 
   // Php::call("var_dump", "OK 1.0");
 
-  // create a object to populate and pass to generic callback
-  struct generic_st_callback *callback_object =
-      (struct generic_st_callback *)malloc(sizeof(struct generic_st_callback));
-  memset(callback_object, 0, sizeof(struct generic_st_callback));
-
-  callback_object->callback_name = parameters[0];
-
-  // Php::call("var_dump", "OK 1.1");
+  // create a object to populate and pass to generic callback, the foreach is synchronous so the
+  // state lives on the stack and is released on return
+  struct generic_st_callback callback_object;
+  callback_object.callback_name = parameters[0];
 
   // add paramters
-  callback_object->parameters = parameters;
-
-  // Php::call("var_dump", "OK 1.2");
+  callback_object.parameters = parameters;
 
   // add self object
-  callback_object->self_widget = cobject_to_phpobject((gpointer *)instance);
-
-  // Php::call("var_dump", "OK 1.3");
+  callback_object.self_widget = cobject_to_phpobject((gpointer *)instance);
 
   // mount the function params, like showed ini
   // https://docs.gtk.org/gtk3/callback.TreeSelectionForeachFunc.html
-  callback_object->n_params = 3;
-  callback_object->return_type = 0;
-
-  // Php::call("var_dump", "OK 1.4");
-
-  // // add type of each param
-  callback_object->param_types = (GType *)malloc(sizeof(GType) * callback_object->n_params);
-  // Php::call("var_dump", "OK 1.5");
-  callback_object->param_types[0] = g_type_from_name("GtkTreeModel");
-  // Php::call("var_dump", "OK 1.6");
-  callback_object->param_types[1] = g_type_from_name("GtkTreePath");
-  // Php::call("var_dump", "OK 1.7");
-  callback_object->param_types[2] = g_type_from_name("GtkTreeIter");
-  // Php::call("var_dump", "OK 1.8");
-
-  // Php::call("var_dump", "OK 1.9");
-
-  // GClosure  *closure;
-  // closure = g_cclosure_new_swap (G_CALLBACK (generic_callback), callback_object, NULL);
-
-  // // test
-
-  gtk_tree_selection_selected_foreach(
-      GTK_TREE_SELECTION(instance), (GtkTreeSelectionForeachFunc)generic_callback, callback_object);
-  // Php::call("var_dump", "OK 1.10");
+  GType param_types[3];
+  param_types[0] = g_type_from_name("GtkTreeModel");
+  param_types[1] = g_type_from_name("GtkTreePath");
+  param_types[2] = g_type_from_name("GtkTreeIter");
+
+  callback_object.n_params = 3;
+  callback_object.return_type = 0;
+  callback_object.param_types = param_types;
+
+  gtk_tree_selection_selected_foreach(GTK_TREE_SELECTION(instance),
+                                      (GtkTreeSelectionForeachFunc)generic_callback,
+                                      &callback_object);
 }
 
 Php::Value GtkTreeSelection_::get_selected_rows() {
@@ -195,9 +178,13 @@ Php::Value GtkTreeSelection_::get_selected_rows() {
 
   Php::Value ret_arr;
 
-  for (int index = 0; GList *item = g_list_nth(ret, index); index++) {
-    ret_arr[index] = gtk_tree_path_to_string((GtkTreePath *)item->data);
+  int index = 0;
+  for (GList *item = ret; item != nullptr; item = item->next) {
+    gchar *path = gtk_tree_path_to_string((GtkTreePath *)item->data);
+    ret_arr[index++] = path;
+    g_free(path);
   }
+  g_list_free_full(ret, (GDestroyNotify)gtk_tree_path_free);
 
   GtkTreeModel_ *return_parsed_model = new GtkTreeModel_();
   return_parsed_model->set_model(model);
@@ -272,21 +259,154 @@ void GtkTreeSelection_::unselect_all() {
   gtk_tree_selection_unselect_all(GTK_TREE_SELECTION(instance));
 }
 
-void GtkTreeSelection_::unselect_range(Php::Parameters &parameters) {
-  std::string param_start_path = parameters[0];
-  GtkTreePath *start_path = gtk_tree_path_new_from_string(param_start_path.c_str());
+/**
+ * Path from a path string ("3:1") or a top level row index
+ */
+static GtkTreePath *phpgtk_selection_path(const Php::Value &value) {
+  if (value.isNumeric()) {
+    return gtk_tree_path_new_from_indices((gint)value.numericValue(), -1);
+  }
 
-  std::string param_end_path = parameters[1];
-  GtkTreePath *end_path = gtk_tree_path_new_from_string(param_end_path.c_str());
+  std::string s_path = value.stringValue();
+  return gtk_tree_path_new_from_string(s_path.c_str());
+}
+
+void GtkTreeSelection_::unselect_range(Php::Parameters &parameters) {
+  GtkTreePath *start_path = phpgtk_selection_path(parameters[0]);
+  GtkTreePath *end_path = phpgtk_selection_path(parameters[1]);
 
   gtk_tree_selection_unselect_range(GTK_TREE_SELECTION(instance), start_path, end_path);
+
+  gtk_tree_path_free(start_path);
+  gtk_tree_path_free(end_path);
 }
-void GtkTreeSelection_::select_range(Php::Parameters &parameters) {
-  std::string param_start_path = parameters[0];
-  GtkTreePath *start_path = gtk_tree_path_new_from_string(param_start_path.c_str());
 
-  std::string param_end_path = parameters[1];
-  GtkTreePath *end_path = gtk_tree_path_new_from_string(param_end_path.c_str());
+void GtkTreeSelection_::select_range(Php::Parameters &parameters) {
+  GtkTreePath *start_path = phpgtk_selection_path(parameters[0]);
+  GtkTreePath *end_path = phpgtk_selection_path(parameters[1]);
 
   gtk_tree_selection_select_range(GTK_TREE_SELECTION(instance), start_path, end_path);
+
+  gtk_tree_path_free(start_path);
+  gtk_tree_path_free(end_path);
+}
+
+Php::Value GtkTreeSelection_::get_selected_indices() {
+  GList *rows = gtk_tree_selection_get_selected_rows(GTK_TREE_SELECTION(instance), nullptr);
+
+  Php::Array ret_arr;
+  int index = 0;
+  for (GList *item = rows; item != nullptr; item = item->next) {
+    GtkTreePath *path = (GtkTreePath *)item->data;
+
+    gint depth;
+    gint *indices = gtk_tree_path_get_indices_with_depth(path, &depth);
+
+    if (depth == 1) {
+      ret_arr[index++] = indices[0];
+    } else {
+      Php::Array path_arr;
+      for (gint i = 0; i < depth; i++) {
+        path_arr[i] = indices[i];
+      }
+      ret_arr[index++] = path_arr;
+    }
+  }
+
+  g_list_free_full(rows, (GDestroyNotify)gtk_tree_path_free);
+
+  return ret_arr;
+}
+
+Php::Value GtkTreeSelection_::get_selected_data(Php::Parameters &parameters) {
+  if (parameters.empty() || !parameters[0].isArray()) {
+    throw Php::Exception("GtkTreeSelection::get_selected_data expects an array of columns");
+  }
+
+  GtkTreeModel *model;
+  GList *rows = gtk_tree_selection_get_selected_rows(GTK_TREE_SELECTION(instance), &model);
+
+  gint n_columns = gtk_tree_model_get_n_columns(model);
+  std::vector<gint> columns;
+  Php::Value columns_value = parameters[0];
+  for (auto &iter : columns_value) {
+    gint column = (gint)iter.second.numericValue();
+    if (column < 0 || column >= n_columns) {
+      g_list_free_full(rows, (GDestroyNotify)gtk_tree_path_free);
+      throw Php::Exception("GtkTreeSelection::get_selected_data: invalid column " +
+                           std::to_string(column));
+    }
+    columns.push_back(column);
+  }
+
+  Php::Array ret_arr;
+  int index = 0;
+  for (GList *item = rows; item != nullptr; item = item->next) {
+    GtkTreeIter iter;
+    if (!gtk_tree_model_get_iter(model, &iter, (GtkTreePath *)item->data)) {
+      continue;
+    }
+
+    Php::Array row_arr;
+    for (gint column : columns) {
+      GValue value = G_VALUE_INIT;
+      gtk_tree_model_get_value(model, &iter, column, &value);
+      row_arr[column] = phpgtk_property_to_phpvalue(&value);
+      g_value_unset(&value);
+    }
+
+    ret_arr[index++] = row_arr;
+  }
+
+  g_list_free_full(rows, (GDestroyNotify)gtk_tree_path_free);
+
+  return ret_arr;
+}
+
+void GtkTreeSelection_::select_indices(Php::Parameters &parameters) {
+  if (parameters.empty() || !parameters[0].isArray()) {
+    throw Php::Exception("GtkTreeSelection::select_indices expects an array of row indices");
+  }
+
+  std::vector<gint> indices;
+  Php::Value indices_value = parameters[0];
+  for (auto &iter : indices_value) {
+    gint row = (gint)iter.second.numericValue();
+    if (row >= 0) {
+      indices.push_back(row);
+    }
+  }
+
+  if (indices.empty()) {
+    return;
+  }
+
+  std::sort(indices.begin(), indices.end());
+  indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+  GtkTreeSelection *selection = GTK_TREE_SELECTION(instance);
+
+  // A single selection mode keeps only one row, range selection needs multiple
+  if (gtk_tree_selection_get_mode(selection) != GTK_SELECTION_MULTIPLE) {
+    GtkTreePath *path = gtk_tree_path_new_from_indices(indices.back(), -1);
+    gtk_tree_selection_select_path(selection, path);
+    gtk_tree_path_free(path);
+    return;
+  }
+
+  // One select_range, and one "changed", per run of consecutive indices
+  size_t run_start = 0;
+  for (size_t i = 1; i <= indices.size(); i++) {
+    if (i < indices.size() && indices[i] == indices[i - 1] + 1) {
+      continue;
+    }
+
+    GtkTreePath *start_path = gtk_tree_path_new_from_indices(indices[run_start], -1);
+    GtkTreePath *end_path = gtk_tree_path_new_from_indices(indices[i - 1], -1);
+    gtk_tree_selection_select_range(selection, start_path, end_path);
+    gtk_tree_path_free(start_path);
+    gtk_tree_path_free(end_path);
+
+    run_start = i;
+  }
 }
@@ -65,6 +65,21 @@ class GtkTreeSelection_ : public GObject_ {
   void unselect_range(Php::Parameters &parameters);
 
   void select_range(Php::Parameters &parameters);
+
+  /**
+   * Selected rows as indices: an int for top level rows, an array of ints for nested rows
+   */
+  Php::Value get_selected_indices();
+
+  /**
+   * get_selected_data(array $columns): one array of column => value per selected row
+   */
+  Php::Value get_selected_data(Php::Parameters &parameters);
+
+  /**
+   * select_indices(array $indices): top level rows, contiguous runs are selected as ranges
+   */
+  void select_indices(Php::Parameters &parameters);
 };
 
 #endif
@@ -1,10 +1,7 @@
 
 #include "GtkTreeViewColumn.h"
 
-struct GtkTreeViewColumn_::st_request_callback {
-  Php::Parameters user_parameters;
-  Php::Object self_widget;
-};
+struct GtkTreeViewColumn_::st_request_callback : public phpgtk_closure {};
 
 /**
  * Constructor
@@ -301,17 +298,15 @@ void GtkTreeViewColumn_::set_cell_data_func(Php::Parameters &parameters) {
 
   Php::Array callback_params = parameters;
 
-  // Create gpointer user data
-  struct st_request_callback *callback_object =
-      (struct st_request_callback *)malloc(sizeof(struct st_request_callback));
-  memset(callback_object, 0, sizeof(struct st_request_callback));
+  // Create gpointer user data, released when the cell data func is replaced
+  struct st_request_callback *callback_object = new st_request_callback();
   callback_object->user_parameters = parameters;
   callback_object->self_widget = Php::Object("GtkTreeViewColumn", this);
 
   // Call the virtual callback
   gtk_tree_view_column_set_cell_data_func(GTK_TREE_VIEW_COLUMN(instance), cell_renderer,
                                           set_cell_data_func_callback, (gpointer)callback_object,
-                                          nullptr);
+                                          phpgtk_closure::destroy);
 }
 
 void GtkTreeViewColumn_::set_cell_data_func_callback(GtkTreeViewColumn *tree_column,
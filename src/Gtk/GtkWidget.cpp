@@ -2357,4 +2357,80 @@ Php::Value GtkWidget_::scroll_event(Php::Parameters &parameters) {
 
   // 	return ret;
   throw Php::Exception("GtkWidget_::scroll_event not implemented");
-}
\ No newline at end of file
+}
+
+/**
+ * One node of snapshot_tree, children are walked through the GList links
+ */
+static Php::Value phpgtk_snapshot_widget(GtkWidget *widget, const std::vector<std::string> &props) {
+  Php::Array node;
+
+  node["type"] = G_OBJECT_TYPE_NAME(widget);
+  node["name"] = gtk_widget_get_name(widget);
+
+  // Objects without id get an internal "___object_N___" name from GtkBuilder
+  const gchar *id = GTK_IS_BUILDABLE(widget) ? gtk_buildable_get_name(GTK_BUILDABLE(widget))
+                                             : nullptr;
+  if (id != nullptr && g_str_has_prefix(id, "___object_")) {
+    id = nullptr;
+  }
+  node["id"] = (id != nullptr) ? Php::Value(id) : Php::Value(nullptr);
+
+  GtkAllocation allocation;
+  gtk_widget_get_allocation(widget, &allocation);
+
+  Php::Array allocation_arr;
+  allocation_arr["x"] = allocation.x;
+  allocation_arr["y"] = allocation.y;
+  allocation_arr["width"] = allocation.width;
+  allocation_arr["height"] = allocation.height;
+  node["allocation"] = allocation_arr;
+
+  node["visible"] = (bool)gtk_widget_get_visible(widget);
+  node["sensitive"] = (bool)gtk_widget_get_sensitive(widget);
+
+  if (!props.empty()) {
+    Php::Array props_arr;
+    for (auto &prop_name : props) {
+      GParamSpec *spec = phpgtk_lookup_property(G_OBJECT(widget), prop_name.c_str());
+      if (spec == nullptr || !(spec->flags & G_PARAM_READABLE)) {
+        continue;
+      }
+
+      GValue value = G_VALUE_INIT;
+      g_value_init(&value, spec->value_type);
+      g_object_get_property(G_OBJECT(widget), spec->name, &value);
+      props_arr[prop_name] = phpgtk_property_to_phpvalue(&value);
+      g_value_unset(&value);
+    }
+    node["props"] = props_arr;
+  }
+
+  Php::Array children_arr;
+  if (GTK_IS_CONTAINER(widget)) {
+    GList *children = gtk_container_get_children(GTK_CONTAINER(widget));
+
+    int index = 0;
+    for (GList *item = children; item != nullptr; item = item->next) {
+      children_arr[index++] = phpgtk_snapshot_widget(GTK_WIDGET(item->data), props);
+    }
+
+    g_list_free(children);
+  }
+  node["children"] = children_arr;
+
+  return node;
+}
+
+Php::Value GtkWidget_::snapshot_tree(Php::Parameters &parameters) {
+  std::vector<std::string> props;
+
+  if (!parameters.empty() && parameters[0].isArray()) {
+    Php::Value props_value = parameters[0];
+    for (auto &iter : props_value) {
+      props.push_back(iter.second.stringValue());
+    }
+  }
+
+  return phpgtk_snapshot_widget(GTK_WIDGET(instance), props);
+}
@@ -544,6 +544,15 @@ class GtkWidget_ : public GObject_ {
   void class_set_connect_func(Php::Parameters &parameters);
 
   Php::Value scroll_event(Php::Parameters &parameters);
+
+  /**
+   * Walk the widget hierarchy natively and return it as nested arrays
+   *
+   * snapshot_tree([array $props]) gives, for this widget and each descendant: type, name, id
+   * (GtkBuildable name, or null), allocation, visible, sensitive, the requested properties the
+   * widget has, and children
+   */
+  Php::Value snapshot_tree(Php::Parameters &parameters);
 };
 
 #endif
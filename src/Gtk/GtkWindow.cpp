@@ -27,7 +27,7 @@ void GtkWindow_::__construct(Php::Parameters &parameters) {
  * Sets the title of the GtkWindow
  */
 void GtkWindow_::set_title(Php::Parameters &parameters) {
-  std::string title = parameters[0];
+  phpgtk_string title(parameters[0]);
 
   gtk_window_set_title(GTK_WINDOW(instance), title.c_str());
 }
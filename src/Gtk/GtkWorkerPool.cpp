@@ -0,0 +1,870 @@
+#include "GtkWorkerPool.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <gio/gio.h>
+#include <glib-unix.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * Frames on the worker sockets: one type byte, the length in host order, then the data
+ */
+#define PHPGTK_WORKER_FRAME_JOB 'J'
+#define PHPGTK_WORKER_FRAME_RESULT 'R'
+#define PHPGTK_WORKER_FRAME_ERROR 'E'
+#define PHPGTK_WORKER_HEADER_SIZE (1 + sizeof(guint32))
+
+/**
+ * Size of each read on the parent side
+ */
+#define PHPGTK_WORKER_READ_SIZE 65536
+
+/**
+ * Largest job or reply frame, bigger ones are refused on both sides
+ */
+#define PHPGTK_WORKER_MAX_FRAME_SIZE 536870912
+
+/**
+ * Function or "Class::method" name accepted as handler
+ */
+#define PHPGTK_WORKER_HANDLER_PATTERN                      \
+  "/^\\\\?[a-zA-Z_\\x80-\\xff][a-zA-Z0-9_\\x80-\\xff\\\\]*" \
+  "(::[a-zA-Z_\\x80-\\xff][a-zA-Z0-9_\\x80-\\xff]*)?$/"
+
+/**
+ * Descriptor of the socket in the worker process
+ */
+#define PHPGTK_WORKER_CHILD_FD 3
+
+/**
+ * Respawn budget: past this many unexpected worker exits within the window the pool is broken.
+ * Each respawn waits the delay, doubled per recent exit up to the maximum
+ */
+#define PHPGTK_WORKER_MAX_FAILURES 5
+#define PHPGTK_WORKER_FAILURE_WINDOW (10 * G_TIME_SPAN_SECOND)
+#define PHPGTK_WORKER_RESPAWN_DELAY_MS 100
+#define PHPGTK_WORKER_RESPAWN_MAX_DELAY_MS 5000
+
+/**
+ * Job loop run by "php -r" in each worker: $argv[1] is the bootstrap file, $argv[2] the
+ * serialized handler. Output of the handler is discarded, the socket only carries frames
+ */
+static const char *phpgtk_worker_script =
+    "if ($argv[1] !== '') { require $argv[1]; }"
+    "$handler = unserialize($argv[2]);"
+    "$socket = fopen('php://fd/3', 'r+');"
+    "$read = function ($size) use ($socket) {"
+    "  $data = '';"
+    "  while (strlen($data) < $size) {"
+    "    $chunk = fread($socket, $size - strlen($data));"
+    "    if ($chunk === false || $chunk === '') { return null; }"
+    "    $data .= $chunk;"
+    "  }"
+    "  return $data;"
+    "};"
+    "while (($header = $read(5)) !== null) {"
+    "  $length = unpack('L', substr($header, 1))[1];"
+    "  $payload = ($length > 0) ? $read($length) : '';"
+    "  if ($payload === null) { break; }"
+    "  $type = 'R';"
+    "  ob_start();"
+    "  try {"
+    "    $reply = serialize(call_user_func($handler, unserialize($payload)));"
+    "  } catch (\\Throwable $exception) {"
+    "    $type = 'E';"
+    "    $reply = $exception->getMessage();"
+    "  }"
+    "  ob_end_clean();"
+    "  if (strlen($reply) > " G_STRINGIFY(PHPGTK_WORKER_MAX_FRAME_SIZE) ") {"
+    "    $type = 'E';"
+    "    $reply = 'GtkWorkerPool: the result is too large';"
+    "  }"
+    "  fwrite($socket, $type . pack('L', strlen($reply)) . $reply);"
+    "}";
+
+/**
+ * One submitted job, owned by the queue, then by the worker running it
+ */
+struct st_worker_job {
+  gint64 id{};
+  std::string payload;
+  Php::Value callback;
+  std::vector<Php::Value> user_parameters;
+  bool cancelled{};
+};
+
+/**
+ * Parent side of one worker process
+ */
+struct st_worker {
+  GtkWorkerPool_::st_pool *pool{};
+
+  GSubprocess *process{};
+  int fd{-1};
+  guint in_source{};
+  guint out_source{};
+  guint respawn_source{};
+
+  // Set when the parent ends the process on purpose, its exit is then not a failure
+  bool killed{};
+
+  std::string inbuf;
+  std::string outbuf;
+  st_worker_job *job{};
+};
+
+/**
+ * State of the pool, the workers are kept until the pool is destroyed, so the main loop sources
+ * can always reach them
+ */
+struct GtkWorkerPool_::st_pool {
+  GtkWorkerPool_ *self{};
+  Php::Value drain_callback;
+
+  // Command line of the workers
+  std::vector<std::string> argv;
+
+  std::vector<st_worker *> workers;
+  std::deque<st_worker_job *> queue;
+
+  size_t max_pending{256};
+  gint64 next_id{1};
+  bool refused{};
+  bool shut_down{};
+
+  // Monotonic times of the recent unexpected exits, the pool is broken past the budget
+  std::deque<gint64> failures;
+  bool broken{};
+
+  gint64 submitted{};
+  gint64 completed{};
+  gint64 failed{};
+  gint64 cancelled{};
+  gint64 respawned{};
+};
+
+typedef GtkWorkerPool_::st_pool st_pool_state;
+
+static void phpgtk_worker_frame(std::string &out, char type, const std::string &data) {
+  guint32 length = (guint32)data.size();
+
+  out.append(1, type);
+  out.append((const char *)&length, sizeof(length));
+  out.append(data);
+}
+
+static gboolean phpgtk_worker_in_callback(gint fd, GIOCondition condition, gpointer data);
+
+/**
+ * Start one worker, a new PHP process and not a fork: this process runs GTK and GLib threads,
+ * a forked copy could deadlock on a lock one of them held
+ */
+static bool phpgtk_worker_spawn(st_worker *worker, GError **error) {
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+    int saved_errno = errno;
+    g_set_error_literal(error, G_IO_ERROR, g_io_error_from_errno(saved_errno),
+                        g_strerror(saved_errno));
+    return false;
+  }
+
+  std::vector<const gchar *> argv;
+  for (auto &arg : worker->pool->argv) {
+    argv.push_back(arg.c_str());
+  }
+  argv.push_back(nullptr);
+
+  // The launcher closes the child end here once it is freed
+  GSubprocessLauncher *launcher = g_subprocess_launcher_new(G_SUBPROCESS_FLAGS_NONE);
+  g_subprocess_launcher_take_fd(launcher, fds[1], PHPGTK_WORKER_CHILD_FD);
+  GSubprocess *process = g_subprocess_launcher_spawnv(launcher, argv.data(), error);
+  g_object_unref(launcher);
+
+  if (process == nullptr) {
+    close(fds[0]);
+    return false;
+  }
+
+  fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+  worker->process = process;
+  worker->fd = fds[0];
+  worker->inbuf.clear();
+  worker->outbuf.clear();
+  worker->killed = false;
+
+  worker->in_source =
+      g_unix_fd_add(worker->fd, (GIOCondition)(G_IO_IN | G_IO_HUP | G_IO_ERR),
+                    phpgtk_worker_in_callback, worker);
+
+  return true;
+}
+
+static void phpgtk_worker_close(st_worker *worker) {
+  if (worker->respawn_source != 0) {
+    g_source_remove(worker->respawn_source);
+    worker->respawn_source = 0;
+  }
+
+  if (worker->in_source != 0) {
+    g_source_remove(worker->in_source);
+    worker->in_source = 0;
+  }
+
+  if (worker->out_source != 0) {
+    g_source_remove(worker->out_source);
+    worker->out_source = 0;
+  }
+
+  if (worker->fd >= 0) {
+    close(worker->fd);
+    worker->fd = -1;
+  }
+
+  // GLib still reaps the process when it exits
+  if (worker->process != nullptr) {
+    g_object_unref(worker->process);
+    worker->process = nullptr;
+  }
+
+  worker->inbuf.clear();
+  worker->outbuf.clear();
+}
+
+static bool phpgtk_worker_flush(st_worker *worker);
+
+static gboolean phpgtk_worker_out_callback(gint fd, GIOCondition condition, gpointer data) {
+  st_worker *worker = (st_worker *)data;
+
+  // The flush adds a new watch if the socket is still full
+  worker->out_source = 0;
+  phpgtk_worker_flush(worker);
+
+  return G_SOURCE_REMOVE;
+}
+
+/**
+ * Write what the socket takes now, the rest waits for G_IO_OUT. A broken socket is left to the
+ * input watch, which sees the hang up
+ */
+static bool phpgtk_worker_flush(st_worker *worker) {
+  while (!worker->outbuf.empty()) {
+    ssize_t n_written = send(worker->fd, worker->outbuf.data(), worker->outbuf.size(),
+                             MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (n_written < 0 && errno == EINTR) {
+      continue;
+    }
+
+    if (n_written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      if (worker->out_source == 0) {
+        worker->out_source =
+            g_unix_fd_add(worker->fd, G_IO_OUT, phpgtk_worker_out_callback, worker);
+      }
+      return true;
+    }
+
+    if (n_written <= 0) {
+      return false;
+    }
+
+    worker->outbuf.erase(0, n_written);
+  }
+
+  if (worker->out_source != 0) {
+    g_source_remove(worker->out_source);
+    worker->out_source = 0;
+  }
+
+  return true;
+}
+
+/**
+ * Hand queued jobs to the idle workers
+ */
+static void phpgtk_worker_dispatch(st_pool_state *pool) {
+  for (st_worker *worker : pool->workers) {
+    if (pool->queue.empty()) {
+      break;
+    }
+
+    if (worker->fd < 0 || worker->job != nullptr) {
+      continue;
+    }
+
+    st_worker_job *job = pool->queue.front();
+    pool->queue.pop_front();
+
+    worker->job = job;
+    phpgtk_worker_frame(worker->outbuf, PHPGTK_WORKER_FRAME_JOB, job->payload);
+    std::string().swap(job->payload);
+
+    phpgtk_worker_flush(worker);
+  }
+}
+
+/**
+ * Call the job callback, unless the job was cancelled, and release the job
+ */
+static void phpgtk_worker_deliver(st_pool_state *pool, st_worker_job *job,
+                                  const Php::Value &result, const Php::Value &error) {
+  std::unique_ptr<st_worker_job> guard(job);
+
+  if (job->cancelled || !job->callback.isCallable()) {
+    return;
+  }
+
+  Php::Value internal_parameters;
+  internal_parameters[0] = Php::Object("GtkWorkerPool", pool->self);
+  internal_parameters[1] = (int64_t)job->id;
+  internal_parameters[2] = result;
+  internal_parameters[3] = error;
+  for (size_t i = 0; i < job->user_parameters.size(); i++) {
+    internal_parameters[(int)i + 4] = job->user_parameters[i];
+  }
+
+  try {
+    Php::call("call_user_func_array", job->callback, internal_parameters);
+  } catch (Php::Exception &exception) {
+    // Re-throw to let PHP-CPP handle the exception properly
+    throw;
+  }
+}
+
+/**
+ * Tell PHP it may submit again, once per refused submit
+ */
+static void phpgtk_worker_check_drain(st_pool_state *pool) {
+  if (!pool->refused || pool->shut_down || pool->queue.size() > pool->max_pending / 2) {
+    return;
+  }
+
+  pool->refused = false;
+
+  if (!pool->drain_callback.isCallable()) {
+    return;
+  }
+
+  Php::Value internal_parameters;
+  internal_parameters[0] = Php::Object("GtkWorkerPool", pool->self);
+
+  try {
+    Php::call("call_user_func_array", pool->drain_callback, internal_parameters);
+  } catch (Php::Exception &exception) {
+    // Re-throw to let PHP-CPP handle the exception properly
+    throw;
+  }
+}
+
+/**
+ * Fail the queued jobs once the pool is broken, or when no worker is left or coming back
+ */
+static void phpgtk_worker_fail_queue(st_pool_state *pool) {
+  if (!pool->broken) {
+    for (st_worker *worker : pool->workers) {
+      if (worker->fd >= 0 || worker->respawn_source != 0) {
+        return;
+      }
+    }
+  }
+
+  const char *message = pool->broken
+                            ? "GtkWorkerPool: the workers keep exiting, the pool is broken"
+                            : "GtkWorkerPool: no worker left to run the job";
+
+  std::deque<st_worker_job *> queue;
+  queue.swap(pool->queue);
+
+  while (!queue.empty()) {
+    st_worker_job *job = queue.front();
+    queue.pop_front();
+
+    pool->failed++;
+    phpgtk_worker_deliver(pool, job, nullptr, message);
+  }
+}
+
+static void phpgtk_worker_respawn(st_worker *worker, bool failure);
+
+static gboolean phpgtk_worker_respawn_callback(gpointer data) {
+  st_worker *worker = (st_worker *)data;
+  st_pool_state *pool = worker->pool;
+  worker->respawn_source = 0;
+
+  if (pool->shut_down || pool->broken) {
+    return G_SOURCE_REMOVE;
+  }
+
+  // The failed jobs may drop the last PHP reference to the pool, keep it until this returns
+  Php::Value self = Php::Object("GtkWorkerPool", pool->self);
+
+  if (phpgtk_worker_spawn(worker, nullptr)) {
+    pool->respawned++;
+    phpgtk_worker_dispatch(pool);
+    return G_SOURCE_REMOVE;
+  }
+
+  phpgtk_worker_respawn(worker, true);
+  phpgtk_worker_fail_queue(pool);
+  if (!pool->shut_down) {
+    phpgtk_worker_check_drain(pool);
+  }
+
+  return G_SOURCE_REMOVE;
+}
+
+/**
+ * Replace a dead worker. A worker the pool killed comes back at once, an unexpected exit counts
+ * against the respawn budget and waits a delay growing with the recent exits. Past the budget
+ * the pool is broken and nothing is respawned anymore
+ */
+static void phpgtk_worker_respawn(st_worker *worker, bool failure) {
+  st_pool_state *pool = worker->pool;
+  if (pool->broken) {
+    return;
+  }
+
+  if (!failure) {
+    if (phpgtk_worker_spawn(worker, nullptr)) {
+      pool->respawned++;
+      return;
+    }
+  }
+
+  gint64 now = g_get_monotonic_time();
+  pool->failures.push_back(now);
+  while (now - pool->failures.front() > PHPGTK_WORKER_FAILURE_WINDOW) {
+    pool->failures.pop_front();
+  }
+
+  if (pool->failures.size() > PHPGTK_WORKER_MAX_FAILURES) {
+    pool->broken = true;
+    return;
+  }
+
+  guint delay = PHPGTK_WORKER_RESPAWN_DELAY_MS << (pool->failures.size() - 1);
+  if (delay > PHPGTK_WORKER_RESPAWN_MAX_DELAY_MS) {
+    delay = PHPGTK_WORKER_RESPAWN_MAX_DELAY_MS;
+  }
+
+  worker->respawn_source = g_timeout_add(delay, phpgtk_worker_respawn_callback, worker);
+}
+
+static gboolean phpgtk_worker_in_callback(gint fd, GIOCondition condition, gpointer data) {
+  st_worker *worker = (st_worker *)data;
+  st_pool_state *pool = worker->pool;
+
+  // The callbacks may drop the last PHP reference to the pool, keep it until this returns
+  Php::Value self = Php::Object("GtkWorkerPool", pool->self);
+
+  bool hang_up = (condition & (G_IO_HUP | G_IO_ERR | G_IO_NVAL)) != 0;
+
+  if (condition & G_IO_IN) {
+    char buffer[PHPGTK_WORKER_READ_SIZE];
+
+    while (true) {
+      ssize_t n_read = read(fd, buffer, sizeof(buffer));
+      if (n_read < 0 && errno == EINTR) {
+        continue;
+      }
+
+      if (n_read == 0) {
+        hang_up = true;
+        break;
+      }
+
+      if (n_read < 0) {
+        hang_up = hang_up || (errno != EAGAIN && errno != EWOULDBLOCK);
+        break;
+      }
+
+      worker->inbuf.append(buffer, n_read);
+    }
+  }
+
+  // One job per worker, so at most one complete reply
+  std::unique_ptr<st_worker_job> done;
+  char type = PHPGTK_WORKER_FRAME_ERROR;
+  std::string reply;
+  const char *lost_message = "GtkWorkerPool: the worker exited";
+
+  guint32 length = 0;
+  if (worker->inbuf.size() >= PHPGTK_WORKER_HEADER_SIZE) {
+    memcpy(&length, worker->inbuf.data() + 1, sizeof(length));
+
+    if (length > PHPGTK_WORKER_MAX_FRAME_SIZE) {
+      // Not a frame the worker script writes, drop the worker and its job
+      lost_message = "GtkWorkerPool: the worker sent an oversized reply";
+      hang_up = true;
+      worker->killed = true;
+      if (worker->process != nullptr) {
+        g_subprocess_force_exit(worker->process);
+      }
+    } else if (worker->inbuf.size() - PHPGTK_WORKER_HEADER_SIZE >= length) {
+      type = worker->inbuf[0];
+      reply = worker->inbuf.substr(PHPGTK_WORKER_HEADER_SIZE, length);
+      worker->inbuf.erase(0, PHPGTK_WORKER_HEADER_SIZE + length);
+
+      done.reset(worker->job);
+      worker->job = nullptr;
+    }
+  }
+
+  // A dead worker is replaced before PHP runs, so no new job goes to it
+  std::unique_ptr<st_worker_job> lost;
+  if (hang_up) {
+    lost.reset(worker->job);
+    worker->job = nullptr;
+
+    // This source ends with the return below
+    bool failure = !worker->killed;
+    worker->in_source = 0;
+    phpgtk_worker_close(worker);
+    phpgtk_worker_respawn(worker, failure);
+  }
+
+  // Keep the workers busy while PHP handles the results
+  phpgtk_worker_dispatch(pool);
+
+  if (done != nullptr && !done->cancelled) {
+    if (type == PHPGTK_WORKER_FRAME_RESULT) {
+      pool->completed++;
+      // Bounded by PHPGTK_WORKER_MAX_FRAME_SIZE, so the size fits an int
+      Php::Value result = Php::call("unserialize", Php::Value(reply.data(), (int)reply.size()));
+      phpgtk_worker_deliver(pool, done.release(), result, nullptr);
+    } else {
+      pool->failed++;
+      phpgtk_worker_deliver(pool, done.release(), nullptr, reply);
+    }
+  }
+
+  if (lost != nullptr && !lost->cancelled) {
+    pool->failed++;
+    phpgtk_worker_deliver(pool, lost.release(), nullptr, lost_message);
+  }
+
+  // The callbacks may have shut the pool down, which removed this source
+  if (!pool->shut_down) {
+    if (hang_up) {
+      phpgtk_worker_fail_queue(pool);
+    }
+    phpgtk_worker_check_drain(pool);
+  }
+
+  if (hang_up || pool->shut_down) {
+    return G_SOURCE_REMOVE;
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
+/**
+ * Close the sockets, idle workers leave on the end of file and busy ones are terminated
+ */
+static void phpgtk_worker_shutdown(st_pool_state *pool) {
+  pool->shut_down = true;
+
+  for (st_worker *worker : pool->workers) {
+    if (worker->job != nullptr) {
+      if (worker->process != nullptr) {
+        g_subprocess_send_signal(worker->process, SIGTERM);
+      }
+
+      delete worker->job;
+      worker->job = nullptr;
+    }
+
+    phpgtk_worker_close(worker);
+  }
+
+  for (st_worker_job *job : pool->queue) {
+    delete job;
+  }
+  pool->queue.clear();
+}
+
+/**
+ * Constructor
+ */
+GtkWorkerPool_::GtkWorkerPool_() = default;
+
+/**
+ * Destructor
+ */
+GtkWorkerPool_::~GtkWorkerPool_() {
+  if (state == nullptr) {
+    return;
+  }
+
+  phpgtk_worker_shutdown(state);
+
+  for (st_worker *worker : state->workers) {
+    delete worker;
+  }
+
+  delete state;
+}
+
+void GtkWorkerPool_::__construct(Php::Parameters &parameters) {
+  // The handler is looked up again in each worker, so it must be a name and not a closure
+  if (parameters.empty() || !(parameters[0].isString() || parameters[0].isArray())) {
+    throw Php::Exception(
+        "GtkWorkerPool::__construct expects the name of a function or static method as handler");
+  }
+
+  int n_workers = (int)g_get_num_processors();
+  if (parameters.size() > 1 && !parameters[1].isNull()) {
+    n_workers = parameters[1];
+  }
+
+  if (n_workers < 1) {
+    throw Php::Exception("GtkWorkerPool::__construct expects a positive number of workers");
+  }
+
+  std::string php_binary = Php::call("constant", "PHP_BINARY").stringValue();
+  if (php_binary.empty()) {
+    throw Php::Exception("GtkWorkerPool::__construct: PHP_BINARY is unknown, cannot start workers");
+  }
+
+  // Check what can be checked here rather than finding out from workers that exit at startup
+  Php::Value php_handler = parameters[0];
+  if (php_handler.isArray()) {
+    if (php_handler.size() != 2 || !php_handler.get(0).isString() ||
+        !php_handler.get(1).isString()) {
+      throw Php::Exception(
+          "GtkWorkerPool::__construct expects the handler as [class name, method name]");
+    }
+  }
+
+  std::string name;
+  if (php_handler.isArray()) {
+    name = php_handler.get(0).stringValue() + "::" + php_handler.get(1).stringValue();
+  } else {
+    name = php_handler.stringValue();
+  }
+  if (!Php::call("preg_match", PHPGTK_WORKER_HANDLER_PATTERN, name).boolValue()) {
+    throw Php::Exception("GtkWorkerPool::__construct: invalid handler name " + name);
+  }
+
+  std::string bootstrap;
+  if (parameters.size() > 3 && !parameters[3].isNull()) {
+    bootstrap = Php::call("realpath", parameters[3]).stringValue();
+    if (bootstrap.empty() || !Php::call("is_file", bootstrap).boolValue() ||
+        !Php::call("is_readable", bootstrap).boolValue()) {
+      throw Php::Exception("GtkWorkerPool::__construct: cannot read the bootstrap file " +
+                           parameters[3].stringValue());
+    }
+  } else if (!Php::call("is_callable", php_handler).boolValue()) {
+    // Without a bootstrap the workers only know what this process knows before any script runs,
+    // a handler not even callable here cannot be callable there
+    throw Php::Exception("GtkWorkerPool::__construct: the handler " + name +
+                         " is not callable, define it in a bootstrap file");
+  }
+
+  std::string handler = Php::call("serialize", php_handler).stringValue();
+
+  state = new st_pool();
+  state->self = this;
+
+  // Same binary and php.ini as this process, errors go to stderr and not into the frames
+  state->argv.push_back(php_binary);
+  Php::Value ini_file = Php::call("php_ini_loaded_file");
+  if (ini_file.isString()) {
+    state->argv.push_back("-c");
+    state->argv.push_back(ini_file.stringValue());
+  }
+  state->argv.push_back("-d");
+  state->argv.push_back("display_errors=stderr");
+  state->argv.push_back("-r");
+  state->argv.push_back(phpgtk_worker_script);
+  state->argv.push_back("--");
+  state->argv.push_back(bootstrap);
+  state->argv.push_back(handler);
+
+  if (parameters.size() > 2 && !parameters[2].isNull()) {
+    int max_pending = parameters[2];
+    state->max_pending = (max_pending > 0) ? max_pending : 1;
+  }
+
+  for (int i = 0; i < n_workers; i++) {
+    st_worker *worker = new st_worker();
+    worker->pool = state;
+    state->workers.push_back(worker);
+
+    GError *error = nullptr;
+    if (!phpgtk_worker_spawn(worker, &error)) {
+      std::string message = (error != nullptr) ? error->message : "unknown error";
+      if (error != nullptr) {
+        g_error_free(error);
+      }
+      phpgtk_worker_shutdown(state);
+      throw Php::Exception("GtkWorkerPool::__construct: cannot start the workers: " + message);
+    }
+  }
+}
+
+Php::Value GtkWorkerPool_::submit(Php::Parameters &parameters) {
+  if (state == nullptr || state->shut_down) {
+    throw Php::Exception("GtkWorkerPool::submit: the pool is shut down");
+  }
+
+  if (state->broken) {
+    throw Php::Exception("GtkWorkerPool::submit: the workers keep exiting, the pool is broken");
+  }
+
+  if (parameters.size() < 2 || !parameters[1].isCallable()) {
+    throw Php::Exception("GtkWorkerPool::submit expects a payload and a callable");
+  }
+
+  if (state->queue.size() >= state->max_pending) {
+    state->refused = true;
+    return false;
+  }
+
+  // Serialize first, a payload PHP cannot serialize throws before anything is queued
+  std::string payload = Php::call("serialize", parameters[0]).stringValue();
+  if (payload.size() > PHPGTK_WORKER_MAX_FRAME_SIZE) {
+    throw Php::Exception("GtkWorkerPool::submit: the payload is too large");
+  }
+
+  st_worker_job *job = new st_worker_job();
+  job->id = state->next_id++;
+  job->payload.swap(payload);
+  job->callback = parameters[1];
+  for (size_t i = 2; i < parameters.size(); i++) {
+    job->user_parameters.push_back(parameters[i]);
+  }
+
+  state->queue.push_back(job);
+  state->submitted++;
+
+  phpgtk_worker_dispatch(state);
+
+  return (int64_t)job->id;
+}
+
+Php::Value GtkWorkerPool_::cancel(Php::Parameters &parameters) {
+  if (state == nullptr) {
+    return false;
+  }
+
+  gint64 job_id = parameters[0].numericValue();
+  bool kill_worker = parameters.size() > 1 && parameters[1].boolValue();
+
+  for (auto iter = state->queue.begin(); iter != state->queue.end(); ++iter) {
+    if ((*iter)->id == job_id) {
+      delete *iter;
+      state->queue.erase(iter);
+      state->cancelled++;
+
+      phpgtk_worker_check_drain(state);
+      return true;
+    }
+  }
+
+  for (st_worker *worker : state->workers) {
+    if (worker->job == nullptr || worker->job->id != job_id || worker->job->cancelled) {
+      continue;
+    }
+
+    // The reply, or the hang up of the killed worker, releases the job
+    worker->job->cancelled = true;
+    state->cancelled++;
+
+    if (kill_worker && worker->process != nullptr) {
+      worker->killed = true;
+      g_subprocess_force_exit(worker->process);
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+Php::Value GtkWorkerPool_::cancel_all() {
+  if (state == nullptr) {
+    return 0;
+  }
+
+  int n_cancelled = (int)state->queue.size();
+  for (st_worker_job *job : state->queue) {
+    delete job;
+  }
+  state->queue.clear();
+
+  for (st_worker *worker : state->workers) {
+    if (worker->job != nullptr && !worker->job->cancelled) {
+      worker->job->cancelled = true;
+      n_cancelled++;
+    }
+  }
+
+  state->cancelled += n_cancelled;
+  phpgtk_worker_check_drain(state);
+
+  return n_cancelled;
+}
+
+void GtkWorkerPool_::set_drain_callback(Php::Parameters &parameters) {
+  if (state == nullptr) {
+    throw Php::Exception("GtkWorkerPool::set_drain_callback: the pool was not constructed");
+  }
+
+  state->drain_callback = parameters[0];
+}
+
+Php::Value GtkWorkerPool_::get_pending() {
+  if (state == nullptr) {
+    return 0;
+  }
+
+  int pending = (int)state->queue.size();
+  for (st_worker *worker : state->workers) {
+    if (worker->job != nullptr) {
+      pending++;
+    }
+  }
+
+  return pending;
+}
+
+Php::Value GtkWorkerPool_::get_stats() {
+  Php::Array ret_arr;
+  if (state == nullptr) {
+    return ret_arr;
+  }
+
+  int alive = 0;
+  int busy = 0;
+  for (st_worker *worker : state->workers) {
+    alive += (worker->fd >= 0) ? 1 : 0;
+    busy += (worker->job != nullptr) ? 1 : 0;
+  }
+
+  ret_arr["workers"] = alive;
+  ret_arr["busy"] = busy;
+  ret_arr["queued"] = (int)state->queue.size();
+  ret_arr["max_pending"] = (int64_t)state->max_pending;
+  ret_arr["submitted"] = (int64_t)state->submitted;
+  ret_arr["completed"] = (int64_t)state->completed;
+  ret_arr["failed"] = (int64_t)state->failed;
+  ret_arr["cancelled"] = (int64_t)state->cancelled;
+  ret_arr["respawned"] = (int64_t)state->respawned;
+  ret_arr["broken"] = state->broken;
+
+  return ret_arr;
+}
+
+void GtkWorkerPool_::shutdown() {
+  if (state != nullptr) {
+    phpgtk_worker_shutdown(state);
+  }
+}
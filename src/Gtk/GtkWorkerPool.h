@@ -0,0 +1,93 @@
+#ifndef _PHPGTK_GTKWORKERPOOL_H_
+#define _PHPGTK_GTKWORKERPOOL_H_
+
+#include <phpcpp.h>
+#include <gtk/gtk.h>
+
+/**
+ * GtkWorkerPool_
+ *
+ * PHP worker processes running a handler on serialized jobs, so CPU work leaves the GUI process.
+ * Each worker talks over a socketpair watched from the main loop and runs one job at a time.
+ * Results come back as main loop callbacks. Submitting fails once max_pending jobs wait, and the
+ * drain callback tells when there is room again.
+ *
+ * The workers are new processes of PHP_BINARY with the same php.ini, never forks of this one,
+ * which runs GTK and GLib threads. They share nothing with the script: the handler is named, and
+ * defined by the bootstrap file each worker requires first
+ */
+class GtkWorkerPool_ : public Php::Base {
+  /**
+   * Publics
+   */
+ public:
+  /**
+   * Shared with the main loop sources, defined in GtkWorkerPool.cpp
+   */
+  struct st_pool;
+
+  /**
+   * Privates
+   */
+ private:
+  st_pool *state{};
+
+  /**
+   * Publics
+   */
+ public:
+  /**
+   *  C++ constructor and destructor
+   */
+  GtkWorkerPool_();
+  virtual ~GtkWorkerPool_();
+
+  /**
+   * new GtkWorkerPool(string|array $handler [, int $workers = cpus [, int $max_pending = 256
+   *                   [, string $bootstrap]]])
+   *
+   * $handler($payload) runs in the workers, its return value is the result of the job. It is a
+   * function or static method name, resolved in the worker after requiring $bootstrap. Without a
+   * bootstrap it must already be callable here. Payloads and results are limited to 512 MiB.
+   *
+   * A worker that exits unexpectedly is respawned after a delay growing with the recent exits.
+   * More than 5 exits within 10 seconds break the pool: the queued jobs fail, submit() throws
+   * and get_stats() reports 'broken'
+   */
+  void __construct(Php::Parameters &parameters);
+
+  /**
+   * submit(mixed $payload, callable $callback, ...$user_data)
+   *
+   * $callback($pool, int $job_id, mixed $result, ?string $error, ...$user_data) on the main
+   * loop. Returns the job id, or false when max_pending jobs already wait
+   */
+  Php::Value submit(Php::Parameters &parameters);
+
+  /**
+   * cancel(int $job_id [, bool $kill = false])
+   *
+   * The callback of a cancelled job is never called. A running job keeps its worker busy until
+   * it ends, unless $kill, then the worker is killed and replaced
+   */
+  Php::Value cancel(Php::Parameters &parameters);
+  Php::Value cancel_all();
+
+  /**
+   * callback($pool), when the queue is back to half of max_pending after a refused submit
+   */
+  void set_drain_callback(Php::Parameters &parameters);
+
+  /**
+   * Jobs queued or running
+   */
+  Php::Value get_pending();
+  Php::Value get_stats();
+
+  /**
+   * Stop the workers, queued and running jobs are dropped
+   */
+  void shutdown();
+};
+
+#endif
@@ -1,6 +1,9 @@
 
 #include "GtkSourceBuffer.h"
 
+#include <memory>
+#include <string>
+
 /**
  * Constructor
  */
@@ -69,3 +72,345 @@ void GtkSourceBuffer_::change_case(Php::Parameters &parameters) {
   // call gtk function
   gtk_source_buffer_change_case(GTK_SOURCE_BUFFER(instance), case_type, &start, &end);
 }
+
+/**
+ * Key of the per buffer state on the GObject
+ */
+#define PHPGTK_SOURCE_BUFFER_STATE_KEY "phpgtk-source-buffer-state"
+
+/**
+ * Per buffer highlighting and loading state
+ */
+struct GtkSourceBuffer_::st_source_state {
+  // What the user asked for, applied when nothing suppresses it
+  bool highlight_syntax{true};
+  bool highlight_brackets{true};
+  int suppressed{};
+
+  int highlight_budget{500};
+  guint highlight_source{};
+  gint next_line{};
+  Php::Value highlight_self;
+  Php::Value highlight_done;
+
+  GCancellable *load_cancellable{};
+
+  ~st_source_state() {
+    if (highlight_source != 0) {
+      g_source_remove(highlight_source);
+    }
+
+    if (load_cancellable != nullptr) {
+      g_cancellable_cancel(load_cancellable);
+      g_object_unref(load_cancellable);
+    }
+  }
+};
+
+static void phpgtk_source_state_free(gpointer data) {
+  delete (GtkSourceBuffer_::st_source_state *)data;
+}
+
+GtkSourceBuffer_::st_source_state *GtkSourceBuffer_::get_state(GtkSourceBuffer *buffer) {
+  st_source_state *state =
+      (st_source_state *)g_object_get_data(G_OBJECT(buffer), PHPGTK_SOURCE_BUFFER_STATE_KEY);
+
+  if (state == nullptr) {
+    state = new st_source_state();
+    state->highlight_syntax = gtk_source_buffer_get_highlight_syntax(buffer);
+    state->highlight_brackets = gtk_source_buffer_get_highlight_matching_brackets(buffer);
+
+    g_object_set_data_full(G_OBJECT(buffer), PHPGTK_SOURCE_BUFFER_STATE_KEY, state,
+                           phpgtk_source_state_free);
+  }
+
+  return state;
+}
+
+void GtkSourceBuffer_::set_suppressed(GtkSourceBuffer *buffer, int reason, bool suppressed) {
+  st_source_state *state = get_state(buffer);
+
+  if (suppressed) {
+    state->suppressed |= reason;
+  } else {
+    state->suppressed &= ~reason;
+  }
+
+  bool enabled = (state->suppressed == 0);
+  gtk_source_buffer_set_highlight_syntax(buffer, enabled && state->highlight_syntax);
+  gtk_source_buffer_set_highlight_matching_brackets(buffer, enabled && state->highlight_brackets);
+}
+
+void GtkSourceBuffer_::set_highlight_syntax(Php::Parameters &parameters) {
+  get_state(GTK_SOURCE_BUFFER(instance))->highlight_syntax = (bool)parameters[0];
+
+  set_suppressed(GTK_SOURCE_BUFFER(instance), 0, false);
+}
+
+Php::Value GtkSourceBuffer_::get_highlight_syntax() {
+  return get_state(GTK_SOURCE_BUFFER(instance))->highlight_syntax;
+}
+
+void GtkSourceBuffer_::set_highlight_matching_brackets(Php::Parameters &parameters) {
+  get_state(GTK_SOURCE_BUFFER(instance))->highlight_brackets = (bool)parameters[0];
+
+  set_suppressed(GTK_SOURCE_BUFFER(instance), 0, false);
+}
+
+Php::Value GtkSourceBuffer_::get_highlight_matching_brackets() {
+  return get_state(GTK_SOURCE_BUFFER(instance))->highlight_brackets;
+}
+
+Php::Value GtkSourceBuffer_::is_highlight_suppressed() {
+  return get_state(GTK_SOURCE_BUFFER(instance))->suppressed != 0;
+}
+
+/**
+ * Read a GtkTextIter or a character offset
+ */
+static void phpgtk_source_iter(GtkTextBuffer *buffer, const Php::Value &value, GtkTextIter *iter) {
+  if (value.instanceOf("GtkTextIter")) {
+    GtkTextIter_ *phpgtk_iter = (GtkTextIter_ *)value.implementation();
+    *iter = phpgtk_iter->get_instance();
+  } else {
+    gtk_text_buffer_get_iter_at_offset(buffer, iter, (gint)value.numericValue());
+  }
+}
+
+void GtkSourceBuffer_::ensure_highlight(Php::Parameters &parameters) {
+  if (parameters.size() < 2) {
+    throw Php::Exception("GtkSourceBuffer::ensure_highlight expects a start and an end");
+  }
+
+  GtkTextIter start;
+  GtkTextIter end;
+  phpgtk_source_iter(GTK_TEXT_BUFFER(instance), parameters[0], &start);
+  phpgtk_source_iter(GTK_TEXT_BUFFER(instance), parameters[1], &end);
+
+  gtk_source_buffer_ensure_highlight(GTK_SOURCE_BUFFER(instance), &start, &end);
+}
+
+void GtkSourceBuffer_::set_highlight_budget(Php::Parameters &parameters) {
+  int budget = parameters[0];
+  if (budget < 1) {
+    throw Php::Exception("GtkSourceBuffer::set_highlight_budget expects a positive number");
+  }
+
+  get_state(GTK_SOURCE_BUFFER(instance))->highlight_budget = budget;
+}
+
+Php::Value GtkSourceBuffer_::get_highlight_budget() {
+  return get_state(GTK_SOURCE_BUFFER(instance))->highlight_budget;
+}
+
+/**
+ * Highlight the next budget of lines, one slice per main loop iteration
+ */
+static gboolean phpgtk_source_highlight_slice(gpointer data) {
+  GtkSourceBuffer *buffer = GTK_SOURCE_BUFFER(data);
+  GtkSourceBuffer_::st_source_state *state = GtkSourceBuffer_::get_state(buffer);
+
+  gint n_lines = gtk_text_buffer_get_line_count(GTK_TEXT_BUFFER(buffer));
+
+  GtkTextIter start;
+  GtkTextIter end;
+  gtk_text_buffer_get_iter_at_line(GTK_TEXT_BUFFER(buffer), &start, state->next_line);
+  state->next_line += state->highlight_budget;
+  if (state->next_line < n_lines) {
+    gtk_text_buffer_get_iter_at_line(GTK_TEXT_BUFFER(buffer), &end, state->next_line);
+  } else {
+    gtk_text_buffer_get_end_iter(GTK_TEXT_BUFFER(buffer), &end);
+  }
+
+  gtk_source_buffer_ensure_highlight(buffer, &start, &end);
+
+  if (state->next_line < n_lines) {
+    return G_SOURCE_CONTINUE;
+  }
+
+  state->highlight_source = 0;
+
+  Php::Value self = state->highlight_self;
+  Php::Value done = state->highlight_done;
+  state->highlight_self = nullptr;
+  state->highlight_done = nullptr;
+
+  if (done.isCallable()) {
+    Php::Value internal_parameters;
+    internal_parameters[0] = self;
+
+    try {
+      Php::call("call_user_func_array", done, internal_parameters);
+    } catch (Php::Exception &exception) {
+      // Re-throw to let PHP-CPP handle the exception properly
+      throw;
+    }
+  }
+
+  return G_SOURCE_REMOVE;
+}
+
+void GtkSourceBuffer_::highlight_in_background(Php::Parameters &parameters) {
+  st_source_state *state = get_state(GTK_SOURCE_BUFFER(instance));
+
+  stop_background_highlight();
+
+  state->next_line = 0;
+  state->highlight_self = Php::Object("GtkSourceBuffer", this);
+  if (!parameters.empty()) {
+    state->highlight_done = parameters[0];
+  }
+
+  // Below redraw priority, so the visible part keeps painting between slices
+  state->highlight_source = g_idle_add_full(G_PRIORITY_LOW, phpgtk_source_highlight_slice,
+                                            instance, nullptr);
+}
+
+void GtkSourceBuffer_::stop_background_highlight() {
+  st_source_state *state = get_state(GTK_SOURCE_BUFFER(instance));
+
+  if (state->highlight_source != 0) {
+    g_source_remove(state->highlight_source);
+    state->highlight_source = 0;
+  }
+
+  state->highlight_self = nullptr;
+  state->highlight_done = nullptr;
+}
+
+/**
+ * One asynchronous load, owns the loader until it completes
+ */
+struct st_source_load {
+  GtkSourceBuffer *buffer{};
+  GtkSourceFile *file{};
+  GtkSourceFileLoader *loader{};
+  GCancellable *cancellable{};
+
+  Php::Value self;
+  Php::Value progress_callback;
+  Php::Value done_callback;
+
+  int last_percent{-1};
+
+  ~st_source_load() {
+    g_object_unref(loader);
+    g_object_unref(file);
+    g_object_unref(cancellable);
+    g_object_unref(buffer);
+  }
+};
+
+static void phpgtk_source_load_progress(goffset current, goffset total, gpointer data) {
+  st_source_load *load = (st_source_load *)data;
+
+  if (!load->progress_callback.isCallable()) {
+    return;
+  }
+
+  // The loader reports every chunk, PHP only hears about whole percents
+  int percent = (total > 0) ? (int)(current * 100 / total) : 0;
+  if (percent == load->last_percent) {
+    return;
+  }
+  load->last_percent = percent;
+
+  Php::Value internal_parameters;
+  internal_parameters[0] = load->self;
+  internal_parameters[1] = (int64_t)current;
+  internal_parameters[2] = (int64_t)total;
+
+  try {
+    Php::call("call_user_func_array", load->progress_callback, internal_parameters);
+  } catch (Php::Exception &exception) {
+    // Re-throw to let PHP-CPP handle the exception properly
+    throw;
+  }
+}
+
+static void phpgtk_source_load_ready(GObject *source, GAsyncResult *result, gpointer data) {
+  st_source_load *load = (st_source_load *)data;
+  std::unique_ptr<st_source_load> load_guard(load);
+
+  GError *error = nullptr;
+  gboolean success =
+      gtk_source_file_loader_load_finish(GTK_SOURCE_FILE_LOADER(source), result, &error);
+
+  GtkSourceBuffer_::st_source_state *state = GtkSourceBuffer_::get_state(load->buffer);
+  if (state->load_cancellable == load->cancellable) {
+    g_object_unref(state->load_cancellable);
+    state->load_cancellable = nullptr;
+  }
+
+  GtkSourceBuffer_::set_suppressed(load->buffer, GtkSourceBuffer_::SUPPRESS_LOADING, false);
+
+  if (load->done_callback.isCallable()) {
+    Php::Value internal_parameters;
+    internal_parameters[0] = load->self;
+    internal_parameters[1] = (bool)success;
+    internal_parameters[2] = (error != nullptr) ? Php::Value(error->message) : Php::Value(nullptr);
+
+    if (error != nullptr) {
+      g_error_free(error);
+    }
+
+    try {
+      Php::call("call_user_func_array", load->done_callback, internal_parameters);
+    } catch (Php::Exception &exception) {
+      // Re-throw to let PHP-CPP handle the exception properly
+      throw;
+    }
+  } else if (error != nullptr) {
+    g_error_free(error);
+  }
+}
+
+void GtkSourceBuffer_::load_file(Php::Parameters &parameters) {
+  st_source_state *state = get_state(GTK_SOURCE_BUFFER(instance));
+  if (state->load_cancellable != nullptr) {
+    throw Php::Exception("GtkSourceBuffer::load_file: a load is already running");
+  }
+
+  std::string s_path = parameters[0];
+
+  st_source_load *load = new st_source_load();
+  load->buffer = GTK_SOURCE_BUFFER(g_object_ref(instance));
+  load->file = gtk_source_file_new();
+  load->cancellable = g_cancellable_new();
+  load->self = Php::Object("GtkSourceBuffer", this);
+
+  if (parameters.size() > 1) {
+    load->progress_callback = parameters[1];
+  }
+
+  if (parameters.size() > 2) {
+    load->done_callback = parameters[2];
+  }
+
+  GFile *location = g_file_new_for_path(s_path.c_str());
+  gtk_source_file_set_location(load->file, location);
+  g_object_unref(location);
+
+  load->loader = gtk_source_file_loader_new(load->buffer, load->file);
+
+  state->load_cancellable = G_CANCELLABLE(g_object_ref(load->cancellable));
+
+  // Highlighting each inserted chunk is what makes big files crawl, do it once at the end
+  set_suppressed(load->buffer, SUPPRESS_LOADING, true);
+
+  gtk_source_file_loader_load_async(load->loader, G_PRIORITY_DEFAULT, load->cancellable,
+                                    phpgtk_source_load_progress, load, nullptr,
+                                    phpgtk_source_load_ready, load);
+}
+
+void GtkSourceBuffer_::cancel_load() {
+  st_source_state *state = get_state(GTK_SOURCE_BUFFER(instance));
+
+  if (state->load_cancellable != nullptr) {
+    g_cancellable_cancel(state->load_cancellable);
+  }
+}
+
+Php::Value GtkSourceBuffer_::is_loading() {
+  return get_state(GTK_SOURCE_BUFFER(instance))->load_cancellable != nullptr;
+}
@@ -18,6 +18,26 @@ class GtkSourceBuffer_ : public GtkTextBuffer_ {
    * Publics
    */
  public:
+  struct st_source_state;
+
+  /**
+   * Reasons to keep highlighting and bracket matching off whatever the user asked for
+   */
+  enum {
+    SUPPRESS_LOADING = 1 << 0,
+    SUPPRESS_LARGE_FILE = 1 << 1,
+  };
+
+  /**
+   * Per buffer state, owned by the GObject
+   */
+  static st_source_state *get_state(GtkSourceBuffer *buffer);
+
+  /**
+   * Turn one suppress reason on or off, and apply the result to the buffer
+   */
+  static void set_suppressed(GtkSourceBuffer *buffer, int reason, bool suppressed);
+
   /**
    *  C++ constructor and destructor
    */
@@ -31,6 +51,54 @@ class GtkSourceBuffer_ : public GtkTextBuffer_ {
   void change_case(Php::Parameters &parameters);
 
   void set_language(Php::Parameters &parameters);
+
+  /**
+   * The getters return what was asked for, even while a load or a large file keeps it off
+   */
+  void set_highlight_syntax(Php::Parameters &parameters);
+
+  Php::Value get_highlight_syntax();
+
+  void set_highlight_matching_brackets(Php::Parameters &parameters);
+
+  Php::Value get_highlight_matching_brackets();
+
+  /**
+   * True while loading or the large file mode keep highlighting and bracket matching off
+   */
+  Php::Value is_highlight_suppressed();
+
+  /**
+   * ensure_highlight($start, $end), GtkTextIter or character offsets
+   */
+  void ensure_highlight(Php::Parameters &parameters);
+
+  /**
+   * Lines highlighted per idle slice by highlight_in_background()
+   */
+  void set_highlight_budget(Php::Parameters &parameters);
+
+  Php::Value get_highlight_budget();
+
+  /**
+   * highlight_in_background([callable $done]), walk the buffer a budget at a time on idle
+   */
+  void highlight_in_background(Php::Parameters &parameters);
+
+  void stop_background_highlight();
+
+  /**
+   * load_file($path [, callable $progress [, callable $done]])
+   *
+   * Asynchronous GtkSourceFileLoader, highlighting stays off until the load ends.
+   * $progress($buffer, $current, $total) runs at most once per percent,
+   * $done($buffer, $success, $error)
+   */
+  void load_file(Php::Parameters &parameters);
+
+  void cancel_load();
+
+  Php::Value is_loading();
 };
 
 #endif
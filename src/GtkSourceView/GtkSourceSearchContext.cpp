@@ -0,0 +1,231 @@
+
+#include "GtkSourceSearchContext.h"
+
+#include <string>
+
+/**
+ * Constructor
+ */
+GtkSourceSearchContext_::GtkSourceSearchContext_() = default;
+
+/**
+ * Destructor
+ */
+GtkSourceSearchContext_::~GtkSourceSearchContext_() {
+  if (settings != nullptr) {
+    g_object_unref(settings);
+  }
+}
+
+void GtkSourceSearchContext_::__construct(Php::Parameters &parameters) {
+  if (parameters.empty() || !parameters[0].instanceOf("GtkSourceBuffer")) {
+    throw Php::Exception("GtkSourceSearchContext::__construct expects a GtkSourceBuffer");
+  }
+
+  GtkSourceBuffer_ *phpgtk_buffer = (GtkSourceBuffer_ *)parameters[0].implementation();
+  GtkSourceBuffer *buffer = GTK_SOURCE_BUFFER(phpgtk_buffer->get_instance());
+
+  settings = gtk_source_search_settings_new();
+
+  if (parameters.size() > 1) {
+    std::string s_text = parameters[1];
+    gtk_source_search_settings_set_search_text(settings, s_text.c_str());
+  }
+
+  if (parameters.size() > 2) {
+    int flags = parameters[2];
+    gtk_source_search_settings_set_regex_enabled(settings,
+                                                 (flags & GtkTextBuffer_::SEARCH_REGEX) != 0);
+    gtk_source_search_settings_set_case_sensitive(
+        settings, (flags & GtkTextBuffer_::SEARCH_CASE_INSENSITIVE) == 0);
+    gtk_source_search_settings_set_at_word_boundaries(
+        settings, (flags & GtkTextBuffer_::SEARCH_WHOLE_WORD) != 0);
+  }
+
+  instance = (gpointer *)gtk_source_search_context_new(buffer, settings);
+}
+
+void GtkSourceSearchContext_::set_search_text(Php::Parameters &parameters) {
+  std::string s_text = parameters[0];
+
+  gtk_source_search_settings_set_search_text(settings, s_text.c_str());
+}
+
+Php::Value GtkSourceSearchContext_::get_search_text() {
+  const gchar *ret = gtk_source_search_settings_get_search_text(settings);
+  if (ret == nullptr) {
+    return nullptr;
+  }
+
+  return ret;
+}
+
+void GtkSourceSearchContext_::set_case_sensitive(Php::Parameters &parameters) {
+  gboolean case_sensitive = (gboolean)parameters[0];
+
+  gtk_source_search_settings_set_case_sensitive(settings, case_sensitive);
+}
+
+Php::Value GtkSourceSearchContext_::get_case_sensitive() {
+  bool ret = gtk_source_search_settings_get_case_sensitive(settings);
+
+  return ret;
+}
+
+void GtkSourceSearchContext_::set_at_word_boundaries(Php::Parameters &parameters) {
+  gboolean at_word_boundaries = (gboolean)parameters[0];
+
+  gtk_source_search_settings_set_at_word_boundaries(settings, at_word_boundaries);
+}
+
+Php::Value GtkSourceSearchContext_::get_at_word_boundaries() {
+  bool ret = gtk_source_search_settings_get_at_word_boundaries(settings);
+
+  return ret;
+}
+
+void GtkSourceSearchContext_::set_regex_enabled(Php::Parameters &parameters) {
+  gboolean regex_enabled = (gboolean)parameters[0];
+
+  gtk_source_search_settings_set_regex_enabled(settings, regex_enabled);
+}
+
+Php::Value GtkSourceSearchContext_::get_regex_enabled() {
+  bool ret = gtk_source_search_settings_get_regex_enabled(settings);
+
+  return ret;
+}
+
+void GtkSourceSearchContext_::set_wrap_around(Php::Parameters &parameters) {
+  gboolean wrap_around = (gboolean)parameters[0];
+
+  gtk_source_search_settings_set_wrap_around(settings, wrap_around);
+}
+
+Php::Value GtkSourceSearchContext_::get_wrap_around() {
+  bool ret = gtk_source_search_settings_get_wrap_around(settings);
+
+  return ret;
+}
+
+void GtkSourceSearchContext_::set_highlight(Php::Parameters &parameters) {
+  gboolean highlight = (gboolean)parameters[0];
+
+  gtk_source_search_context_set_highlight(GTK_SOURCE_SEARCH_CONTEXT(instance), highlight);
+}
+
+Php::Value GtkSourceSearchContext_::get_highlight() {
+  bool ret = gtk_source_search_context_get_highlight(GTK_SOURCE_SEARCH_CONTEXT(instance));
+
+  return ret;
+}
+
+Php::Value GtkSourceSearchContext_::get_regex_error() {
+  GError *error = gtk_source_search_context_get_regex_error(GTK_SOURCE_SEARCH_CONTEXT(instance));
+  if (error == nullptr) {
+    return nullptr;
+  }
+
+  std::string message = error->message;
+  g_error_free(error);
+
+  return message;
+}
+
+Php::Value GtkSourceSearchContext_::get_occurrences_count() {
+  int ret = gtk_source_search_context_get_occurrences_count(GTK_SOURCE_SEARCH_CONTEXT(instance));
+
+  return ret;
+}
+
+Php::Value GtkSourceSearchContext_::search(Php::Parameters &parameters, bool forward) {
+  if (parameters.empty() || !parameters[0].instanceOf("GtkTextIter")) {
+    throw Php::Exception(forward ? "GtkSourceSearchContext::forward expects a GtkTextIter"
+                                 : "GtkSourceSearchContext::backward expects a GtkTextIter");
+  }
+
+  Php::Value object_iter = parameters[0];
+  GtkTextIter_ *phpgtk_iter = (GtkTextIter_ *)object_iter.implementation();
+  GtkTextIter iter = phpgtk_iter->get_instance();
+
+  GtkTextIter match_start;
+  GtkTextIter match_end;
+  gboolean found;
+  if (forward) {
+    found = gtk_source_search_context_forward2(GTK_SOURCE_SEARCH_CONTEXT(instance), &iter,
+                                               &match_start, &match_end, nullptr);
+  } else {
+    found = gtk_source_search_context_backward2(GTK_SOURCE_SEARCH_CONTEXT(instance), &iter,
+                                                &match_start, &match_end, nullptr);
+  }
+
+  if (!found) {
+    return nullptr;
+  }
+
+  GtkTextIter_ *start_parsed = new GtkTextIter_();
+  start_parsed->set_instance(match_start);
+
+  GtkTextIter_ *end_parsed = new GtkTextIter_();
+  end_parsed->set_instance(match_end);
+
+  Php::Array ret_arr;
+  ret_arr[0] = Php::Object("GtkTextIter", start_parsed);
+  ret_arr[1] = Php::Object("GtkTextIter", end_parsed);
+
+  return ret_arr;
+}
+
+Php::Value GtkSourceSearchContext_::forward(Php::Parameters &parameters) {
+  return search(parameters, true);
+}
+
+Php::Value GtkSourceSearchContext_::backward(Php::Parameters &parameters) {
+  return search(parameters, false);
+}
+
+Php::Value GtkSourceSearchContext_::replace(Php::Parameters &parameters) {
+  if (parameters.size() < 3 || !parameters[0].instanceOf("GtkTextIter") ||
+      !parameters[1].instanceOf("GtkTextIter")) {
+    throw Php::Exception("GtkSourceSearchContext::replace expects a start, an end and the text");
+  }
+
+  Php::Value object_start = parameters[0];
+  GtkTextIter_ *phpgtk_start = (GtkTextIter_ *)object_start.implementation();
+  GtkTextIter start = phpgtk_start->get_instance();
+
+  Php::Value object_end = parameters[1];
+  GtkTextIter_ *phpgtk_end = (GtkTextIter_ *)object_end.implementation();
+  GtkTextIter end = phpgtk_end->get_instance();
+
+  std::string s_replace = parameters[2];
+
+  GError *error = nullptr;
+  gboolean ret = gtk_source_search_context_replace2(GTK_SOURCE_SEARCH_CONTEXT(instance), &start,
+                                                    &end, s_replace.c_str(),
+                                                    (gint)s_replace.size(), &error);
+  if (error != nullptr) {
+    std::string message = error->message;
+    g_error_free(error);
+    throw Php::Exception("GtkSourceSearchContext::replace: " + message);
+  }
+
+  return (bool)ret;
+}
+
+Php::Value GtkSourceSearchContext_::replace_all(Php::Parameters &parameters) {
+  std::string s_replace = parameters[0];
+
+  // GtkSourceView groups every edit in one user action already
+  GError *error = nullptr;
+  guint ret = gtk_source_search_context_replace_all(GTK_SOURCE_SEARCH_CONTEXT(instance),
+                                                    s_replace.c_str(), (gint)s_replace.size(),
+                                                    &error);
+  if (error != nullptr) {
+    std::string message = error->message;
+    g_error_free(error);
+    throw Php::Exception("GtkSourceSearchContext::replace_all: " + message);
+  }
+
+  return (int)ret;
+}
@@ -0,0 +1,89 @@
+
+#ifndef _PHPGTK_GTKSOURCESEARCHCONTEXT_H_
+#define _PHPGTK_GTKSOURCESEARCHCONTEXT_H_
+
+#include <phpcpp.h>
+#include <gtk/gtk.h>
+#include "../G/GObject.h"
+#include "../Gtk/GtkTextIter.h"
+#include "GtkSourceBuffer.h"
+#include <gtksourceview/gtksource.h>
+
+/**
+ * GtkSourceSearchContext
+ *
+ * Built with its own GtkSourceSearchSettings, exposed through the setters below
+ *
+ * https://developer.gnome.org/gtksourceview/3.24/GtkSourceSearchContext.html
+ */
+class GtkSourceSearchContext_ : public GObject_ {
+  /**
+   * Privates
+   */
+ private:
+  GtkSourceSearchSettings *settings{};
+
+  Php::Value search(Php::Parameters &parameters, bool forward);
+
+  /**
+   * Publics
+   */
+ public:
+  /**
+   *  C++ constructor and destructor
+   */
+  GtkSourceSearchContext_();
+  ~GtkSourceSearchContext_();
+
+  /**
+   * __construct(GtkSourceBuffer $buffer [, string $text [, int $flags]]), GtkTextBuffer::SEARCH_*
+   */
+  void __construct(Php::Parameters &parameters);
+
+  void set_search_text(Php::Parameters &parameters);
+
+  Php::Value get_search_text();
+
+  void set_case_sensitive(Php::Parameters &parameters);
+
+  Php::Value get_case_sensitive();
+
+  void set_at_word_boundaries(Php::Parameters &parameters);
+
+  Php::Value get_at_word_boundaries();
+
+  void set_regex_enabled(Php::Parameters &parameters);
+
+  Php::Value get_regex_enabled();
+
+  void set_wrap_around(Php::Parameters &parameters);
+
+  Php::Value get_wrap_around();
+
+  void set_highlight(Php::Parameters &parameters);
+
+  Php::Value get_highlight();
+
+  Php::Value get_regex_error();
+
+  /**
+   * Number of matches, -1 while the buffer is still being scanned
+   */
+  Php::Value get_occurrences_count();
+
+  /**
+   * forward($iter) and backward($iter), [GtkTextIter $start, GtkTextIter $end] or null
+   */
+  Php::Value forward(Php::Parameters &parameters);
+
+  Php::Value backward(Php::Parameters &parameters);
+
+  Php::Value replace(Php::Parameters &parameters);
+
+  /**
+   * replace_all($replacement), one user action, returns the count
+   */
+  Php::Value replace_all(Php::Parameters &parameters);
+};
+
+#endif
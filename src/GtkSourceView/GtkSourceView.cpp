@@ -313,3 +313,150 @@ Php::Value GtkSourceView_::get_background_pattern() {
 
   return ret;
 }
+
+/**
+ * Key of the large file state on the GObject
+ */
+#define PHPGTK_SOURCE_VIEW_LARGE_FILE_KEY "phpgtk-source-view-large-file"
+
+/**
+ * Large file mode of one view, owned by the GObject
+ */
+struct GtkSourceView_::st_large_file {
+  GtkSourceView *view{};
+  GtkTextBuffer *buffer{};
+  gulong changed_handler{};
+  gulong buffer_handler{};
+
+  gint threshold{};
+  bool active{};
+
+  // View settings to give back when the buffer shrinks again
+  bool show_line_marks{};
+  bool highlight_current_line{};
+
+  void detach() {
+    if (buffer == nullptr) {
+      return;
+    }
+
+    g_signal_handler_disconnect(buffer, changed_handler);
+    if (active && GTK_SOURCE_IS_BUFFER(buffer)) {
+      GtkSourceBuffer_::set_suppressed(GTK_SOURCE_BUFFER(buffer),
+                                       GtkSourceBuffer_::SUPPRESS_LARGE_FILE, false);
+    }
+    g_object_unref(buffer);
+
+    buffer = nullptr;
+    changed_handler = 0;
+  }
+};
+
+GtkSourceView_::st_large_file *GtkSourceView_::get_large_file(GtkSourceView *view) {
+  st_large_file *state =
+      (st_large_file *)g_object_get_data(G_OBJECT(view), PHPGTK_SOURCE_VIEW_LARGE_FILE_KEY);
+
+  if (state == nullptr) {
+    state = new st_large_file();
+    state->view = view;
+
+    g_object_set_data_full(G_OBJECT(view), PHPGTK_SOURCE_VIEW_LARGE_FILE_KEY, state,
+                           large_file_destroy_notify);
+    state->buffer_handler = g_signal_connect(view, "notify::buffer",
+                                             G_CALLBACK(large_file_buffer_callback), state);
+  }
+
+  return state;
+}
+
+void GtkSourceView_::large_file_destroy_notify(gpointer user_data) {
+  st_large_file *state = (st_large_file *)user_data;
+
+  state->detach();
+  delete state;
+}
+
+/**
+ * Enter or leave large file mode, the character count is O(1) so this runs on every change
+ */
+void GtkSourceView_::large_file_update(GtkSourceView *view, st_large_file *state) {
+  if (state->buffer == nullptr) {
+    return;
+  }
+
+  gint n_chars = gtk_text_buffer_get_char_count(state->buffer);
+  bool large = state->threshold > 0 && n_chars > state->threshold;
+  if (large == state->active) {
+    return;
+  }
+
+  state->active = large;
+
+  if (large) {
+    state->show_line_marks = gtk_source_view_get_show_line_marks(view);
+    state->highlight_current_line = gtk_source_view_get_highlight_current_line(view);
+    gtk_source_view_set_show_line_marks(view, FALSE);
+    gtk_source_view_set_highlight_current_line(view, FALSE);
+  } else {
+    gtk_source_view_set_show_line_marks(view, state->show_line_marks);
+    gtk_source_view_set_highlight_current_line(view, state->highlight_current_line);
+  }
+
+  if (GTK_SOURCE_IS_BUFFER(state->buffer)) {
+    GtkSourceBuffer_::set_suppressed(GTK_SOURCE_BUFFER(state->buffer),
+                                     GtkSourceBuffer_::SUPPRESS_LARGE_FILE, large);
+  }
+}
+
+void GtkSourceView_::large_file_changed_callback(GtkTextBuffer *buffer, gpointer user_data) {
+  st_large_file *state = (st_large_file *)user_data;
+
+  large_file_update(state->view, state);
+}
+
+/**
+ * Follow the view to its new buffer
+ */
+void GtkSourceView_::large_file_buffer_callback(GObject *object, GParamSpec *pspec,
+                                                gpointer user_data) {
+  st_large_file *state = (st_large_file *)user_data;
+  bool was_active = state->active;
+
+  state->detach();
+  state->active = false;
+
+  if (was_active) {
+    gtk_source_view_set_show_line_marks(state->view, state->show_line_marks);
+    gtk_source_view_set_highlight_current_line(state->view, state->highlight_current_line);
+  }
+
+  if (state->threshold > 0) {
+    GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(state->view));
+    state->buffer = GTK_TEXT_BUFFER(g_object_ref(buffer));
+    state->changed_handler =
+        g_signal_connect(buffer, "changed", G_CALLBACK(large_file_changed_callback), state);
+
+    large_file_update(state->view, state);
+  }
+}
+
+void GtkSourceView_::set_large_file_threshold(Php::Parameters &parameters) {
+  int threshold = parameters[0];
+  if (threshold < 0) {
+    throw Php::Exception("GtkSourceView::set_large_file_threshold expects a positive number");
+  }
+
+  st_large_file *state = get_large_file(GTK_SOURCE_VIEW(instance));
+  state->threshold = threshold;
+
+  // Same path as a buffer swap: restore, reconnect, and evaluate again
+  large_file_buffer_callback(G_OBJECT(instance), nullptr, state);
+}
+
+Php::Value GtkSourceView_::get_large_file_threshold() {
+  return get_large_file(GTK_SOURCE_VIEW(instance))->threshold;
+}
+
+Php::Value GtkSourceView_::is_large_file() {
+  return get_large_file(GTK_SOURCE_VIEW(instance))->active;
+}
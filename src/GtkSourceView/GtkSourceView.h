@@ -16,6 +16,18 @@
  * https://developer.gnome.org/gtk3/stable/GtkSourceView.html
  */
 class GtkSourceView_ : public GtkTextView_ {
+  /**
+   * Privates
+   */
+ private:
+  struct st_large_file;
+
+  static st_large_file *get_large_file(GtkSourceView *view);
+  static void large_file_update(GtkSourceView *view, st_large_file *state);
+  static void large_file_changed_callback(GtkTextBuffer *buffer, gpointer user_data);
+  static void large_file_buffer_callback(GObject *object, GParamSpec *pspec, gpointer user_data);
+  static void large_file_destroy_notify(gpointer user_data);
+
   /**
    * Publics
    */
@@ -99,6 +111,16 @@ class GtkSourceView_ : public GtkTextView_ {
   void set_background_pattern(Php::Parameters &parameters);
 
   Php::Value get_background_pattern();
+
+  /**
+   * Large file mode: above $chars characters the buffer stops highlighting and matching brackets,
+   * and the view hides line marks and the current line highlight. 0 turns the mode off
+   */
+  void set_large_file_threshold(Php::Parameters &parameters);
+
+  Php::Value get_large_file_threshold();
+
+  Php::Value is_large_file();
 };
 
 #endif
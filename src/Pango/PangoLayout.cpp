@@ -8,7 +8,11 @@ PangoLayout_::PangoLayout_() = default;
 /**
  * Destructor
  */
-PangoLayout_::~PangoLayout_() = default;
+PangoLayout_::~PangoLayout_() {
+  if (owns_instance && instance != nullptr) {
+    g_object_unref(instance);
+  }
+}
 
 void PangoLayout_::__construct(Php::Parameters &parameters) {
   Php::Value object_pango_context = parameters[0];
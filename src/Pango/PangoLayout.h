@@ -14,6 +14,11 @@ class PangoLayout_ : public GObject_ {
    * Publics
    */
  public:
+  /**
+   * Set when the wrapper holds its own reference on instance, released by the destructor
+   */
+  bool owns_instance{};
+
   /**
    *  C++ constructor and destructor
    */
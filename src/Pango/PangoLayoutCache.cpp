@@ -0,0 +1,280 @@
+#include "PangoLayoutCache.h"
+#include "../Cairo/CairoContext.h"
+
+/**
+ * Rough memory held by one shaped layout besides its text: glyph strings, lines, attributes
+ */
+#define PHPGTK_LAYOUT_BASE_BYTES 512
+#define PHPGTK_LAYOUT_BYTES_PER_CHAR 48
+
+/**
+ * Constructor
+ */
+PangoLayoutCache_::PangoLayoutCache_() = default;
+
+/**
+ * Destructor
+ */
+PangoLayoutCache_::~PangoLayoutCache_() {
+  clear();
+
+  if (context != nullptr) {
+    g_object_unref(context);
+  }
+}
+
+void PangoLayoutCache_::__construct(Php::Parameters &parameters) {
+  if (parameters.empty() || !parameters[0].instanceOf("PangoContext")) {
+    throw Php::Exception("PangoLayoutCache::__construct expects a PangoContext");
+  }
+
+  PangoContext_ *pango_context = (PangoContext_ *)parameters[0].implementation();
+  context = PANGO_CONTEXT(g_object_ref(pango_context->get_instance()));
+
+  // A context made with new PangoContext() has no font map yet
+  if (pango_context_get_font_map(context) == nullptr) {
+    pango_context_set_font_map(context, pango_cairo_font_map_get_default());
+  }
+
+  context_serial = pango_context_get_serial(context);
+
+  if (parameters.size() > 1) {
+    int entries_limit = parameters[1];
+    max_entries = (entries_limit > 0) ? entries_limit : 1;
+  }
+
+  if (parameters.size() > 2) {
+    int bytes_limit = parameters[2];
+    max_bytes = (bytes_limit > 0) ? bytes_limit : 1;
+  }
+}
+
+/**
+ * Find or shape the layout, and move it to the front of the LRU list
+ */
+PangoLayoutCache_::st_entry &PangoLayoutCache_::lookup(const std::string &text,
+                                                       const std::string &font, int width,
+                                                       int wrap, bool markup) {
+  if (context == nullptr) {
+    throw Php::Exception("PangoLayoutCache: the cache was not constructed");
+  }
+
+  // Font map or resolution changes invalidate every shaped layout
+  guint serial = pango_context_get_serial(context);
+  if (serial != context_serial) {
+    clear();
+    context_serial = serial;
+  }
+
+  std::string key;
+  key.reserve(text.size() + font.size() + 24);
+  key.append(text).append(1, '\0').append(font).append(1, '\0');
+  key.append(std::to_string(width)).append(1, ':').append(std::to_string(wrap));
+  key.append(markup ? "m" : "t");
+
+  auto found = index.find(key);
+  if (found != index.end()) {
+    hits++;
+    entries.splice(entries.begin(), entries, found->second);
+    return entries.front();
+  }
+
+  misses++;
+
+  PangoLayout *layout = pango_layout_new(context);
+
+  if (!font.empty()) {
+    auto font_found = fonts.find(font);
+    if (font_found == fonts.end()) {
+      PangoFontDescription *description = pango_font_description_from_string(font.c_str());
+      font_found = fonts.insert(std::make_pair(font, description)).first;
+    }
+    pango_layout_set_font_description(layout, font_found->second);
+  }
+
+  if (width >= 0) {
+    pango_layout_set_width(layout, width * PANGO_SCALE);
+    pango_layout_set_wrap(layout, (PangoWrapMode)wrap);
+  }
+
+  if (markup) {
+    pango_layout_set_markup(layout, text.c_str(), (int)text.size());
+  } else {
+    pango_layout_set_text(layout, text.c_str(), (int)text.size());
+  }
+
+  st_entry entry;
+  entry.key = key;
+  entry.layout = layout;
+  pango_layout_get_pixel_size(layout, &entry.width, &entry.height);
+  entry.bytes = key.size() * 2 + PHPGTK_LAYOUT_BASE_BYTES +
+                text.size() * PHPGTK_LAYOUT_BYTES_PER_CHAR;
+
+  entries.push_front(entry);
+  index[key] = entries.begin();
+  bytes += entry.bytes;
+
+  evict();
+
+  return entries.front();
+}
+
+/**
+ * Drop the least recently used layouts until both limits hold, keeping the newest one
+ */
+void PangoLayoutCache_::evict() {
+  while (entries.size() > 1 && (entries.size() > max_entries || bytes > max_bytes)) {
+    st_entry &entry = entries.back();
+
+    bytes -= entry.bytes;
+    index.erase(entry.key);
+    g_object_unref(entry.layout);
+
+    entries.pop_back();
+  }
+}
+
+/**
+ * Read the optional measure() arguments starting at offset
+ */
+static void phpgtk_layout_cache_options(Php::Parameters &parameters, size_t offset,
+                                        std::string &font, int &width, int &wrap, bool &markup) {
+  if (parameters.size() > offset && !parameters[offset].isNull()) {
+    font = parameters[offset].stringValue();
+  }
+
+  if (parameters.size() > offset + 1) {
+    width = parameters[offset + 1];
+  }
+
+  if (parameters.size() > offset + 2) {
+    wrap = parameters[offset + 2];
+  }
+
+  if (parameters.size() > offset + 3) {
+    markup = parameters[offset + 3].boolValue();
+  }
+}
+
+Php::Value PangoLayoutCache_::measure(Php::Parameters &parameters) {
+  std::string text = parameters[0];
+  std::string font;
+  int width = -1;
+  int wrap = PANGO_WRAP_WORD;
+  bool markup = false;
+  phpgtk_layout_cache_options(parameters, 1, font, width, wrap, markup);
+
+  st_entry &entry = lookup(text, font, width, wrap, markup);
+
+  Php::Array ret_arr;
+  ret_arr["width"] = entry.width;
+  ret_arr["height"] = entry.height;
+
+  return ret_arr;
+}
+
+Php::Value PangoLayoutCache_::measure_many(Php::Parameters &parameters) {
+  if (parameters.empty() || !parameters[0].isArray()) {
+    throw Php::Exception("PangoLayoutCache::measure_many expects an array of strings");
+  }
+
+  std::string font;
+  int width = -1;
+  int wrap = PANGO_WRAP_WORD;
+  bool markup = false;
+  phpgtk_layout_cache_options(parameters, 1, font, width, wrap, markup);
+
+  Php::Value strings = parameters[0];
+  Php::Array ret_arr;
+
+  for (auto &iter : strings) {
+    st_entry &entry = lookup(iter.second.stringValue(), font, width, wrap, markup);
+
+    Php::Array size;
+    size["width"] = entry.width;
+    size["height"] = entry.height;
+    if (iter.first.isNumeric()) {
+      ret_arr[(int)iter.first.numericValue()] = size;
+    } else {
+      ret_arr[iter.first.stringValue()] = size;
+    }
+  }
+
+  return ret_arr;
+}
+
+Php::Value PangoLayoutCache_::get_layout(Php::Parameters &parameters) {
+  std::string text = parameters[0];
+  std::string font;
+  int width = -1;
+  int wrap = PANGO_WRAP_WORD;
+  bool markup = false;
+  phpgtk_layout_cache_options(parameters, 1, font, width, wrap, markup);
+
+  st_entry &entry = lookup(text, font, width, wrap, markup);
+
+  // The wrapper keeps its own reference, the entry may be evicted while PHP still holds it
+  PangoLayout_ *return_parsed = new PangoLayout_();
+  return_parsed->set_instance((gpointer *)g_object_ref(entry.layout));
+  return_parsed->owns_instance = true;
+
+  return Php::Object("PangoLayout", return_parsed);
+}
+
+void PangoLayoutCache_::render(Php::Parameters &parameters) {
+  if (parameters.size() < 4 || !phpgtk_is_cairo_context(parameters[0])) {
+    throw Php::Exception("PangoLayoutCache::render expects a CairoContext, x, y and the text");
+  }
+
+  cairo_t *cr = phpgtk_get_cairo_context(parameters[0]);
+  if (cr == nullptr) {
+    throw Php::Exception("PangoLayoutCache::render: invalid cairo context (null pointer)");
+  }
+
+  double x = parameters[1];
+  double y = parameters[2];
+  std::string text = parameters[3];
+  std::string font;
+  int width = -1;
+  int wrap = PANGO_WRAP_WORD;
+  bool markup = false;
+  phpgtk_layout_cache_options(parameters, 4, font, width, wrap, markup);
+
+  if (context == nullptr) {
+    throw Php::Exception("PangoLayoutCache: the cache was not constructed");
+  }
+
+  // Shape for the font options and transform of cr, a change bumps the context serial and the
+  // layouts shaped for the previous target are dropped by lookup()
+  pango_cairo_update_context(cr, context);
+
+  st_entry &entry = lookup(text, font, width, wrap, markup);
+
+  cairo_move_to(cr, x, y);
+  pango_cairo_show_layout(cr, entry.layout);
+}
+
+void PangoLayoutCache_::clear() {
+  for (auto &entry : entries) {
+    g_object_unref(entry.layout);
+  }
+
+  entries.clear();
+  index.clear();
+  bytes = 0;
+
+  for (auto &font : fonts) {
+    pango_font_description_free(font.second);
+  }
+  fonts.clear();
+}
+
+Php::Value PangoLayoutCache_::get_stats() {
+  Php::Array ret_arr;
+  ret_arr["entries"] = (int)entries.size();
+  ret_arr["bytes"] = (int64_t)bytes;
+  ret_arr["hits"] = (int64_t)hits;
+  ret_arr["misses"] = (int64_t)misses;
+
+  return ret_arr;
+}
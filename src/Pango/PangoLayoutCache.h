@@ -0,0 +1,99 @@
+#ifndef _PHPGTK_PANGOLAYOUTCACHE_H_
+#define _PHPGTK_PANGOLAYOUTCACHE_H_
+
+#include <phpcpp.h>
+#include <gtk/gtk.h>
+
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#include "PangoContext.h"
+#include "PangoLayout.h"
+
+/**
+ * PangoLayoutCache_
+ *
+ * Shaped layouts kept by (text, font description, width, wrap mode, markup), so identical labels
+ * are measured and drawn without shaping them again. Bounded by entries and by an estimate of
+ * the bytes held, the least recently used layouts are dropped first
+ */
+class PangoLayoutCache_ : public Php::Base {
+  /**
+   * Privates
+   */
+ private:
+  struct st_entry {
+    std::string key;
+    PangoLayout *layout;
+    int width;
+    int height;
+    size_t bytes;
+  };
+
+  PangoContext *context{};
+  guint context_serial{};
+
+  std::list<st_entry> entries;
+  std::unordered_map<std::string, std::list<st_entry>::iterator> index;
+  std::map<std::string, PangoFontDescription *> fonts;
+
+  size_t max_entries{4096};
+  size_t max_bytes{8 * 1024 * 1024};
+  size_t bytes{};
+  long hits{};
+  long misses{};
+
+  st_entry &lookup(const std::string &text, const std::string &font, int width, int wrap,
+                   bool markup);
+  void evict();
+
+  /**
+   * Publics
+   */
+ public:
+  /**
+   *  C++ constructor and destructor
+   */
+  PangoLayoutCache_();
+  virtual ~PangoLayoutCache_();
+
+  /**
+   * new PangoLayoutCache(PangoContext $context [, int $max_entries = 4096 [, int $max_bytes]])
+   */
+  void __construct(Php::Parameters &parameters);
+
+  /**
+   * measure(string $text [, string $font [, int $width = -1 [, int $wrap [, bool $markup]]]])
+   *
+   * Pixel size as ['width', 'height']. $width is in pixels, -1 disables wrapping
+   */
+  Php::Value measure(Php::Parameters &parameters);
+
+  /**
+   * Same as measure() for a whole array of strings, keys are preserved
+   */
+  Php::Value measure_many(Php::Parameters &parameters);
+
+  /**
+   * Cached PangoLayout for the same arguments as measure(), shared: do not modify it
+   */
+  Php::Value get_layout(Php::Parameters &parameters);
+
+  /**
+   * render(CairoContext $cr, float $x, float $y, string $text [, ...measure() arguments])
+   *
+   * The context takes the font options and transform of $cr first. When they differ from the
+   * previous target every cached layout is shaped again, so keep one cache per target
+   */
+  void render(Php::Parameters &parameters);
+
+  /**
+   * Drop the cached layouts and the parsed font descriptions
+   */
+  void clear();
+  Php::Value get_stats();
+};
+
+#endif